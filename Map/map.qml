@@ -5,6 +5,7 @@ import QtPositioning 5.12
 import QtQml 2.12
 import QtQuick.Controls 2.12
 import QtQuick.Layouts 1.12
+import RSPACER.Map 1.0
 
 Item {
     visible: true
@@ -15,34 +16,33 @@ Item {
     property var noiseCircles: []
     property double currentRadius: 1000
     property real currentTime: 6.0
-    property real targetTime: 6.0
     property int timeSpeed: 1
-    property var speedMultipliers: [1, 2, 5, 10, 60, 2400]
-    property var speedLabels: ["x1", "x2", "x5", "x10", "x60", "x2400"]
-    property string configFilePath: "qrc:/radiation.json"
-
-    // Свойство для хранения данных radiation.json
-    property var radiationData: null
-
+    property var speedMultipliers: [1, 2, 5, 10, 60, 2400, 100000]
+    property var speedLabels: ["x1", "x2", "x5", "x10", "x60", "x2400", "x10⁵"]
     // Новые свойства для влияния небесных тел и подсчета дней
     property double celestialInfluence: 1.0
     property double totalInfluence: 1.0
     property date startDate: new Date(2025, 0, 1) // 1 января 2025
     property real daysFromStart: 0
     property real totalDays: 0
-    property int fullDaysPassed: 0
-    property real currentDayProgress: 0.0
     property real totalTimePassed: 0.0 // Общее время в часах с начала
 
     // Свойства для спутников
-    property var satellites: []
+    // Движущиеся спутники живут в satelliteEngine, над городами - в staticSensors.
+    // Рисует всех satelliteLayer
+    property var satelliteNames: [] // для селектора: сначала движущиеся, затем над городами
     property bool showSatellites: true
     property real dayNightFactor: 1.0
     property real satelliteTimeFactor: 1.0
 
     // Свойства для измерений - ТЕПЕРЬ ХРАНИМ ПО СПУТНИКАМ
-    property var measurementsBySatellite: ({}) // Объект: {satelliteName: [measurements]}
-    property var allMeasurements: [] // Все измерения (для статистики)
+    // Полные ряды хранит DataStorage, здесь только последние уведомления
+    // measurementSynth и staticSensors для таблицы "все спутники"
+    property var recentMeasurements: []
+    property int maxRecentMeasurements: 50
+    property var storageStats: ({}) // итоги dataStorage.getStatistics()
+    property int selectedMeasurementCount: 0
+    property bool measurementsDirty: false // пришли уведомления, итоги и таблица обновятся в кадре
     property bool showMeasurementsPanel: false
     property int selectedSatelliteIndex: -1
     property string selectedSatelliteName: ""
@@ -50,47 +50,8 @@ Item {
     // Связь с DataStorage из C++
     property var dataStorage: null
 
-    // Цветовая схема для уровней радиоизлучения
-    property var noiseLevels: [
-        { range: "≥ -60 дБм", color: "#FF0000", description: "Очень высокий", level: -55 },
-        { range: "-60 до -70", color: "#FF4400", description: "Высокий", level: -65 },
-        { range: "-70 до -75", color: "#FF8800", description: "Повышенный", level: -72.5 },
-        { range: "-75 до -80", color: "#FFCC00", description: "Средний", level: -77.5 },
-        { range: "-80 до -85", color: "#FFFF00", description: "Низкий", level: -82.5 },
-        { range: "-85 до -90", color: "#AAFF00", description: "Очень низкий", level: -87.5 },
-        { range: "-90 до -95", color: "#00FF00", description: "Минимальный", level: -92.5 },
-        { range: "< -95 дБм", color: "#00AAFF", description: "Фоновый", level: -100 }
-    ]
-
-    // Таймер для плавного суточного цикла
-    Timer {
-        id: realTimeTimer
-        interval: 1000
-        running: true
-        repeat: true
-        onTriggered: {
-            var minutesToAdd = timeSpeed;
-            targetTime += minutesToAdd / 60;
-
-            // Добавляем к общему времени
-            totalTimePassed += minutesToAdd / 60;
-
-            // Если прошли полные сутки, увеличиваем счетчик дней
-            if (targetTime >= 24) {
-                targetTime -= 24;
-                fullDaysPassed += 1;
-            }
-        }
-    }
-
-    // Таймер для плавной анимации (60 FPS)
-    Timer {
-        id: animationTimer
-        interval: 16
-        running: true
-        repeat: true
-        onTriggered: updateSmoothTransition()
-    }
+    // Цветовая схема для уровней радиоизлучения (полосы палитры зон из C++)
+    property var noiseLevels: zoneAppearance.bands
 
     Plugin {
         id: mapPlugin
@@ -110,6 +71,63 @@ Item {
         activeMapType: supportedMapTypes[0]
         gesture.enabled: true
 
+        // Зоны шума - тайлы, которые рисуются в фоновых потоках (C++)
+        NoiseFieldLayer {
+            id: noiseField
+            anchors.fill: parent
+            center: map.center
+            zoomLevel: map.zoomLevel
+            zones: zoneIndex
+            appearance: zoneAppearance
+        }
+
+        // Следы всех спутников одним узлом scene graph, точки берутся из satelliteEngine
+        TrailLayer {
+            id: trailLayer
+            anchors.fill: parent
+            center: map.center
+            zoomLevel: map.zoomLevel
+            engine: satelliteEngine
+            maxPoints: 500
+            lineWidth: 2
+            color: "black"
+            opacity: 0.8
+        }
+
+        // Импульсы измерений из пула, без создания объектов на каждое измерение
+        IndicatorLayer {
+            id: indicatorLayer
+            anchors.fill: parent
+            center: map.center
+            zoomLevel: map.zoomLevel
+        }
+
+        // Трасса выбранного спутника за виток
+        MapPolyline {
+            id: selectedTrack
+            line.width: 3
+            line.color: "black"
+            opacity: 0.7
+            visible: showSatellites
+        }
+
+        // Все спутники одним элементом: точки, значки и подписи по масштабу,
+        // выбор щелчком через пространственный поиск в C++
+        SatelliteLayer {
+            id: satelliteLayer
+            anchors.fill: parent
+            center: map.center
+            zoomLevel: map.zoomLevel
+            engine: satelliteEngine
+            sensors: staticSensors
+            iconZoom: 4
+            labelZoom: 5
+            maxLabels: 200
+            visible: showSatellites
+
+            onSatelliteClicked: selectSatelliteByName(satellite.name)
+        }
+
         // Круг для отображения радиуса анализа
         MapCircle {
             id: analysisCircle
@@ -153,109 +171,86 @@ Item {
         }
     }
 
-    // Функция для загрузки конфигурации из JSON файла
-    function loadConfigurationFromJson() {
-        console.log("Загрузка конфигурации из файла:", configFilePath);
-
-        var xhr = new XMLHttpRequest();
-        xhr.open("GET", configFilePath);
-        xhr.onreadystatechange = function() {
-            if (xhr.readyState === XMLHttpRequest.DONE) {
-                if (xhr.status === 200) {
-                    try {
-                        var config = JSON.parse(xhr.responseText);
-                        radiationData = config; // Сохраняем данные для спутников
-                        processJsonConfiguration(config);
-                        console.log("JSON успешно загружен из файла");
-
-                        // После загрузки конфигурации можно добавить спутники
-                        if (autoAddSatellitesCheckbox.checked) {
-                            addStaticSatellitesForAllCities();
-                        }
-                    } catch (e) {
-                        console.log("Ошибка парсинга JSON:", e.toString());
-                        loadDemoConfiguration();
-                    }
-                } else {
-                    console.log("Ошибка загрузки файла:", xhr.status, xhr.statusText);
-                    loadDemoConfiguration();
-                }
-            }
-        };
-        xhr.send();
-    }
-
-    // Обработка загруженной JSON конфигурации
-    function processJsonConfiguration(config) {
-        console.log("Обработка JSON конфигурации...");
-
-        // Очищаем старые круги
-        clearNoiseCircles();
+    // Зоны разбирает zoneConfig (C++) до загрузки карты и при правке radiation.json.
+    // noiseCircles повторяет zoneIndex: данные для анализа области и статичных спутников
+    function applyZoneConfiguration() {
+        if (zoneIndex.count === 0) {
+            console.log("Зоны не загружены:", zoneConfig.errorString);
+            loadDemoConfiguration();
+            return;
+        }
 
-        try {
-            if (config && config.circles) {
-                console.log("Загружено зон из конфигурации:", config.circles.length);
+        rebuildNoiseCircles();
+        showConfigInfo();
+    }
 
-                // Создаем круги из конфигурации
-                for (var i = 0; i < config.circles.length; i++) {
-                    var circleConfig = config.circles[i];
-                    if (circleConfig.enabled) {
-                        createNoiseCircleFromConfig(circleConfig);
-                    }
-                }
+    function showConfigInfo() {
+        updateConfigInfo("Файл: " + zoneConfig.source + " | Зон: " + zoneConfig.count + " | Версия: " + zoneConfig.version);
+    }
 
-                console.log("Успешно создано кругов:", noiseCircles.length);
-                updateConfigInfo("Файл: " + configFilePath + " | Зон: " + noiseCircles.length + " | Версия: " + (config.version || "1.0"));
-            } else {
-                console.log("Неверный формат JSON конфигурации");
-                loadDemoConfiguration();
-            }
-        } catch (error) {
-            console.log("Ошибка обработки JSON:", error);
-            loadDemoConfiguration();
+    // Кнопка "Обновить JSON": изменившиеся зоны обновятся через zoneIndex
+    function reloadConfiguration() {
+        if (!zoneConfig.load()) {
+            console.log("Ошибка загрузки конфигурации:", zoneConfig.errorString);
+            updateConfigInfo("Ошибка: " + zoneConfig.errorString);
         }
     }
 
     // Загрузка демо-конфигурации при ошибке
     function loadDemoConfiguration() {
         console.log("Загрузка демо-конфигурации...");
-        clearNoiseCircles();
-
-        // Простая демо-конфигурация
-        var demoCircles = [
-            { lat: 55.7558, lng: 37.6173, radius: 500, level: -60, color: "#FFFF0000", title: "Центр Москвы" },
-            { lat: 55.7558, lng: 37.6173, radius: 1000, level: -70, color: "#CCFF4400", title: "Центральный округ" },
-            { lat: 55.7558, lng: 37.6173, radius: 1500, level: -75, color: "#99FF8800", title: "Пригород" }
-        ];
-
-        for (var i = 0; i < demoCircles.length; i++) {
-            var circle = demoCircles[i];
-            createNoiseCircle(circle.lat, circle.lng, circle.radius, circle.color, circle.level, circle.title);
-        }
+
+        // Простая демо-конфигурация; noiseCircles перестроится по zonesChanged
+        zoneIndex.setZones([
+            { latitude: 55.7558, longitude: 37.6173, radius: 500, baseNoiseLevel: -60, color: "#FFFF0000", title: "Центр Москвы" },
+            { latitude: 55.7558, longitude: 37.6173, radius: 1000, baseNoiseLevel: -70, color: "#CCFF4400", title: "Центральный округ" },
+            { latitude: 55.7558, longitude: 37.6173, radius: 1500, baseNoiseLevel: -75, color: "#99FF8800", title: "Пригород" }
+        ]);
 
         updateConfigInfo("Демо-конфигурация | Зон: " + noiseCircles.length);
     }
 
-    // Создание круга из конфигурации
-    function createNoiseCircleFromConfig(config) {
-        var component = Qt.createComponent("qrc:/Map/Items/NoiseCircle.qml");
-        if (component.status === Component.Ready) {
-            var circle = component.createObject(map);
-            circle.center = QtPositioning.coordinate(config.latitude, config.longitude);
-            circle.radius = config.radius;
-            circle.color = config.color;
-            circle.baseNoiseLevel = config.baseNoiseLevel;
-            circle.noiseLevel = config.baseNoiseLevel;
-            circle.title = config.title;
-            circle.circleId = config.id;
-            noiseCircles.push(circle);
-            map.addMapItem(circle);
-            console.log("Создан круг: " + config.title + " (ID: " + config.id + ")");
-            return circle;
-        } else {
-            console.log("Ошибка создания круга из конфигурации:", component.errorString());
+    function noiseCircleFromZone(zone) {
+        return {
+            center: QtPositioning.coordinate(zone.latitude, zone.longitude),
+            radius: zone.radius,
+            color: zone.color,
+            baseNoiseLevel: zone.baseNoiseLevel,
+            title: zone.title,
+            circleId: zone.id,
+            zoneIndex: zone.index
+        };
+    }
+
+    function rebuildNoiseCircles() {
+        var zones = zoneIndex.zoneList();
+        var circles = [];
+        for (var i = 0; i < zones.length; i++) {
+            circles.push(noiseCircleFromZone(zones[i]));
+        }
+        noiseCircles = circles;
+    }
+
+    Connections {
+        target: zoneIndex
+        onZonesChanged: {
+            rebuildNoiseCircles();
+            if (autoAddSatellitesCheckbox.checked && zoneIndex.count > 0) {
+                addStaticSatellitesForAllCities();
+            }
+        }
+        onZonesUpdated: {
+            var zones = zoneIndex.zoneList();
+            for (var i = 0; i < indices.length; i++) {
+                noiseCircles[indices[i]] = noiseCircleFromZone(zones[indices[i]]);
+            }
         }
-        return null;
+    }
+
+    Connections {
+        target: zoneConfig
+        onZonesReset: showConfigInfo()
+        onInfoChanged: showConfigInfo()
     }
 
     // Обновление информации о конфигурации
@@ -330,7 +325,7 @@ Item {
             }
 
             Text {
-                text: "Спутников: " + satellites.length + " | Измерений: " + allMeasurements.length
+                text: "Спутников: " + (satelliteEngine.count + staticSensors.count) + " | Измерений: " + (storageStats.totalMeasurements || 0)
                 font.pixelSize: 9
                 color: "red"
                 font.bold: true
@@ -433,6 +428,7 @@ Item {
             case 10: return "#FF6600";
             case 60: return "red";
             case 2400: return "#FF00FF";
+            case 100000: return "#8800FF";
             default: return "black";
         }
     }
@@ -443,16 +439,10 @@ Item {
         }
     }
 
-    function updateSmoothTransition() {
-        var diff = targetTime - currentTime;
-        if (diff > 12) diff -= 24;
-        if (diff < -12) diff += 24;
-
-        var smoothFactor = Math.max(0.02, 0.05 / Math.sqrt(timeSpeed));
-        currentTime += diff * smoothFactor;
-
-        if (currentTime >= 24) currentTime -= 24;
-        if (currentTime < 0) currentTime += 24;
+    // Кадр часов модельного времени: время карты только отображает SimulationClock
+    function updateFromClock() {
+        currentTime = simulationClock.hour;
+        totalTimePassed = simulationClock.simulationTime / 3600;
 
         updateDayNightCycle();
     }
@@ -479,14 +469,6 @@ Item {
         }
 
         satelliteTimeFactor = timeFactor;
-
-        // Обновляем все спутники
-        for (var i = 0; i < satellites.length; i++) {
-            var satellite = satellites[i];
-            if (satellite && typeof satellite.setGlobalTime === 'function') {
-                satellite.setGlobalTime(currentTime);
-            }
-        }
     }
 
     function updateDayNightCycle() {
@@ -527,8 +509,6 @@ Item {
         speedText.text = "Скорость: " + speedLabels[getSpeedIndex()] + " (1 сек = " + timeSpeed + " мин)";
         speedText.color = getSpeedColor();
 
-        updateCirclesAppearance();
-
         if (markers.length > 0) {
             var lastMarker = markers[markers.length - 1];
             showAreaAnalysis(lastMarker.coordinate.latitude, lastMarker.coordinate.longitude, currentRadius);
@@ -543,7 +523,6 @@ Item {
 
     function updateTotalInfluence() {
         totalInfluence = dayNightFactor * celestialInfluence;
-        updateCirclesAppearance();
     }
 
     // Функция подсчета дней на основе общего прошедшего времени
@@ -557,116 +536,21 @@ Item {
         totalDays = daysFromStart;
     }
 
-    // Упрощенная функция обновления внешнего вида кругов
-    function updateCirclesAppearance() {
-        var h = currentTime;
-        var baseOpacity;
-
-        if (h >= 6 && h < 20) {
-            // Днем более непрозрачные
-            baseOpacity = 0.6;
-        } else {
-            // Ночью более прозрачные
-            baseOpacity = 0.3;
-        }
-
-        for (var i = 0; i < noiseCircles.length; i++) {
-            var circle = noiseCircles[i];
-            if (circle) {
-                // Внутренние круги более непрозрачные
-                var circleOpacity = baseOpacity * (1 - i / noiseCircles.length * 0.6);
-                circle.opacity = Math.max(0.1, Math.min(0.8, circleOpacity));
-
-                // Обновляем уровень шума с учетом общего влияния
-                circle.noiseLevel = circle.baseNoiseLevel * totalInfluence;
-            }
-        }
-    }
-
-    function clearNoiseCircles() {
-        for (var i = 0; i < noiseCircles.length; i++) {
-            map.removeMapItem(noiseCircles[i]);
-            noiseCircles[i].destroy();
-        }
-        noiseCircles = [];
-    }
-
-    function createNoiseCircle(lat, lng, radius, color, baseNoiseLevel, title) {
-        var component = Qt.createComponent("NoiseCircle.qml");
-        if (component.status === Component.Ready) {
-            var circle = component.createObject(map);
-            circle.center = QtPositioning.coordinate(lat, lng);
-            circle.radius = radius;
-            circle.color = color;
-            circle.baseNoiseLevel = baseNoiseLevel;
-            circle.noiseLevel = baseNoiseLevel;
-            circle.title = title;
-            noiseCircles.push(circle);
-            map.addMapItem(circle);
-            return circle;
-        }
-        return null;
-    }
-
-    function calculateAverageNoise(centerLat, centerLng, radius) {
-        var centerCoord = QtPositioning.coordinate(centerLat, centerLng);
-        var totalWeightedNoise = 0;
-        var totalArea = 0;
-
-        for (var i = 0; i < noiseCircles.length; i++) {
-            var circle = noiseCircles[i];
-            if (!circle) continue;
-
-            var distance = centerCoord.distanceTo(circle.center);
-            var circleRadius = circle.radius;
-
-            if (distance + radius <= circleRadius) {
-                var area = Math.PI * radius * radius;
-                totalWeightedNoise += circle.noiseLevel * area;
-                totalArea += area;
-            }
-            else if (distance < circleRadius + radius) {
-                var intersectionArea = calculateCircleIntersectionArea(radius, circleRadius, distance);
-                totalWeightedNoise += circle.noiseLevel * intersectionArea;
-                totalArea += intersectionArea;
-            }
-        }
-
-        if (totalArea > 0) {
-            var average = totalWeightedNoise / totalArea;
-            var avgDescription = getNoiseLevelDescription(average);
-            console.log("Средний шум: " + average.toFixed(1) + " дБм (" + avgDescription + ")");
-            return average;
-        } else {
-            return -100 * totalInfluence;
-        }
-    }
-
-    function calculateCircleIntersectionArea(r1, r2, d) {
-        if (d >= r1 + r2) return 0;
-        if (d <= Math.abs(r1 - r2)) {
-            var minR = Math.min(r1, r2);
-            return Math.PI * minR * minR;
-        }
-
-        var part1 = r1 * r1 * Math.acos((d * d + r1 * r1 - r2 * r2) / (2 * d * r1));
-        var part2 = r2 * r2 * Math.acos((d * d + r2 * r2 - r1 * r1) / (2 * d * r2));
-        var part3 = 0.5 * Math.sqrt((-d + r1 + r2) * (d + r1 - r2) * (d - r1 + r2) * (d + r1 + r2));
-
-        return part1 + part2 - part3;
-    }
-
     function showAreaAnalysis(lat, lng, radius) {
         currentRadius = radius;
         analysisCircle.center = QtPositioning.coordinate(lat, lng);
         analysisCircle.radius = radius;
         analysisCircle.visible = true;
 
-        var averageNoise = calculateAverageNoise(lat, lng, radius);
+        // Средний шум, взвешенный по площади пересечения с зонами, и число
+        // задетых зон (C++). Вызывается на каждом шаге ползунка радиуса
+        var analysis = areaAnalyzer.analyzeCircle(lat, lng, radius);
+        var averageNoise = analysis.average;
         averageTextItem.coordinate = QtPositioning.coordinate(lat, lng);
 
         var avgDescription = getNoiseLevelDescription(averageNoise);
-        averageTextItem.sourceItem.children[0].text = "Среднее: " + averageNoise.toFixed(1) + " дБм\n(" + avgDescription + ")";
+        averageTextItem.sourceItem.children[0].text = "Среднее: " + averageNoise.toFixed(1) + " дБм\n(" + avgDescription + ")"
+                + "\nЗон: " + analysis.zoneCount;
         averageTextItem.visible = true;
     }
 
@@ -798,74 +682,84 @@ Item {
         };
     }
 
-    // Функции для управления спутниками
-    function addSatellite(trajectory, altitude, speed, name, color) {
-        var component = Qt.createComponent("qrc:/Map/Items/Satellite.qml");
-        if (component.status === Component.Ready) {
-            var satellite = component.createObject(map);
-            satellite.setTrajectory(trajectory);
-            if (altitude) satellite.setAltitude(altitude);
-            if (speed) satellite.speed = speed;
-            if (name) satellite.satelliteName = name;
-            if (color) satellite.satelliteColor = color;
-
-            // Устанавливаем ссылку на карту
-            satellite.mapReference = this;
-
-            // Устанавливаем начальное время
-            satellite.setGlobalTime(currentTime);
-
-            // Подключаем сигнал измерения
-            satellite.measurementTaken.connect(function(measurement) {
-                // Добавляем имя спутника в измерение
-                measurement.satelliteName = name;
-                addMeasurement(measurement, name);
-            });
+    // Ускорение задается кнопками скорости: x1 = 1 минута модельного времени в секунду
+    Binding { target: simulationClock; property: "timeScale"; value: timeSpeed * 60 }
+    Binding { target: areaAnalyzer; property: "influence"; value: totalInfluence }
+    // Днем зоны плотнее, ночью прозрачнее. Слой перерисовывает только зоны,
+    // вид которых изменился, одной пачкой за кадр
+    Binding { target: zoneAppearance; property: "baseOpacity"; value: (currentTime >= 6 && currentTime < 20) ? 0.6 : 0.3 }
 
-            satellite.visible = showSatellites;
-            satellites.push(satellite);
-            map.addMapItem(satellite);
+    Connections {
+        target: simulationClock
+        onFrameAdvanced: {
+            updateFromClock();
+            refreshMeasurementsFrame();
+        }
+    }
 
-            // Инициализируем хранилище для измерений этого спутника
-            if (!measurementsBySatellite[name]) {
-                measurementsBySatellite[name] = [];
-            }
+    // Модельное время в CelestialModel пишет MainWindow по кадрам часов
+    Connections {
+        target: celestialModel
+        onInfluenceChanged: setCelestialInfluence(celestialModel.totalInfluence)
+    }
 
-            // Обновляем селектор спутников
-            updateSatelliteSelector();
+    // Готовые измерения движущихся спутников - только для отображения,
+    // в DataStorage они уже записаны
+    Connections {
+        target: measurementSynth
+        onMeasurementsTaken: addSynthesizedMeasurements(batch, true)
+    }
 
-            console.log("Добавлен спутник:", name, "высота:", altitude, "км");
-            return satellite;
-        } else {
-            console.log("Ошибка создания спутника:", component.errorString());
-        }
-        return null;
+    // Спутники над городами: измерения для таблицы. Цвет зоны по последнему
+    // измерению staticSensors передает в zoneAppearance сам
+    Connections {
+        target: staticSensors
+        onMeasurementsTaken: addSynthesizedMeasurements(batch, false)
+    }
+
+    // Функции для управления спутниками
+    // orbit - описание орбиты (polarOrbit, inclinedOrbit, geostationaryOrbit, molniyaOrbit).
+    // Движение, измерения и отрисовка - в C++ (satelliteEngine, measurementSynth, satelliteLayer)
+    function addSatellite(orbit, name, color) {
+        var index = satelliteEngine.addSatellite(name, orbit, color || "red");
+
+        // Обновляем селектор спутников
+        updateSatelliteSelector();
+
+        console.log("Добавлен спутник:", name, "орбита:", orbit.type);
+        return index;
+    }
+
+    // Группировка из count спутников одним добавлением в движок
+    function addConstellation(count) {
+        var prefix = "Группировка-" + (satelliteEngine.count + 1);
+        satelliteEngine.addConstellation(prefix, {
+            count: count,
+            planes: 24,
+            phasing: 1,
+            altitude: 550,
+            inclination: 53
+        }, "#1E90FF");
+        updateSatelliteSelector();
     }
 
     function clearSatellites() {
-        for (var i = 0; i < satellites.length; i++) {
-            map.removeMapItem(satellites[i]);
-            satellites[i].destroy();
-        }
-        satellites = [];
-        measurementsBySatellite = {};
-        allMeasurements = [];
+        staticSensors.clear();
+        selectedTrack.path = [];
+        satelliteEngine.clear();
+        recentMeasurements = [];
 
         // Очищаем данные в C++ хранилище
         if (dataStorage) {
             dataStorage.clearAllData();
         }
+        refreshStorageStats();
 
         console.log("Все спутники очищены");
     }
 
     function setSatellitesVisible(visible) {
         showSatellites = visible;
-        for (var i = 0; i < satellites.length; i++) {
-            if (satellites[i]) {
-                satellites[i].visible = visible;
-            }
-        }
     }
 
     function toggleSatellitesVisibility() {
@@ -873,84 +767,23 @@ Item {
         return showSatellites;
     }
 
-    // Генерация полярной орбиты (проходит через полюса)
-    function generatePolarOrbit(centerLng, inclination, altitude, points) {
-        var trajectory = [];
-
-        for (var i = 0; i < points; i++) {
-            var angle = (i / points) * 2 * Math.PI;
-
-            // Полярная орбита - от 90° до -90° широты
-            var lat = 90 * Math.cos(angle); // От +90 до -90
-            var lng = centerLng + 180 * Math.sin(angle) * Math.sin(inclination);
-
-            // Нормализация долготы
-            while (lng > 180) lng -= 360;
-            while (lng < -180) lng += 360;
-
-            trajectory.push(QtPositioning.coordinate(lat, lng));
-        }
-
-        return trajectory;
+    // Описания орбит для satelliteEngine. Положение на орбите считается
+    // аналитически в C++ (orbit_propagator), углы здесь в градусах
+    function polarOrbit(raan, altitude) {
+        return { type: "polar", altitude: altitude, raan: raan, meanAnomaly: Math.random() * 360 };
     }
 
-    // Генерация наклонной орбиты
-    function generateInclinedOrbit(inclination, startLng, altitude, points) {
-        var trajectory = [];
-
-        for (var i = 0; i < points; i++) {
-            var angle = (i / points) * 2 * Math.PI;
-
-            var lat = Math.asin(Math.sin(angle) * Math.sin(inclination)) * (180 / Math.PI);
-            var lng = startLng + Math.atan2(Math.tan(angle), Math.cos(inclination)) * (180 / Math.PI);
-
-            // Нормализация долготы
-            while (lng > 180) lng -= 360;
-            while (lng < -180) lng += 360;
-
-            trajectory.push(QtPositioning.coordinate(lat, lng));
-        }
-
-        return trajectory;
+    function inclinedOrbit(inclination, raan, altitude) {
+        return { type: "inclined", altitude: altitude, inclination: inclination,
+                 raan: raan, meanAnomaly: Math.random() * 360 };
     }
 
-    // Генерация экваториальной орбиты
-    function generateEquatorialOrbit(startLat, altitude, points) {
-        var trajectory = [];
-
-        for (var i = 0; i < points; i++) {
-            var angle = (i / points) * 2 * Math.PI;
-
-            var lat = startLat;
-            var lng = (angle * (180 / Math.PI)) % 360 - 180;
-
-            trajectory.push(QtPositioning.coordinate(lat, lng));
-        }
-
-        return trajectory;
+    function geostationaryOrbit(longitude, inclination) {
+        return { type: "geostationary", longitude: longitude, inclination: inclination };
     }
 
-    // Генерация орбиты Молния (высокоэллиптическая)
-    function generateMolniyaOrbit(inclination, startLng, points) {
-        var trajectory = [];
-        var eccentricity = 0.74; // Высокий эксцентриситет
-
-        for (var i = 0; i < points; i++) {
-            var angle = (i / points) * 2 * Math.PI;
-
-            // Эллиптическая орбита
-            var trueAnomaly = angle;
-            var lat = Math.asin(Math.sin(trueAnomaly) * Math.sin(inclination)) * (180 / Math.PI);
-            var lng = startLng + Math.atan2(Math.tan(trueAnomaly), Math.cos(inclination)) * (180 / Math.PI);
-
-            // Нормализация
-            while (lng > 180) lng -= 360;
-            while (lng < -180) lng += 360;
-
-            trajectory.push(QtPositioning.coordinate(lat, lng));
-        }
-
-        return trajectory;
+    function molniyaOrbit(inclination, raan) {
+        return { type: "molniya", inclination: inclination, raan: raan, meanAnomaly: Math.random() * 360 };
     }
 
     function addRandomSatellite() {
@@ -960,52 +793,36 @@ Item {
         var names = ["Спутник-1", "Метеор-М", "Ресурс-П", "Электро-Л", "Арктика-М", "Глонасс", "Канопус-В"];
         var colors = ["red", "blue", "green", "purple", "orange", "cyan", "magenta"];
 
-        var trajectory;
+        var orbit;
         var altitude;
-        var name = "Случайный-" + (satellites.length + 1);
+        var name = "Случайный-" + (satelliteEngine.count + 1);
         var color = colors[Math.floor(Math.random() * colors.length)];
 
         switch(orbitType) {
             case "polar":
-                trajectory = generatePolarOrbit(
-                    Math.random() * 360 - 180, // случайная долгота
-                    Math.PI / 2, // строго полярная
-                    800 + Math.random() * 1000, // 800-1800 км
-                    200
-                );
-                altitude = 800 + Math.random() * 1000;
+                altitude = 800 + Math.random() * 1000; // 800-1800 км
+                orbit = polarOrbit(Math.random() * 360 - 180, altitude);
                 break;
 
             case "inclined":
-                trajectory = generateInclinedOrbit(
-                    Math.PI / 4 + Math.random() * Math.PI / 4, // наклон 45-90°
-                    Math.random() * 360 - 180,
-                    1500 + Math.random() * 10000,
-                    150
-                );
                 altitude = 1500 + Math.random() * 10000;
+                orbit = inclinedOrbit(45 + Math.random() * 45, // наклон 45-90°
+                                      Math.random() * 360 - 180, altitude);
                 break;
 
             case "equatorial":
-                trajectory = generateEquatorialOrbit(
-                    Math.random() * 30 - 15, // около экватора
-                    35786, // геостационарная высота
-                    100
-                );
-                altitude = 35786;
+                altitude = 35786; // геостационарная высота
+                orbit = geostationaryOrbit(Math.random() * 360 - 180,
+                                           Math.random() * 15); // небольшой наклон - "восьмерка"
                 break;
 
             case "molniya":
-                trajectory = generateMolniyaOrbit(
-                    Math.PI / 3, // наклон 60°
-                    Math.random() * 360 - 180,
-                    120
-                );
-                altitude = 40000; // высокая эллиптическая
+                altitude = 40000; // высокая эллиптическая, апогей
+                orbit = molniyaOrbit(63.4, Math.random() * 360 - 180);
                 break;
         }
 
-        addSatellite(trajectory, altitude, 1.0, name, color);
+        addSatellite(orbit, name, color);
     }
 
     // Инициализация демо-спутников при загрузке
@@ -1014,7 +831,7 @@ Item {
         clearSatellites();
 
         // Добавляем статичные спутники
-        if (autoAddSatellitesCheckbox.checked && radiationData) {
+        if (autoAddSatellitesCheckbox.checked && zoneIndex.count > 0) {
             addStaticSatellitesForAllCities();
         } else {
             // Старый код для демо
@@ -1031,42 +848,23 @@ Item {
         var names = ["Полярный-1", "Метеор", "NOAA", "METOP"];
         var colors = ["blue", "cyan", "lightblue", "darkblue"];
 
-        var trajectory = generatePolarOrbit(
-            Math.random() * 360 - 180,
-            Math.PI / 2,
-            700 + Math.random() * 800,
-            200
-        );
+        var altitude = 700 + Math.random() * 800;
+        var orbit = polarOrbit(Math.random() * 360 - 180, altitude);
 
-        var name = names[Math.floor(Math.random() * names.length)] + "-" + (satellites.length + 1);
-        addSatellite(
-            trajectory,
-            700 + Math.random() * 800,
-            1.0,
-            name,
-            colors[Math.floor(Math.random() * colors.length)]
-        );
+        var name = names[Math.floor(Math.random() * names.length)] + "-" + (satelliteEngine.count + 1);
+        addSatellite(orbit, name, colors[Math.floor(Math.random() * colors.length)]);
     }
 
     function addInclinedSatellite() {
         var names = ["Наклонный-1", "Глонасс", "GPS", "Галилео"];
         var colors = ["purple", "magenta", "darkviolet", "indigo"];
 
-        var trajectory = generateInclinedOrbit(
-            Math.PI/6 + Math.random() * Math.PI/3, // 30-90°
-            Math.random() * 360 - 180,
-            1000 + Math.random() * 30000,
-            150
-        );
+        var altitude = 1000 + Math.random() * 30000;
+        var orbit = inclinedOrbit(30 + Math.random() * 60, // 30-90°
+                                  Math.random() * 360 - 180, altitude);
 
-        var name = names[Math.floor(Math.random() * names.length)] + "-" + (satellites.length + 1);
-        addSatellite(
-            trajectory,
-            1000 + Math.random() * 30000,
-            0.7 + Math.random() * 0.6,
-            name,
-            colors[Math.floor(Math.random() * colors.length)]
-        );
+        var name = names[Math.floor(Math.random() * names.length)] + "-" + (satelliteEngine.count + 1);
+        addSatellite(orbit, name, colors[Math.floor(Math.random() * colors.length)]);
     }
 
     // Панель управления спутниками
@@ -1159,7 +957,7 @@ Item {
             Row {
                 spacing: 4
                 Rectangle {
-                    width: 100
+                    width: 80
                     height: 28
                     color: "#ADD8E6"
                     radius: 4
@@ -1178,7 +976,7 @@ Item {
                 }
 
                 Rectangle {
-                    width: 100
+                    width: 80
                     height: 28
                     color: "#D8BFD8"
                     radius: 4
@@ -1195,6 +993,26 @@ Item {
                         onClicked: addInclinedSatellite()
                     }
                 }
+
+                Rectangle {
+                    width: 80
+                    height: 28
+                    color: "#1E90FF"
+                    radius: 4
+
+                    Text {
+                        anchors.centerIn: parent
+                        text: "Группировка"
+                        font.pixelSize: 9
+                        font.bold: true
+                        color: "white"
+                    }
+
+                    MouseArea {
+                        anchors.fill: parent
+                        onClicked: addConstellation(1000)
+                    }
+                }
             }
 
             Row {
@@ -1306,7 +1124,7 @@ Item {
 
                         Text {
                             anchors.centerIn: parent
-                            text: "x" + modelData
+                            text: speedLabels[index]
                             font.pixelSize: 11
                             font.bold: true
                             color: timeSpeed === modelData ? "white" : "black"
@@ -1326,19 +1144,19 @@ Item {
                 Rectangle {
                     width: 90
                     height: 28
-                    color: realTimeTimer.running ? "lightgreen" : "lightgray"
+                    color: simulationClock.running ? "lightgreen" : "lightgray"
                     radius: 4
 
                     Text {
                         anchors.centerIn: parent
-                        text: realTimeTimer.running ? "Пауза" : "Старт"
+                        text: simulationClock.running ? "Пауза" : "Старт"
                         font.pixelSize: 11
                         font.bold: true
                     }
 
                     MouseArea {
                         anchors.fill: parent
-                        onClicked: realTimeTimer.running = !realTimeTimer.running
+                        onClicked: simulationClock.running = !simulationClock.running
                     }
                 }
 
@@ -1357,7 +1175,7 @@ Item {
 
                     MouseArea {
                         anchors.fill: parent
-                        onClicked: targetTime = (targetTime + 1) % 24
+                        onClicked: simulationClock.advance(3600)
                     }
                 }
 
@@ -1376,7 +1194,7 @@ Item {
 
                     MouseArea {
                         anchors.fill: parent
-                        onClicked: loadConfigurationFromJson()
+                        onClicked: reloadConfiguration()
                     }
                 }
             }
@@ -1476,22 +1294,20 @@ Item {
                 ComboBox {
                     id: satelliteSelector
                     Layout.fillWidth: true
-                    model: satellites.map(function(sat) {
-                        return sat ? sat.satelliteName : "";
-                    }).filter(function(name) { return name; })
+                    model: satelliteNames
                     onCurrentIndexChanged: {
                         selectedSatelliteIndex = currentIndex;
-                        if (currentIndex >= 0 && currentIndex < satellites.length) {
-                            selectedSatelliteName = satellites[currentIndex].satelliteName;
+                        if (currentIndex >= 0 && currentIndex < satelliteNames.length) {
+                            selectedSatelliteName = satelliteNames[currentIndex];
                         }
+                        updateSelectedTrack();
+                        refreshStorageStats();
                         updateMeasurementsView();
                     }
                 }
 
                 Text {
-                    text: "Измерений: " + (selectedSatelliteName ?
-                        (measurementsBySatellite[selectedSatelliteName] ?
-                         measurementsBySatellite[selectedSatelliteName].length : 0) : 0)
+                    text: "Измерений: " + selectedMeasurementCount
                     font.pixelSize: 10
                     color: "darkblue"
                 }
@@ -1681,7 +1497,7 @@ Item {
 
                 Text {
                     Layout.fillWidth: true
-                    text: "Всего: " + allMeasurements.length + " измерений"
+                    text: "Всего: " + (storageStats.totalMeasurements || 0) + " измерений"
                     font.pixelSize: 12
                     color: "darkblue"
                     horizontalAlignment: Text.AlignRight
@@ -1709,7 +1525,7 @@ Item {
                     }
 
                     Text {
-                        text: "🛰️ Спутников: " + satellites.length
+                        text: "🛰️ Спутников: " + (satelliteEngine.count + staticSensors.count)
                         font.pixelSize: 11
                         color: "darkred"
                     }
@@ -1768,121 +1584,91 @@ Item {
             case 10: return "#FF6600";
             case 60: return "red";
             case 2400: return "#FF00FF";
+            case 100000: return "#8800FF";
             default: return "lightblue";
         }
     }
 
-    // Функция для добавления измерения в таблицу
-    function addMeasurement(measurement, satelliteName) {
-        if (!satelliteName) {
-            satelliteName = measurement.satelliteName || "Неизвестный спутник";
+    // Пакет уведомлений measurementSynth или staticSensors (не больше
+    // kMaxNoticesPerFrame за кадр, в DataStorage измерения уже записаны):
+    // таблица и, если pulse, индикация на карте
+    function addSynthesizedMeasurements(batch, pulse) {
+        if (pulse) {
+            indicatorLayer.pulseBatch(batch);
         }
 
-        // 1. Получаем время из симуляции
-        var simTime = currentTime; // например, 6.5 для 6:30
-        var hours = Math.floor(simTime);
-        var minutes = Math.round((simTime % 1) * 60);
-
-        // 2. Используем начало симуляции + прошедшие дни
-        var simDate = new Date(startDate);
-        simDate.setDate(simDate.getDate() + Math.floor(daysFromStart));
-        simDate.setHours(hours);
-        simDate.setMinutes(minutes);
-        simDate.setSeconds(0);
-
-        // 3. Форматируем для отображения в QML
-        var timeStrForDisplay = hours.toString().padStart(2, '0') + ":" +
-                               minutes.toString().padStart(2, '0');
-
-        // 4. Форматируем для C++ (ISO формат)
-        var year = simDate.getFullYear();
-        var month = (simDate.getMonth() + 1).toString().padStart(2, '0');
-        var day = simDate.getDate().toString().padStart(2, '0');
-        var timeStrForCpp = year + "-" + month + "-" + day + "T" +
-                           hours.toString().padStart(2, '0') + ":" +
-                           minutes.toString().padStart(2, '0') + ":00";
-
-        // Сохраняем в QML для отображения
-        var measurementData = {
-            satellite: satelliteName,
-            city: measurement.cityName,
-            lat: measurement.latitude,
-            lng: measurement.longitude,
-            noiseLevel: measurement.noiseLevel,
-            time: timeStrForDisplay, // Только часы:минуты для отображения
-            dateTime: timeStrForCpp, // Полная дата для C++
-            distance: measurement.distanceToCity || 0,
-            altitude: measurement.altitude || 0,
-            influence: measurement.influenceFactor || 1.0
-        };
-
-        // Добавляем в глобальный список
-        allMeasurements.push(measurementData);
+        for (var i = 0; i < batch.length; i++) {
+            var item = batch[i];
+            recentMeasurements.push({
+                satellite: item.satelliteName,
+                city: item.cityName,
+                lat: item.latitude,
+                lng: item.longitude,
+                noiseLevel: item.noiseLevel,
+                time: Qt.formatTime(new Date(item.time), "hh:mm"), // время самого измерения
+                distance: item.distance,
+                altitude: item.altitude,
+                influence: item.influence
+            });
+        }
 
-        // Инициализируем массив для спутника, если его нет
-        if (!measurementsBySatellite[satelliteName]) {
-            measurementsBySatellite[satelliteName] = [];
+        // Кольцо последних уведомлений для таблицы
+        if (recentMeasurements.length > maxRecentMeasurements) {
+            recentMeasurements.splice(0, recentMeasurements.length - maxRecentMeasurements);
         }
 
-        // Добавляем измерение в массив спутника
-        measurementsBySatellite[satelliteName].push(measurementData);
+        // measurementSynth и staticSensors присылают пачки в том же кадре:
+        // итоги и таблица обновляются один раз в refreshMeasurementsFrame
+        measurementsDirty = true;
+    }
 
-        // ПЕРЕДАЕМ ДАННЫЕ В C++ DataStorage (ТОЛЬКО ВРЕМЯ СИМУЛЯЦИИ!)
-        if (dataStorage) {
-            dataStorage.addMeasurement(
-                satelliteName,
-                timeStrForCpp, // Полная дата-время из симуляции
-                measurement.latitude,
-                measurement.longitude,
-                measurement.noiseLevel,
-                measurement.cityName,
-                measurement.altitude || 0,
-                measurement.distanceToCity || 0,
-                measurement.influenceFactor || 1.0
-            );
-
-            console.log("📡 Измерение передано в C++ из симуляции:");
-            console.log("   Спутник:", satelliteName);
-            console.log("   Время симуляции:", timeStrForDisplay);
-            console.log("   Дата симуляции:", year + "-" + month + "-" + day);
-            console.log("   Уровень:", measurement.noiseLevel.toFixed(1) + "дБм");
-            console.log("   Город:", measurement.cityName);
-        }
+    // Раз в кадр часов, после пачек уведомлений. Таблица выбранного спутника
+    // читается из DataStorage (уведомления о нем могли не попасть в ограниченную
+    // пачку) и перестраивается, только если у спутника появились новые строки
+    function refreshMeasurementsFrame() {
+        if (!measurementsDirty) return;
+        measurementsDirty = false;
+
+        var previousCount = selectedMeasurementCount;
+        refreshStorageStats();
 
-        // Если панель видна и выбран этот спутник, обновляем отображение
-        if (showMeasurementsPanel && selectedSatelliteName === satelliteName) {
+        if (showMeasurementsPanel && (!selectedSatelliteName || selectedMeasurementCount !== previousCount)) {
             updateMeasurementsView();
         }
     }
 
+    // Итоги хранилища для панелей, getStatistics не проходит по данным
+    function refreshStorageStats() {
+        if (!dataStorage) return;
+        storageStats = dataStorage.getStatistics();
+        selectedMeasurementCount = selectedSatelliteName ? dataStorage.getMeasurementCount(selectedSatelliteName) : 0;
+    }
+
     // Функция для обновления представления измерений
     function updateMeasurementsView() {
         measurementsModel.clear();
 
-        if (selectedSatelliteName && measurementsBySatellite[selectedSatelliteName]) {
-            var satMeasurements = measurementsBySatellite[selectedSatelliteName];
-
-            // Показываем последние 50 измерений в обратном порядке (последние сверху)
-            var startIndex = Math.max(0, satMeasurements.length - 50);
-            for (var i = satMeasurements.length - 1; i >= startIndex; i--) {
+        if (selectedSatelliteName && dataStorage) {
+            // Последние 50 измерений спутника из DataStorage, последние сверху
+            var satMeasurements = dataStorage.getRecentMeasurements(selectedSatelliteName, 50);
+            for (var i = 0; i < satMeasurements.length; i++) {
                 var m = satMeasurements[i];
                 measurementsModel.append({
                     satellite: m.satellite,
                     city: m.city,
-                    lat: m.lat,
-                    lng: m.lng,
-                    noiseLevel: m.noiseLevel,
-                    time: m.time, // Только время для отображения
+                    lat: m.latitude,
+                    lng: m.longitude,
+                    noiseLevel: m.radiation,
+                    time: m.time.substr(11, 5), // Только время для отображения
                     distance: m.distance || 0,
                     altitude: m.altitude || 0,
                     influence: m.influence || 1.0
                 });
             }
         } else {
-            // Показываем все измерения (последние 50)
-            var startIndex = Math.max(0, allMeasurements.length - 50);
-            for (var j = allMeasurements.length - 1; j >= startIndex; j--) {
-                var m2 = allMeasurements[j];
+            // Показываем последние уведомления всех спутников
+            for (var j = recentMeasurements.length - 1; j >= 0; j--) {
+                var m2 = recentMeasurements[j];
                 measurementsModel.append({
                     satellite: m2.satellite,
                     city: m2.city,
@@ -1898,68 +1684,16 @@ Item {
         }
     }
 
-    // Добавьте эту функцию для получения полной даты-времени симуляции
-    function getFullSimulationDateTime() {
-        // Текущее время симуляции
-        var simTime = currentTime;
-        var hours = Math.floor(simTime);
-        var minutes = Math.round((simTime % 1) * 60);
-
-        // Начальная дата симуляции
-        var simDate = new Date(startDate);
-
-        // Добавляем прошедшие дни
-        simDate.setDate(simDate.getDate() + Math.floor(daysFromStart));
-
-        // Устанавливаем время
-        simDate.setHours(hours);
-        simDate.setMinutes(minutes);
-        simDate.setSeconds(0);
-
-        // Форматируем в строку для C++
-        var year = simDate.getFullYear();
-        var month = (simDate.getMonth() + 1).toString().padStart(2, '0');
-        var day = simDate.getDate().toString().padStart(2, '0');
-        var hourStr = hours.toString().padStart(2, '0');
-        var minuteStr = minutes.toString().padStart(2, '0');
-
-        return year + "-" + month + "-" + day + "T" + hourStr + ":" + minuteStr + ":00";
-    }
-
-    // Использование в спутнике:
-    // В Satellite.qml или StaticSatellite.qml при создании измерения:
-    function takeMeasurement(cityData) {
-        var measurement = {
-            latitude: cityData.latitude,
-            longitude: cityData.longitude,
-            noiseLevel: calculatedNoise,
-            cityName: cityData.title,
-            altitude: this.altitude,
-            distanceToCity: calculatedDistance,
-            influenceFactor: influence
-        };
-
-        // Передаем в map.qml, который добавит время симуляции
-        measurementTaken(measurement);
-    }
-
     // Функция для очистки всех измерений
     function clearAllMeasurements() {
         measurementsModel.clear();
-        allMeasurements = [];
-        measurementsBySatellite = {};
+        recentMeasurements = [];
 
         // Очищаем данные в C++ хранилище
         if (dataStorage) {
             dataStorage.clearAllData();
         }
-
-        // Также очищаем измерения у всех спутников
-        for (var i = 0; i < satellites.length; i++) {
-            if (satellites[i] && typeof satellites[i].clearMeasurements === 'function') {
-                satellites[i].clearMeasurements();
-            }
-        }
+        refreshStorageStats();
 
         updateStatsDisplay();
         console.log("Все измерения очищены");
@@ -1967,7 +1701,8 @@ Item {
 
     // Функция для экспорта всех измерений через C++
     function exportAllMeasurements() {
-        if (allMeasurements.length === 0) {
+        var total = storageStats.totalMeasurements || 0;
+        if (total === 0) {
             console.log("Нет данных для экспорта");
             return;
         }
@@ -1975,10 +1710,10 @@ Item {
         if (dataStorage) {
             var filename = "satellite_measurements_" +
                           new Date().toISOString().slice(0,10).replace(/-/g, '') + "_" +
-                          allMeasurements.length + "_records.csv";
+                          total + "_records.csv";
 
             if (dataStorage.exportToCSV(filename)) {
-                console.log("📤 Экспортировано через C++:", allMeasurements.length, "измерений");
+                console.log("📤 Экспортировано через C++:", total, "измерений");
             } else {
                 console.log("Ошибка экспорта через C++");
             }
@@ -1989,9 +1724,10 @@ Item {
         }
     }
 
-    // Резервная функция экспорта через JavaScript
+    // Резервная функция экспорта через JavaScript: без DataStorage есть
+    // только последние уведомления
     function exportAllMeasurementsJS() {
-        if (allMeasurements.length === 0) {
+        if (recentMeasurements.length === 0) {
             console.log("Нет данных для экспорта");
             return;
         }
@@ -1999,8 +1735,8 @@ Item {
         var csvContent = "data:text/csv;charset=utf-8,\uFEFF"; // BOM для UTF-8
         csvContent += "Спутник;Время;Широта;Долгота;Уровень излучения (дБм);Город;Высота (км);Расстояние до города (м);Фактор влияния\n";
 
-        for (var i = 0; i < allMeasurements.length; i++) {
-            var m = allMeasurements[i];
+        for (var i = 0; i < recentMeasurements.length; i++) {
+            var m = recentMeasurements[i];
             var time = new Date(m.time);
             var timeStr = time.toISOString().replace('T', ' ').substr(0, 19);
 
@@ -2019,12 +1755,12 @@ Item {
         link.setAttribute("href", encodedUri);
         link.setAttribute("download", "satellite_measurements_" +
                          new Date().toISOString().slice(0,10) + "_" +
-                         allMeasurements.length + "_records.csv");
+                         recentMeasurements.length + "_records.csv");
         document.body.appendChild(link);
         link.click();
         document.body.removeChild(link);
 
-        console.log("📤 Экспортировано измерений (JS):", allMeasurements.length);
+        console.log("📤 Экспортировано измерений (JS):", recentMeasurements.length);
     }
 
     // Функция для получения цвета по уровню шума
@@ -2038,107 +1774,73 @@ Item {
 
     // Функция для подсчета уникальных городов
     function getUniqueCitiesCount() {
-        var cities = new Set();
-        for (var i = 0; i < allMeasurements.length; i++) {
-            if (allMeasurements[i].city !== "Открытая местность") {
-                cities.add(allMeasurements[i].city);
-            }
-        }
-        return cities.size;
+        return storageStats.uniqueCities || 0;
     }
 
     // Функция для получения максимального уровня шума
     function getMaxNoise() {
-        if (allMeasurements.length === 0) return -100;
-        var max = -200;
-        for (var i = 0; i < allMeasurements.length; i++) {
-            if (allMeasurements[i].noiseLevel > max) {
-                max = allMeasurements[i].noiseLevel;
-            }
-        }
-        return max;
+        return storageStats.totalMeasurements ? storageStats.maxRadiation : -100;
     }
 
     // Функция для получения минимального уровня шума
     function getMinNoise() {
-        if (allMeasurements.length === 0) return -100;
-        var min = 0;
-        for (var i = 0; i < allMeasurements.length; i++) {
-            if (allMeasurements[i].noiseLevel < min) {
-                min = allMeasurements[i].noiseLevel;
-            }
-        }
-        return min;
+        return storageStats.totalMeasurements ? storageStats.minRadiation : -100;
     }
 
     // Функция для обновления селектора спутников
     function updateSatelliteSelector() {
-        var names = satellites.map(function(sat) {
-            return sat ? sat.satelliteName : "";
-        }).filter(function(name) { return name; });
+        var names = satelliteEngine.names().concat(staticSensors.names());
 
-        satelliteSelector.model = names;
+        satelliteNames = names;
 
         if (names.length > 0) {
             if (selectedSatelliteIndex === -1 || selectedSatelliteIndex >= names.length) {
                 selectedSatelliteIndex = 0;
                 satelliteSelector.currentIndex = 0;
             }
-            if (selectedSatelliteIndex < satellites.length) {
-                selectedSatelliteName = satellites[selectedSatelliteIndex].satelliteName;
-            }
+            selectedSatelliteName = names[selectedSatelliteIndex];
         } else {
             selectedSatelliteIndex = -1;
             selectedSatelliteName = "";
         }
+        updateSelectedTrack();
+    }
+
+    // Щелчок по спутнику на карте выбирает его в селекторе
+    function selectSatelliteByName(name) {
+        var index = satelliteNames.indexOf(name);
+        if (index >= 0) {
+            satelliteSelector.currentIndex = index;
+        }
+    }
+
+    // Подсветка и трасса выбранного движущегося спутника
+    function updateSelectedTrack() {
+        var engineIndex = selectedSatelliteIndex >= 0 && selectedSatelliteIndex < satelliteEngine.count
+                          ? selectedSatelliteIndex : -1;
+        satelliteLayer.selectedIndex = engineIndex;
+        selectedTrack.path = engineIndex >= 0 ? satelliteEngine.groundTrack(engineIndex) : [];
     }
 
     // ============================================================================
     // УНИВЕРСАЛЬНЫЕ ФУНКЦИИ ДЛЯ ДОБАВЛЕНИЯ СТАТИЧНЫХ СПУТНИКОВ
     // ============================================================================
 
-    // Функция для добавления статичных спутников для всех городов из radiation.json
+    // Функция для добавления статичных спутников для всех городов из radiation.json.
+    // Выключенные города в zoneIndex не попадают, датчики ставятся над всеми зонами
     function addStaticSatellitesForAllCities() {
-        if (!radiationData || !radiationData.circles) {
-            console.log("Ошибка: Данные radiation.json не загружены");
-            loadConfigurationFromJson();
-            return;
+        if (zoneIndex.count === 0) {
+            console.log("Ошибка: зоны radiation.json не загружены:", zoneConfig.errorString);
+            return 0;
         }
 
-        var cities = radiationData.circles;
-        var satellitesAdded = 0;
-        var skippedCities = [];
-
-        console.log("Добавление статичных спутников для " + cities.length + " городов...");
-
-        // Проходим по всем городам
-        for (var i = 0; i < cities.length; i++) {
-            var city = cities[i];
-
-            // Пропускаем выключенные города
-            if (!city.enabled) {
-                skippedCities.push(city.id + " (выключен)");
-                continue;
-            }
-
-            // Добавляем спутник для каждого города
-            var satellite = addStaticSatelliteForCity(city);
-            if (satellite) {
-                satellitesAdded++;
-            } else {
-                skippedCities.push(city.id + " (ошибка создания)");
-            }
-        }
+        var satellitesAdded = staticSensors.addAllSensors();
 
         // Обновляем селектор спутников
         updateSatelliteSelector();
 
         console.log("✅ Добавлено статичных спутников: " + satellitesAdded +
-                   " из " + cities.length + " городов");
-
-        if (skippedCities.length > 0) {
-            console.log("Пропущенные города:", skippedCities.join(", "));
-        }
+                   " из " + zoneConfig.totalCount + " городов");
 
         // Обновляем статистику
         updateStatsDisplay();
@@ -2146,140 +1848,22 @@ Item {
         return satellitesAdded;
     }
 
-    // Функция для получения DataStorage - чтобы спутники могли получить доступ
-    function getDataStorage() {
-        return dataStorage;
-    }
-
-    // Функция для передачи DataStorage спутникам
-    function passDataStorageToSatellites() {
-        console.log("🔄 Передача DataStorage всем спутникам...");
-        console.log("   Всего спутников:", satellites.length);
-        console.log("   dataStorage доступен:", dataStorage !== null);
-
-        var successCount = 0;
-        var failCount = 0;
-
-        for (var i = 0; i < satellites.length; i++) {
-            var satellite = satellites[i];
-            if (satellite && dataStorage) {
-                if (typeof satellite.setDataStorage === 'function') {
-                    satellite.setDataStorage(dataStorage);
-                    successCount++;
-                    console.log("   ✅ DataStorage передан спутнику:", satellite.satelliteName);
-                } else {
-                    failCount++;
-                    console.log("   ❌ Спутник не имеет метода setDataStorage:", satellite.satelliteName);
-                }
-            } else {
-                failCount++;
-                console.log("   ❌ Спутник или dataStorage недоступны:",
-                           satellite ? satellite.satelliteName : "null",
-                           dataStorage ? "dataStorage OK" : "dataStorage null");
-            }
-        }
-
-        console.log("📊 Итог передачи DataStorage:");
-        console.log("   Успешно:", successCount);
-        console.log("   Неудачно:", failCount);
-    }
-
-    // Функция для добавления статичного спутника для конкретного города
-    function addStaticSatelliteForCity(cityData) {
-        var component = Qt.createComponent("qrc:/Map/Items/StaticSatellite.qml");
-
-        if (component.status !== Component.Ready) {
-            console.log("Ошибка создания компонента спутника:", component.errorString());
-            return null;
-        }
-
-        // Создаем спутник
-        var satellite = component.createObject(map);
-
-        // Устанавливаем параметры из данных города
-        satellite.latitude = cityData.latitude;
-        satellite.longitude = cityData.longitude;
-        satellite.altitude = 35786; // Геостационарная орбита
-
-        // Извлекаем название города из полного заголовка
-        var titleParts = cityData.title.split(" - ");
-        var cityName = titleParts[0];
-        var satelliteName = cityName + " Монитор";
-        satellite.satelliteName = satelliteName;
-
-        // ПЕРЕДАЕМ ДАННЫЕ ГОРОДА СПУТНИКУ
-        satellite.setCityData(cityData);
-
-        // Устанавливаем цвет в зависимости от уровня излучения
-        satellite.satelliteColor = getSatelliteColorForNoiseLevel(cityData.baseNoiseLevel);
-        satellite.mapReference = this;
-
-        // КРИТИЧЕСКОЕ ИСПРАВЛЕНИЕ: Передаем dataStorage прямо в спутник
-        console.log("🔄 Передача DataStorage спутнику:", satelliteName);
-        console.log("   dataStorage доступен:", dataStorage !== null);
-
-        if (dataStorage && typeof satellite.setDataStorage === 'function') {
-            satellite.setDataStorage(dataStorage);
-            console.log("✅ DataStorage передан статичному спутнику:", satelliteName);
-
-            // Тестируем соединение
-            try {
-                if (typeof dataStorage.testConnection === 'function') {
-                    dataStorage.testConnection();
-                }
-            } catch (e) {
-                console.log("⚠️ Ошибка тестирования DataStorage:", e);
-            }
-        } else {
-            console.log("❌ Не удалось передать DataStorage спутнику:", satelliteName);
-            console.log("   dataStorage:", dataStorage ? "доступен" : "null");
-            console.log("   setDataStorage метод:", typeof satellite.setDataStorage === 'function' ? "доступен" : "недоступен");
-        }
-
-        // Подключаем сигнал измерения
-        satellite.measurementTaken.connect(function(measurement) {
-            // Убедимся, что имя спутника передано
-            measurement.satelliteName = satelliteName;
-            addMeasurement(measurement, satelliteName);
-        });
-
-        satellite.visible = showSatellites;
-        satellites.push(satellite);
-        map.addMapItem(satellite);
-
-        // Инициализируем хранилище для измерений этого спутника
-        if (!measurementsBySatellite[satelliteName]) {
-            measurementsBySatellite[satelliteName] = [];
-        }
-
-        console.log("✅ Добавлен спутник над " + cityName + " (ID: " + cityData.id + ")");
-        return satellite;
-    }
-
-    // Вспомогательная функция для определения цвета спутника по уровню шума
-    function getSatelliteColorForNoiseLevel(noiseLevel) {
-        if (noiseLevel >= -60) return "#FF0000";     // Очень высокий - красный
-        if (noiseLevel >= -70) return "#FF4400";     // Высокий - оранжевый
-        if (noiseLevel >= -80) return "#FF8800";     // Средний - желто-оранжевый
-        return "#FFCC00";                            // Низкий - желтый
-    }
-
-    // Функция для добавления спутника для конкретного города по ID
+    // Функция для добавления спутника для конкретного города по ID.
+    // Возвращает номер датчика или -1
     function addStaticSatelliteById(cityId) {
-        if (!radiationData || !radiationData.circles) {
-            console.log("Ошибка: Данные radiation.json не загружены");
-            return null;
-        }
-
-        for (var i = 0; i < radiationData.circles.length; i++) {
-            var city = radiationData.circles[i];
-            if (city.id === cityId) {
-                return addStaticSatelliteForCity(city);
+        for (var i = 0; i < noiseCircles.length; i++) {
+            if (noiseCircles[i].circleId === cityId) {
+                var index = staticSensors.addSensor(noiseCircles[i].zoneIndex);
+                if (index >= 0) {
+                    updateSatelliteSelector();
+                    console.log("✅ Добавлен спутник над " + noiseCircles[i].title + " (ID: " + cityId + ")");
+                }
+                return index;
             }
         }
 
         console.log("Город с ID " + cityId + " не найден");
-        return null;
+        return -1;
     }
 
     // ============================================================================
@@ -2313,6 +1897,7 @@ Item {
 
         if (dataStorage) {
             console.log("✅ DataStorage доступен из QML");
+            refreshStorageStats();
             console.log("Данных в хранилище:", dataStorage.getAllMeasurements().length);
 
             // Тестируем методы
@@ -2329,15 +1914,11 @@ Item {
             console.log("❌ DataStorage НЕ доступен из QML - проверьте передачу из C++");
         }
 
-        loadConfigurationFromJson();
+        applyZoneConfiguration();
         updateDayNightCycle();
 
         // Автоматически создаем демо-спутники при загрузке
         initializeDemoSatellites();
 
-        // После добавления спутников передаем им DataStorage
-        Qt.callLater(function() {
-            passDataStorageToSatellites();
-        });
     }
 }
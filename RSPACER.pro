@@ -1,4 +1,4 @@
-QT       += core gui  location positioning quickwidgets
+QT       += core gui  location positioning quick quickwidgets
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -10,16 +10,62 @@ CONFIG += c++11
 
 SOURCES += \
     QmlBridge.cpp \
+    area_analyzer.cpp \
+    celestial_model.cpp \
+    chart_renderer.cpp \
+    coverage_engine.cpp \
     data_storage.cpp \
+    headless_simulation.cpp \
+    indicator_layer.cpp \
     main.cpp \
     mainwindow.cpp \
-    simplechartwindow.cpp
+    map_overlay_item.cpp \
+    measurement_synth.cpp \
+    noise_field_layer.cpp \
+    orbit_propagator.cpp \
+    radiation_histogram.cpp \
+    refresh_scheduler.cpp \
+    satellite_engine.cpp \
+    satellite_layer.cpp \
+    series_lod.cpp \
+    series_stats.cpp \
+    simplechartwindow.cpp \
+    simulation_clock.cpp \
+    static_sensor_scheduler.cpp \
+    tick_pool.cpp \
+    trail_layer.cpp \
+    zone_appearance.cpp \
+    zone_config.cpp \
+    zone_index.cpp
 
 HEADERS += \
     QmlBridge.h \
+    area_analyzer.h \
+    celestial_model.h \
+    chart_renderer.h \
+    coverage_engine.h \
     data_storage.h \
+    headless_simulation.h \
+    indicator_layer.h \
     mainwindow.h \
-    simplechartwindow.h
+    map_overlay_item.h \
+    measurement_synth.h \
+    noise_field_layer.h \
+    orbit_propagator.h \
+    radiation_histogram.h \
+    refresh_scheduler.h \
+    satellite_engine.h \
+    satellite_layer.h \
+    series_lod.h \
+    series_stats.h \
+    simplechartwindow.h \
+    simulation_clock.h \
+    static_sensor_scheduler.h \
+    tick_pool.h \
+    trail_layer.h \
+    zone_appearance.h \
+    zone_config.h \
+    zone_index.h
 
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
@@ -28,9 +74,6 @@ else: unix:!android: target.path = /opt/$${TARGET}/bin
 
 DISTFILES += \
     Map/Items/Marker.qml \
-    Map/Items/NoiseCircle.qml \
-    Map/Items/Satellite.qml \
-    Map/JsonWorker/JsonData.qml \
     Map/map.qml \
     SettingsWindow/solarsystem.qml \
     main.qml
@@ -9,30 +9,23 @@ Item {
     height: 800
 
     property date startDate: new Date(2025, 0, 1) // 1 января 2025
-    property date currentDateTime: new Date(2025, 0, 1)
-    property double solarInfluence: 1.0
-    property double lunarInfluence: 1.0
-    property double planetaryInfluence: 1.0
-    property real daysFromStart: 0
-    property real currentHour: 6.0
-    property string timeOfDay: "Утро"
+
+    // Окно только отображает состояние CelestialModel: время задает карта,
+    // влияние считается в C++
+    property double solarInfluence: celestialModel.solarInfluence
+    property double lunarInfluence: celestialModel.lunarInfluence
+    property double planetaryInfluence: celestialModel.planetaryInfluence
+    property real daysFromStart: celestialModel.days
+    property real currentHour: celestialModel.currentHour
+    property string timeOfDay: celestialModel.timeOfDay
 
     // Эллиптические параметры орбиты Земли (эксцентриситет ~0.0167)
     property real earthOrbitSemiMajor: 300
     property real earthOrbitSemiMinor: 298
     property real earthOrbitFocusDistance: Math.sqrt(earthOrbitSemiMajor * earthOrbitSemiMajor - earthOrbitSemiMinor * earthOrbitSemiMinor)
 
-    property real earthAngle: 0
-    property real earthRotationAngle: 0
-
-    // Таймер для постоянного обновления позиций
-    Timer {
-        id: updateTimer
-        interval: 100 // Обновление каждые 100 мс
-        running: true
-        repeat: true
-        onTriggered: updatePositions()
-    }
+    property real earthAngle: celestialModel.earthAngle
+    property real earthRotationAngle: celestialModel.earthRotationAngle
 
     Rectangle {
         anchors.fill: parent
@@ -142,7 +135,7 @@ Item {
                 to: 360
                 duration: 1000 // 1 секунда для полного оборота (для наглядности)
                 loops: Animation.Infinite
-                running: updateTimer.running
+                running: visible
             }
 
             // Земля с PNG текстурой
@@ -341,8 +334,8 @@ Item {
                 }
 
                 Text {
-                    text: "Статус: " + (updateTimer.running ? "Активен" : "На паузе")
-                    color: updateTimer.running ? "#88FF88" : "#FF8888"
+                    text: "Статус: " + (visible ? "Активен" : "На паузе")
+                    color: visible ? "#88FF88" : "#FF8888"
                     font.pixelSize: 11
                     font.bold: true
                     renderType: Text.NativeRendering
@@ -351,52 +344,6 @@ Item {
         }
     }
 
-    function updatePositions() {
-        // Обновляем углы на основе прошедших дней
-        // Время теперь управляется извне через daysFromStart и currentHour
-
-        // Земля: полный оборот вокруг Солнца за 365.25 дней
-        earthAngle = (daysFromStart / 365.25) * 2 * Math.PI;
-
-        // Вращение Земли вокруг своей оси (1 оборот за 1 день)
-        earthRotationAngle = (daysFromStart % 1) * 2 * Math.PI;
-
-        // Обновляем влияние
-        updateInfluence();
-
-        // Обновляем время суток
-        updateTimeOfDay();
-    }
-
-    function updateInfluence() {
-        // Влияние Солнца (зависит от расстояния по закону обратных квадратов)
-        var distance = getEarthSunDistance();
-        var averageDistance = (earthOrbitSemiMajor + earthOrbitSemiMinor) / 2;
-        var normalizedDistance = distance / averageDistance;
-        solarInfluence = 1.0 / (normalizedDistance * normalizedDistance);
-
-        // Флуктуации солнечной активности
-        var solarFluctuation = 0.95 + (Math.sin(daysFromStart * 0.3) + 1) * 0.05;
-        solarInfluence *= solarFluctuation;
-
-        // Влияние Луны (фиксированное значение, так как Луны нет)
-        lunarInfluence = 1.0;
-
-        // Влияние планет (резонансы и гравитационные возмущения)
-        var planet1 = Math.sin(earthAngle * 2.5) * 0.04;
-        var planet2 = Math.cos(earthAngle * 1.7 + 0.5) * 0.03;
-        var planet3 = Math.sin(earthAngle * 3.2 + 1.2) * 0.02;
-        planetaryInfluence = 1.0 + planet1 + planet2 + planet3;
-
-        // Корректируем по времени суток
-        var timeFactor = 1.0;
-        if (timeOfDay === "Ночь") timeFactor = 0.85;
-        else if (timeOfDay === "День") timeFactor = 1.15;
-        else if (timeOfDay === "Рассвет" || timeOfDay === "Поздний вечер") timeFactor = 0.95;
-
-        solarInfluence *= timeFactor;
-    }
-
     function getInfluenceColor(influence) {
         if (influence > 1.1) return "#FF4444";
         if (influence > 1.0) return "#FFAA00";
@@ -404,19 +351,6 @@ Item {
         return "#8888FF";
     }
 
-    function updateTimeOfDay() {
-        // Обновляем текущий час на основе вращения Земли
-        currentHour = (earthRotationAngle / (2 * Math.PI)) * 24;
-
-        var h = currentHour;
-        if (h >= 4 && h < 8) timeOfDay = "Рассвет";
-        else if (h >= 8 && h < 12) timeOfDay = "Утро";
-        else if (h >= 12 && h < 16) timeOfDay = "День";
-        else if (h >= 16 && h < 20) timeOfDay = "Вечер";
-        else if (h >= 20 && h < 23) timeOfDay = "Поздний вечер";
-        else timeOfDay = "Ночь";
-    }
-
     function getTimeColor() {
         var h = currentHour;
         if (h >= 5 && h < 7) return "#FFAA00";
@@ -425,13 +359,6 @@ Item {
         else return "#3366FF";
     }
 
-    function getEarthSunDistance() {
-        // Расстояние от Земли до Солнца в эллиптической орбите
-        var r = (earthOrbitSemiMajor * (1 - (earthOrbitFocusDistance/earthOrbitSemiMajor)*(earthOrbitFocusDistance/earthOrbitSemiMajor))) /
-                (1 + (earthOrbitFocusDistance/earthOrbitSemiMajor) * Math.cos(earthAngle));
-        return r;
-    }
-
     function formatTime(time) {
         var hours = Math.floor(time);
         var minutes = Math.round((time % 1) * 60);
@@ -449,62 +376,4 @@ Item {
         return currentDate.toLocaleDateString(Qt.locale("ru_RU")) +
                " " + currentDate.toLocaleTimeString(Qt.locale("ru_RU"), "hh:mm");
     }
-
-    function resetToStartDate() {
-        currentDateTime = new Date(2025, 0, 1);
-        currentHour = 6.0;
-        daysFromStart = 0;
-        earthRotationAngle = 0;
-        updatePositions();
-    }
-
-    function setCurrentTime(hour, days) {
-        currentHour = hour;
-        daysFromStart = days;
-
-        currentDateTime = new Date(startDate);
-        currentDateTime.setDate(startDate.getDate() + Math.floor(daysFromStart));
-
-        var fractionalDay = daysFromStart % 1;
-        var additionalHours = fractionalDay * 24;
-        currentDateTime.setHours(6 + Math.floor(additionalHours));
-        currentDateTime.setMinutes(Math.round((additionalHours % 1) * 60));
-
-        updatePositions();
-    }
-
-    // Методы для получения влияния
-    function getSolarInfluence() {
-        return solarInfluence;
-    }
-
-    function getLunarInfluence() {
-        return lunarInfluence;
-    }
-
-    function getPlanetaryInfluence() {
-        return planetaryInfluence;
-    }
-
-    function getCurrentDateTime() {
-        return currentDateTime;
-    }
-
-    function getCurrentHour() {
-        return currentHour;
-    }
-
-    function getTimeOfDay() {
-        return timeOfDay;
-    }
-
-    function getDaysFromStart() {
-        return daysFromStart;
-    }
-
-    Component.onCompleted: {
-        resetToStartDate();
-    }
 }
-
-
@@ -0,0 +1,152 @@
+#include "area_analyzer.h"
+#include "zone_index.h"
+
+#include <QGeoCoordinate>
+#include <QPolygonF>
+#include <QDebug>
+#include <QtMath>
+#include <cmath>
+
+AreaAnalyzer::AreaAnalyzer(ZoneIndex *zones, QObject *parent)
+    : QObject(parent)
+    , m_zones(zones)
+    , m_influence(1.0)
+{
+}
+
+void AreaAnalyzer::setInfluence(double influence)
+{
+    if (qFuzzyCompare(m_influence, influence)) return;
+    m_influence = influence;
+    emit influenceChanged();
+}
+
+void AreaAnalyzer::intersectionAreas(double r1, const double *radii, const double *distances, int n,
+                                     double *areas)
+{
+    // Без ветвлений по случаям, чтобы цикл векторизовался: аргументы acos/sqrt
+    // зажимаются в допустимые границы, а случай выбирается в конце
+    const double r1sq = r1 * r1;
+    for (int i = 0; i < n; i++) {
+        const double r2 = radii[i];
+        const double d = qMax(distances[i], 1e-9);
+        const double r2sq = r2 * r2;
+        const double dsq = d * d;
+
+        double c1 = qBound(-1.0, (dsq + r1sq - r2sq) / (2 * d * r1), 1.0);
+        double c2 = qBound(-1.0, (dsq + r2sq - r1sq) / (2 * d * r2), 1.0);
+        double k = qMax(0.0, (-d + r1 + r2) * (d + r1 - r2) * (d - r1 + r2) * (d + r1 + r2));
+        double lens = r1sq * std::acos(c1) + r2sq * std::acos(c2) - 0.5 * std::sqrt(k);
+
+        double minR = qMin(r1, r2);
+        double contained = M_PI * minR * minR;
+
+        double area = distances[i] <= std::fabs(r1 - r2) ? contained : lens;
+        areas[i] = distances[i] >= r1 + r2 ? 0.0 : area;
+    }
+}
+
+AreaAnalyzer::Result AreaAnalyzer::integrateCircle(double lat, double lng, double radius)
+{
+    Result result = { 0, 0, 0 };
+
+    m_distances.clear();
+    QVector<int> candidates = m_zones->within(lat, lng, radius, &m_distances);
+    const int n = candidates.size();
+    if (n == 0) return result;
+
+    m_radii.resize(n);
+    m_areas.resize(n);
+    for (int i = 0; i < n; i++) {
+        m_radii[i] = m_zones->zone(candidates[i]).radius;
+    }
+
+    intersectionAreas(radius, m_radii.constData(), m_distances.constData(), n, m_areas.data());
+
+    for (int i = 0; i < n; i++) {
+        if (m_areas[i] <= 0) continue;
+        double level = m_zones->zone(candidates[i]).baseNoiseLevel * m_influence;
+        result.weightedNoise += level * m_areas[i];
+        result.area += m_areas[i];
+        result.zoneCount++;
+    }
+    return result;
+}
+
+double AreaAnalyzer::averageNoise(double lat, double lng, double radius)
+{
+    Result result = integrateCircle(lat, lng, radius);
+    if (result.area <= 0) {
+        return -100 * m_influence;
+    }
+    return result.weightedNoise / result.area;
+}
+
+QVariantMap AreaAnalyzer::analyzeCircle(double lat, double lng, double radius)
+{
+    Result result = integrateCircle(lat, lng, radius);
+
+    QVariantMap map;
+    map["average"] = result.area > 0 ? result.weightedNoise / result.area : -100 * m_influence;
+    map["coveredArea"] = result.area;
+    map["zoneCount"] = result.zoneCount;
+    return map;
+}
+
+double AreaAnalyzer::averageNoiseInPolygon(const QVariantList &coordinates, int resolution)
+{
+    if (coordinates.size() < 3 || resolution <= 0) {
+        return -100 * m_influence;
+    }
+
+    // Локальная равнопромежуточная проекция вокруг первой вершины: для областей
+    // в десятки километров искажение пренебрежимо
+    QGeoCoordinate origin = coordinates.first().value<QGeoCoordinate>();
+    const double metersPerDegree = M_PI * ZoneIndex::kEarthRadius / 180.0;
+    const double cosLat = std::cos(qDegreesToRadians(origin.latitude()));
+
+    QPolygonF polygon;
+    polygon.reserve(coordinates.size());
+    for (const QVariant &value : coordinates) {
+        QGeoCoordinate coordinate = value.value<QGeoCoordinate>();
+        double dLng = coordinate.longitude() - origin.longitude();
+        dLng -= 360.0 * std::floor((dLng + 180.0) / 360.0);
+        polygon.append(QPointF(dLng * metersPerDegree * cosLat,
+                               (coordinate.latitude() - origin.latitude()) * metersPerDegree));
+    }
+
+    const QRectF bounds = polygon.boundingRect();
+    const double cellWidth = bounds.width() / resolution;
+    const double cellHeight = bounds.height() / resolution;
+    const double cellArea = cellWidth * cellHeight;
+    if (cellArea <= 0) {
+        return -100 * m_influence;
+    }
+
+    double weightedNoise = 0;
+    double area = 0;
+
+    for (int row = 0; row < resolution; row++) {
+        double y = bounds.top() + (row + 0.5) * cellHeight;
+        double cellLat = origin.latitude() + y / metersPerDegree;
+
+        for (int column = 0; column < resolution; column++) {
+            double x = bounds.left() + (column + 0.5) * cellWidth;
+            if (!polygon.containsPoint(QPointF(x, y), Qt::OddEvenFill)) continue;
+
+            double cellLng = origin.longitude() + x / (metersPerDegree * cosLat);
+
+            // Зоны, в которые попадает центр ячейки
+            QVector<int> zones = m_zones->within(cellLat, cellLng, 0);
+            for (int index : zones) {
+                weightedNoise += m_zones->zone(index).baseNoiseLevel * m_influence * cellArea;
+                area += cellArea;
+            }
+        }
+    }
+
+    if (area <= 0) {
+        return -100 * m_influence;
+    }
+    return weightedNoise / area;
+}
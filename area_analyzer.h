@@ -0,0 +1,62 @@
+#ifndef AREA_ANALYZER_H
+#define AREA_ANALYZER_H
+
+#include <QObject>
+#include <QVector>
+#include <QVariantList>
+#include <QVariantMap>
+
+class ZoneIndex;
+
+// Анализ области: средний уровень шума, взвешенный по площади пересечения
+// области с зонами. Кандидаты отбираются через ZoneIndex, площади пересечения
+// кругов считаются одним проходом по массивам. Для произвольных областей
+// (многоугольник) есть режим интегрирования по растру
+class AreaAnalyzer : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(double influence READ influence WRITE setInfluence NOTIFY influenceChanged)
+
+public:
+    explicit AreaAnalyzer(ZoneIndex *zones, QObject *parent = nullptr);
+
+    // Общий множитель влияния: уровень зоны = baseNoiseLevel * influence
+    double influence() const { return m_influence; }
+    void setInfluence(double influence);
+
+    // Средний шум в круге. Если круг не задевает ни одной зоны - фон -100 * influence
+    Q_INVOKABLE double averageNoise(double lat, double lng, double radius);
+
+    // Подробный результат для круга: { average, coveredArea, zoneCount }
+    Q_INVOKABLE QVariantMap analyzeCircle(double lat, double lng, double radius);
+
+    // Средний шум в многоугольнике (массив координат) интегрированием по растру
+    // resolution x resolution ячеек по описанному прямоугольнику
+    Q_INVOKABLE double averageNoiseInPolygon(const QVariantList &coordinates, int resolution = 64);
+
+    // Площади пересечения круга радиуса r1 с кругами radii[i] на расстояниях distances[i]
+    static void intersectionAreas(double r1, const double *radii, const double *distances, int n,
+                                  double *areas);
+
+signals:
+    void influenceChanged();
+
+private:
+    struct Result {
+        double weightedNoise;
+        double area;
+        int zoneCount;
+    };
+
+    Result integrateCircle(double lat, double lng, double radius);
+
+    ZoneIndex *m_zones;
+    double m_influence;
+
+    // Буферы кандидатов, переиспользуются между вызовами
+    QVector<double> m_distances;
+    QVector<double> m_radii;
+    QVector<double> m_areas;
+};
+
+#endif // AREA_ANALYZER_H
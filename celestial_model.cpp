@@ -0,0 +1,141 @@
+#include "celestial_model.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QtMath>
+#include <cmath>
+
+namespace {
+const double kMinutesPerDay = 24 * 60;
+}
+
+const double CelestialModel::kOrbitSemiMajor = 300;
+const double CelestialModel::kOrbitSemiMinor = 298;
+const double CelestialModel::kDaysPerYear = 365.25;
+
+CelestialModel::CelestialModel(QObject *parent)
+    : QObject(parent)
+    , m_days(0)
+    , m_current(evaluate(0))
+{
+}
+
+void CelestialModel::setDays(double days)
+{
+    if (qFuzzyCompare(m_days, days)) return;
+    m_days = days;
+    m_current = influenceAt(days);
+    emit influenceChanged();
+}
+
+double CelestialModel::earthAngle() const
+{
+    return (m_days / kDaysPerYear) * 2 * M_PI;
+}
+
+double CelestialModel::earthRotationAngle() const
+{
+    return std::fmod(m_days, 1.0) * 2 * M_PI;
+}
+
+double CelestialModel::currentHour() const
+{
+    return std::fmod(m_days, 1.0) * 24;
+}
+
+QString CelestialModel::timeOfDay(double hour)
+{
+    if (hour >= 4 && hour < 8) return "Рассвет";
+    if (hour >= 8 && hour < 12) return "Утро";
+    if (hour >= 12 && hour < 16) return "День";
+    if (hour >= 16 && hour < 20) return "Вечер";
+    if (hour >= 20 && hour < 23) return "Поздний вечер";
+    return "Ночь";
+}
+
+double CelestialModel::timeOfDayFactor(double hour)
+{
+    if (hour >= 12 && hour < 16) return 1.15;                              // День
+    if ((hour >= 4 && hour < 8) || (hour >= 20 && hour < 23)) return 0.95; // Рассвет, поздний вечер
+    if (hour >= 23 || hour < 4) return 0.85;                               // Ночь
+    return 1.0;
+}
+
+double CelestialModel::solarBase(double days)
+{
+    // Расстояние до Солнца на эллипсе, закон обратных квадратов
+    const double focus = std::sqrt(kOrbitSemiMajor * kOrbitSemiMajor - kOrbitSemiMinor * kOrbitSemiMinor);
+    const double eccentricity = focus / kOrbitSemiMajor;
+
+    double angle = (days / kDaysPerYear) * 2 * M_PI;
+    double distance = kOrbitSemiMajor * (1 - eccentricity * eccentricity) /
+                      (1 + eccentricity * std::cos(angle));
+    double normalized = distance / ((kOrbitSemiMajor + kOrbitSemiMinor) / 2);
+
+    // Флуктуации солнечной активности
+    return 1.0 / (normalized * normalized) * (0.95 + (std::sin(days * 0.3) + 1) * 0.05);
+}
+
+double CelestialModel::planetary(double days)
+{
+    // Резонансы и гравитационные возмущения
+    double angle = (days / kDaysPerYear) * 2 * M_PI;
+    return 1.0 + std::sin(angle * 2.5) * 0.04
+               + std::cos(angle * 1.7 + 0.5) * 0.03
+               + std::sin(angle * 3.2 + 1.2) * 0.02;
+}
+
+CelestialInfluence CelestialModel::evaluate(double days)
+{
+    CelestialInfluence influence;
+    influence.solar = solarBase(days) * timeOfDayFactor(std::fmod(days, 1.0) * 24);
+    influence.lunar = 1.0;  // Луна в модели не учитывается
+    influence.planetary = planetary(days);
+    return influence;
+}
+
+CelestialInfluence CelestialModel::influenceAt(double days) const
+{
+    const double minute = days * kMinutesPerDay;
+    if (minute < 0 || minute >= m_solarTable.size() - 1) {
+        return evaluate(days);
+    }
+
+    // Гладкие составляющие интерполируются, поправка на время суток ступенчатая
+    int index = static_cast<int>(minute);
+    double t = minute - index;
+
+    CelestialInfluence influence;
+    influence.solar = (m_solarTable[index] * (1 - t) + m_solarTable[index + 1] * t)
+                      * timeOfDayFactor(std::fmod(days, 1.0) * 24);
+    influence.lunar = 1.0;
+    influence.planetary = m_planetaryTable[index] * (1 - t) + m_planetaryTable[index + 1] * t;
+    return influence;
+}
+
+void CelestialModel::buildTable(double spanDays)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const int count = static_cast<int>(std::ceil(spanDays * kMinutesPerDay)) + 1;
+    m_solarTable.resize(count);
+    m_planetaryTable.resize(count);
+
+    for (int i = 0; i < count; i++) {
+        double days = i / kMinutesPerDay;
+        m_solarTable[i] = static_cast<float>(solarBase(days));
+        m_planetaryTable[i] = static_cast<float>(planetary(days));
+    }
+
+    qDebug() << "CelestialModel: таблица на" << spanDays << "сут. (" << count << "точек) за"
+             << timer.elapsed() << "мс";
+}
+
+void CelestialModel::clearTable()
+{
+    m_solarTable.clear();
+    m_solarTable.squeeze();
+    m_planetaryTable.clear();
+    m_planetaryTable.squeeze();
+}
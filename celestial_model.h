@@ -0,0 +1,87 @@
+#ifndef CELESTIAL_MODEL_H
+#define CELESTIAL_MODEL_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+// Влияние небесных тел на радиошум в момент времени
+struct CelestialInfluence {
+    double solar;
+    double lunar;
+    double planetary;
+
+    double total() const { return solar * lunar * planetary; }
+};
+
+// Модель влияния Солнца, Луны и планет (прежний solarsystem.qml::updateInfluence).
+// Считается аналитически для любого модельного времени, для первого года можно
+// заранее построить поминутную таблицу. Окно солнечной системы только отображает
+// состояние модели, измерения берут влияние отсюда напрямую
+class CelestialModel : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(double days READ days WRITE setDays NOTIFY influenceChanged)
+    Q_PROPERTY(double solarInfluence READ solarInfluence NOTIFY influenceChanged)
+    Q_PROPERTY(double lunarInfluence READ lunarInfluence NOTIFY influenceChanged)
+    Q_PROPERTY(double planetaryInfluence READ planetaryInfluence NOTIFY influenceChanged)
+    Q_PROPERTY(double totalInfluence READ totalInfluence NOTIFY influenceChanged)
+    Q_PROPERTY(double earthAngle READ earthAngle NOTIFY influenceChanged)
+    Q_PROPERTY(double earthRotationAngle READ earthRotationAngle NOTIFY influenceChanged)
+    Q_PROPERTY(double currentHour READ currentHour NOTIFY influenceChanged)
+    Q_PROPERTY(QString timeOfDay READ timeOfDay NOTIFY influenceChanged)
+
+public:
+    // Эллиптическая орбита Земли в единицах окна солнечной системы (e ~ 0.0167)
+    static const double kOrbitSemiMajor;
+    static const double kOrbitSemiMinor;
+    static const double kDaysPerYear;
+
+    explicit CelestialModel(QObject *parent = nullptr);
+
+    // Модельное время в сутках от 1 января 2025
+    double days() const { return m_days; }
+    void setDays(double days);
+
+    double solarInfluence() const { return m_current.solar; }
+    double lunarInfluence() const { return m_current.lunar; }
+    double planetaryInfluence() const { return m_current.planetary; }
+    double totalInfluence() const { return m_current.total(); }
+
+    double earthAngle() const;
+    double earthRotationAngle() const;
+    // Время суток в окне солнечной системы отсчитывается от начала модельных суток
+    double currentHour() const;
+    QString timeOfDay() const { return timeOfDay(currentHour()); }
+
+    // Влияние в произвольный момент: из таблицы, если она есть и покрывает время
+    CelestialInfluence influenceAt(double days) const;
+    Q_INVOKABLE double totalInfluenceAt(double days) const { return influenceAt(days).total(); }
+
+    // Поминутная таблица гладкой части модели на spanDays суток (по умолчанию год)
+    void buildTable(double spanDays = kDaysPerYear);
+    void clearTable();
+    bool hasTable() const { return !m_solarTable.isEmpty(); }
+
+    // Расчет без таблицы
+    static CelestialInfluence evaluate(double days);
+    static QString timeOfDay(double hour);
+
+signals:
+    void influenceChanged();
+
+private:
+    static double solarBase(double days);
+    static double planetary(double days);
+    static double timeOfDayFactor(double hour);
+
+    double m_days;
+    CelestialInfluence m_current;
+
+    // Таблица по минутам: солнечная составляющая без поправки на время суток
+    // и планетная, float - на год это около 4 МБ
+    QVector<float> m_solarTable;
+    QVector<float> m_planetaryTable;
+};
+
+#endif // CELESTIAL_MODEL_H
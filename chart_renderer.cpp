@@ -0,0 +1,260 @@
+#include "chart_renderer.h"
+
+#include <QDateTime>
+#include <QFont>
+#include <QFontMetrics>
+#include <QPen>
+#include <QStringList>
+
+QImage ChartRenderer::createLayer(const ChartScene &scene, const QColor &fill)
+{
+    QImage layer(scene.size * scene.ratio, QImage::Format_ARGB32_Premultiplied);
+    layer.setDevicePixelRatio(scene.ratio);
+    layer.fill(fill);
+    return layer;
+}
+
+QImage ChartRenderer::renderStatic(const ChartScene &scene)
+{
+    QImage layer = createLayer(scene, QColor(255, 255, 255));
+    QPainter painter(&layer);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    drawGrid(painter, scene.chartRect);
+    drawAxes(painter, scene);
+    return layer;
+}
+
+QImage ChartRenderer::renderData(const ChartScene &scene, const QAtomicInt *generation, int expected)
+{
+    QImage layer = createLayer(scene, Qt::transparent);
+    QPainter painter(&layer);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    for (const ChartScene::Line &line : scene.lines) {
+        if (generation && generation->loadAcquire() != expected) {
+            return QImage();
+        }
+        drawLine(painter, scene, line);
+    }
+    return layer;
+}
+
+QImage ChartRenderer::render(const ChartScene &scene)
+{
+    QImage image = renderStatic(scene);
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    painter.drawImage(0, 0, renderData(scene, nullptr, 0));
+    drawTitle(painter, scene.title, scene.size.width());
+
+    QStringList names;
+    QVector<QColor> colors;
+    for (const ChartScene::Line &line : scene.lines) {
+        names.append(line.name);
+        colors.append(line.color);
+    }
+    drawLegend(painter, scene.chartRect, names, colors);
+    return image;
+}
+
+void ChartRenderer::drawGrid(QPainter &painter, const QRect &chartRect)
+{
+    painter.setPen(QPen(QColor(230, 230, 230), 1));
+
+    // Вертикальные линии
+    int xSteps = 10;
+    for (int i = 0; i <= xSteps; i++) {
+        int x = chartRect.left() + (chartRect.width() * i) / xSteps;
+        painter.drawLine(x, chartRect.top(), x, chartRect.bottom());
+    }
+
+    // Горизонтальные линии
+    int ySteps = 8;
+    for (int i = 0; i <= ySteps; i++) {
+        int y = chartRect.top() + (chartRect.height() * i) / ySteps;
+        painter.drawLine(chartRect.left(), y, chartRect.right(), y);
+    }
+}
+
+void ChartRenderer::drawAxes(QPainter &painter, const ChartScene &scene)
+{
+    const QRect &chartRect = scene.chartRect;
+    painter.setPen(QPen(Qt::black, 2));
+
+    // Ось X
+    painter.drawLine(chartRect.left(), chartRect.bottom(),
+                     chartRect.right(), chartRect.bottom());
+
+    // Ось Y
+    painter.drawLine(chartRect.left(), chartRect.top(),
+                     chartRect.left(), chartRect.bottom());
+
+    // Подписи оси Y
+    painter.setPen(QColor(100, 100, 100));
+    painter.setFont(QFont("Arial", 9));
+
+    // Рисуем 5 делений на оси Y
+    for (int i = 0; i <= 5; i++) {
+        double value = scene.minValue + (scene.maxValue - scene.minValue) * i / 5;
+        int y = chartRect.bottom() - chartRect.height() * i / 5;
+
+        // Горизонтальная черточка на оси
+        painter.setPen(QPen(Qt::black, 1));
+        painter.drawLine(chartRect.left() - 5, y, chartRect.left(), y);
+
+        // Подпись значения
+        painter.setPen(QColor(100, 100, 100));
+        QString label = QString::number(value, 'f', 1);
+        QRect labelRect(chartRect.left() - 75, y - 10, 65, 20);
+        painter.drawText(labelRect, Qt::AlignRight | Qt::AlignVCenter, label);
+    }
+
+    // Название оси Y
+    painter.save();
+    painter.translate(30, chartRect.top() + chartRect.height() / 2);
+    painter.rotate(-90);
+    painter.setPen(QColor(0, 0, 0));
+    painter.setFont(QFont("Arial", 10, QFont::Bold));
+    painter.drawText(QRect(-200, 0, 400, 20), Qt::AlignCenter, "Уровень излучения (дБм)");
+    painter.restore();
+
+    // Подписи оси X (время)
+    painter.setFont(QFont("Arial", 9));
+    const qint64 minTime = scene.minTime;
+    const qint64 range = scene.maxTime - scene.minTime;
+
+    if (scene.singlePoint) {
+        // Для одной точки создаем 3 метки: начало, середина и конец диапазона
+        for (int i = 0; i <= 2; i++) {
+            QDateTime timeLabel = QDateTime::fromMSecsSinceEpoch(minTime + range * i / 2);
+
+            int x = chartRect.left() + chartRect.width() * i / 2;
+
+            // Вертикальная черточка на оси
+            painter.setPen(QPen(Qt::black, 1));
+            painter.drawLine(x, chartRect.bottom(), x, chartRect.bottom() + 5);
+
+            // Подпись времени
+            painter.setPen(QColor(100, 100, 100));
+            QString label = i == 1 ? timeLabel.toString("HH:mm:ss")
+                                   : timeLabel.toString("dd.MM.yyyy\nHH:mm:ss");
+
+            QRect labelRect(x - 40, chartRect.bottom() + 10, 80, 40);
+            painter.drawText(labelRect, Qt::AlignCenter, label);
+        }
+    } else {
+        // 5 делений на оси X, равномерно по времени: слой осей
+        // не зависит от числа измерений
+        const int steps = 5;
+        for (int i = 0; i <= steps; i++) {
+            QDateTime timeLabel = QDateTime::fromMSecsSinceEpoch(minTime + range * i / steps);
+
+            int x = chartRect.left() + chartRect.width() * i / steps;
+
+            // Вертикальная черточка на оси
+            painter.setPen(QPen(Qt::black, 1));
+            painter.drawLine(x, chartRect.bottom(), x, chartRect.bottom() + 5);
+
+            // Подпись времени
+            painter.setPen(QColor(100, 100, 100));
+            // В узком окне видны секунды
+            QString label = range < 2 * 60 * 60 * 1000 ? timeLabel.toString("dd.MM.yy\nHH:mm:ss")
+                                                       : timeLabel.toString("dd.MM.yy\nHH:mm");
+
+            QRect labelRect(x - 40, chartRect.bottom() + 10, 80, 40);
+            painter.drawText(labelRect, Qt::AlignCenter, label);
+        }
+    }
+
+    // Название оси X
+    painter.setPen(QColor(0, 0, 0));
+    painter.setFont(QFont("Arial", 10, QFont::Bold));
+    painter.drawText(QRect(chartRect.left(), chartRect.bottom() + 60,
+                          chartRect.width(), 20),
+                    Qt::AlignCenter, "Время");
+}
+
+void ChartRenderer::drawLine(QPainter &painter, const ChartScene &scene, const ChartScene::Line &line)
+{
+    if (line.polyline.size() >= 2) {
+        painter.save();
+        painter.setClipRect(scene.chartRect);
+        painter.setPen(QPen(line.color, 2));
+        painter.drawPolyline(line.polyline);
+        painter.restore();
+    }
+
+    // Точки и подписи поверх линии
+    for (int i = 0; i < line.points.size(); i++) {
+        drawPoint(painter, line.points[i], line.values[i], line.labels[i]);
+    }
+}
+
+void ChartRenderer::drawSegment(QPainter &painter, const QColor &color, const QPointF &from, const QPointF &to)
+{
+    painter.setPen(QPen(color, 2));
+    painter.drawLine(from, to);
+}
+
+void ChartRenderer::drawPoint(QPainter &painter, const QPointF &point, double value, bool label)
+{
+    // Рисуем точку с обводкой
+    painter.setBrush(QColor(255, 50, 50));
+    painter.setPen(QPen(QColor(200, 0, 0), 1));
+    painter.drawEllipse(point, 5, 5);
+
+    if (label) {
+        painter.save();
+        painter.setPen(QColor(0, 0, 0));
+        painter.setFont(QFont("Arial", 8));
+
+        QString valueText = QString::number(value, 'f', 1);
+        QRectF textRect(point.x() - 25, point.y() - 25, 50, 20);
+        painter.drawText(textRect, Qt::AlignCenter, valueText);
+        painter.restore();
+    }
+}
+
+void ChartRenderer::drawTitle(QPainter &painter, const QString &title, int width)
+{
+    if (title.isEmpty()) return;
+
+    painter.setPen(QColor(0, 0, 0));
+    painter.setFont(QFont("Arial", 14, QFont::Bold));
+
+    QRect titleRect(0, 10, width, 30);
+    painter.drawText(titleRect, Qt::AlignCenter, title);
+}
+
+void ChartRenderer::drawLegend(QPainter &painter, const QRect &chartRect,
+                               const QStringList &names, const QVector<QColor> &colors)
+{
+    // Легенда нужна, только когда рядов несколько
+    if (names.size() < 2) return;
+
+    painter.setFont(QFont("Arial", 9));
+    const QFontMetrics metrics = painter.fontMetrics();
+    int textWidth = 0;
+    for (const QString &name : names) {
+        textWidth = qMax(textWidth, metrics.horizontalAdvance(name));
+    }
+
+    const int rowHeight = 18;
+    const QRect box(chartRect.right() - textWidth - 46, chartRect.top() + 8,
+                    textWidth + 38, rowHeight * names.size() + 8);
+    painter.setPen(QColor(200, 200, 200));
+    painter.setBrush(QColor(255, 255, 255, 220));
+    painter.drawRect(box);
+
+    for (int i = 0; i < names.size(); i++) {
+        const int y = box.top() + 4 + rowHeight * i + rowHeight / 2;
+        painter.setPen(QPen(colors[i], 3));
+        painter.drawLine(box.left() + 6, y, box.left() + 26, y);
+
+        painter.setPen(QColor(0, 0, 0));
+        painter.drawText(QRect(box.left() + 32, y - rowHeight / 2, textWidth + 4, rowHeight),
+                         Qt::AlignLeft | Qt::AlignVCenter, names[i]);
+    }
+}
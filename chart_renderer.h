@@ -0,0 +1,71 @@
+#ifndef CHART_RENDERER_H
+#define CHART_RENDERER_H
+
+#include <QAtomicInt>
+#include <QColor>
+#include <QImage>
+#include <QPainter>
+#include <QPointF>
+#include <QPolygonF>
+#include <QRect>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Неизменяемый снимок графика для рабочего потока: ряды уже прорежены
+// по видимому окну и переведены в координаты графика
+struct ChartScene {
+    struct Line {
+        QString name;
+        QColor color;
+        QPolygonF polyline;        // прореженная линия, обрезается по области графика
+        QVector<QPointF> points;   // точки ряда, если они не сливаются
+        QVector<double> values;
+        QVector<bool> labels;      // подписывать ли значение точки
+    };
+
+    QSize size;                    // логический размер изображения
+    qreal ratio;                   // пикселей изображения на логический пиксель
+    QRect chartRect;
+    qint64 minTime;
+    qint64 maxTime;
+    double minValue;
+    double maxValue;
+    bool singlePoint;              // одно измерение: своя разметка оси времени
+    QString title;
+    QVector<Line> lines;
+
+    ChartScene()
+        : ratio(1), minTime(0), maxTime(0), minValue(0), maxValue(0), singlePoint(false) {}
+};
+
+// Отрисовка графика по снимку только в QImage, поэтому годится для рабочих
+// потоков. Фон с сеткой и осями и линии рядов рисуются отдельными слоями,
+// заголовок и легенда - поверх них
+class ChartRenderer
+{
+public:
+    static QImage createLayer(const ChartScene &scene, const QColor &fill);
+
+    // Фон, сетка, оси и их подписи
+    static QImage renderStatic(const ChartScene &scene);
+    // Линии и точки рядов на прозрачном фоне. Отрисовка прерывается между
+    // рядами и возвращает пустое изображение, если generation устарел
+    static QImage renderData(const ChartScene &scene, const QAtomicInt *generation, int expected);
+    // Весь график одним изображением (экспорт)
+    static QImage render(const ChartScene &scene);
+
+    static void drawSegment(QPainter &painter, const QColor &color, const QPointF &from, const QPointF &to);
+    static void drawPoint(QPainter &painter, const QPointF &point, double value, bool label);
+    static void drawTitle(QPainter &painter, const QString &title, int width);
+    static void drawLegend(QPainter &painter, const QRect &chartRect,
+                           const QStringList &names, const QVector<QColor> &colors);
+
+private:
+    static void drawGrid(QPainter &painter, const QRect &chartRect);
+    static void drawAxes(QPainter &painter, const ChartScene &scene);
+    static void drawLine(QPainter &painter, const ChartScene &scene, const ChartScene::Line &line);
+};
+
+#endif // CHART_RENDERER_H
@@ -0,0 +1,356 @@
+#include "coverage_engine.h"
+#include "satellite_engine.h"
+#include "simulation_clock.h"
+#include "zone_index.h"
+#include "orbit_propagator.h"
+#include "tick_pool.h"
+
+#include <QVariantMap>
+#include <QPair>
+#include <QDebug>
+#include <QtMath>
+#include <algorithm>
+#include <limits>
+
+namespace {
+const double kSweepMeters = 150000.0;   // путь подспутниковой точки за грубый шаг, не больше
+const double kMinStep = 5.0;            // секунды модельного времени
+const double kMaxStep = 900.0;
+const double kTimeTolerance = 0.5;      // точность времени событий, секунды
+const double kGoldenRatio = 0.6180339887498949;
+const int kPredictionBlock = 16;        // прогноз спутника дороже шага, блоки мельче
+
+// Порядок кучи: раньше по времени, при равенстве - по спутнику и виду события
+bool later(const CoverageEngine::Event &a, const CoverageEngine::Event &b)
+{
+    if (a.time != b.time) return a.time > b.time;
+    if (a.satellite != b.satellite) return a.satellite > b.satellite;
+    return a.kind > b.kind;
+}
+}
+
+const double CoverageEngine::kHorizonSeconds = 3600.0;
+
+CoverageEngine::CoverageEngine(SatelliteEngine *engine, SimulationClock *clock, ZoneIndex *zones,
+                               QObject *parent)
+    : QObject(parent)
+    , m_engine(engine)
+    , m_clock(clock)
+    , m_zones(zones)
+    , m_backgroundInterval(300)
+    , m_sensorHalfAngle(5)
+    , m_lastTime(clock->simulationTime())
+{
+    connect(m_clock, &SimulationClock::ticked, this, &CoverageEngine::onTick);
+    connect(m_engine, &SatelliteEngine::rowsInserted, this, &CoverageEngine::onSatellitesAdded);
+    connect(m_engine, &SatelliteEngine::modelReset, this, &CoverageEngine::reset);
+    connect(m_zones, &ZoneIndex::zonesChanged, this, &CoverageEngine::invalidatePredictions);
+    connect(m_zones, &ZoneIndex::zonesUpdated, this, &CoverageEngine::invalidatePredictions);
+
+    onSatellitesAdded();
+}
+
+void CoverageEngine::setBackgroundInterval(double seconds)
+{
+    seconds = qMax(0.0, seconds);
+    if (m_backgroundInterval == seconds) return;
+    m_backgroundInterval = seconds;
+    rescheduleBackground();
+    emit settingsChanged();
+}
+
+void CoverageEngine::setSensorHalfAngle(double degrees)
+{
+    degrees = qBound(0.1, degrees, 60.0);
+    if (m_sensorHalfAngle == degrees) return;
+    m_sensorHalfAngle = degrees;
+    invalidatePredictions();
+    emit settingsChanged();
+}
+
+double CoverageEngine::footprintRadius(double altitudeKm) const
+{
+    return qMax(0.0, altitudeKm) * 1000 * std::tan(qDegreesToRadians(m_sensorHalfAngle));
+}
+
+double CoverageEngine::groundSpeedBound(int satellite) const
+{
+    // Наибольшая угловая скорость на орбите (в перигее) плюс вращение Земли
+    const OrbitalElements elements = m_engine->orbits().elements(satellite);
+    const double e = elements.eccentricity;
+    const double meanMotion = 2 * M_PI / elements.periodSeconds();
+    const double angularRate = meanMotion * (1 + e) * (1 + e) / std::pow(1 - e * e, 1.5);
+    return OrbitPropagator::kEarthRadiusKm * 1000 * (angularRate + OrbitPropagator::kEarthRotationRate);
+}
+
+double CoverageEngine::distanceTo(int satellite, int zone, double time, double *reach) const
+{
+    double lat, lng, alt;
+    m_engine->orbits().propagateOne(satellite, time, &lat, &lng, &alt);
+
+    const NoiseZone &target = m_zones->zone(zone);
+    *reach = footprintRadius(alt) + target.radius;
+    return ZoneIndex::distanceMeters(lat, lng, target.latitude, target.longitude);
+}
+
+void CoverageEngine::onSatellitesAdded()
+{
+    const int count = m_engine->count();
+    for (int i = m_predictions.size(); i < count; i++) {
+        Prediction prediction;
+        prediction.until = m_lastTime;
+        m_predictions.append(prediction);
+        scheduleBackground(i);
+    }
+}
+
+void CoverageEngine::reset()
+{
+    m_predictions.clear();
+    m_queue.clear();
+    onSatellitesAdded();
+}
+
+void CoverageEngine::invalidatePredictions()
+{
+    // Фоновые измерения от зон не зависят, окна пересчитываются со следующего шага
+    m_queue.erase(std::remove_if(m_queue.begin(), m_queue.end(),
+                                 [](const Event &event) { return event.kind != Background; }),
+                  m_queue.end());
+    std::make_heap(m_queue.begin(), m_queue.end(), later);
+
+    for (Prediction &prediction : m_predictions) {
+        prediction.until = m_lastTime;
+        prediction.windows.clear();
+    }
+}
+
+void CoverageEngine::rescheduleBackground()
+{
+    m_queue.erase(std::remove_if(m_queue.begin(), m_queue.end(),
+                                 [](const Event &event) { return event.kind == Background; }),
+                  m_queue.end());
+    std::make_heap(m_queue.begin(), m_queue.end(), later);
+
+    for (int i = 0; i < m_predictions.size(); i++) {
+        scheduleBackground(i);
+    }
+}
+
+void CoverageEngine::scheduleBackground(int satellite)
+{
+    if (m_backgroundInterval <= 0) return;
+
+    // Фазы разнесены, чтобы фон всей группировки не приходился на один шаг
+    double phase = std::fmod((satellite + 1) * kGoldenRatio, 1.0);
+    if (phase <= 0) phase = 1;
+    pushEvent({ m_lastTime + m_backgroundInterval * phase, satellite, -1, Background });
+}
+
+void CoverageEngine::pushEvent(const Event &event)
+{
+    m_queue.append(event);
+    std::push_heap(m_queue.begin(), m_queue.end(), later);
+}
+
+void CoverageEngine::scheduleWindows(int satellite, const QVector<Window> &windows)
+{
+    for (const Window &window : windows) {
+        if (window.entry >= 0) pushEvent({ window.entry, satellite, window.zone, Entry });
+        if (window.peak >= 0) pushEvent({ window.peak, satellite, window.zone, Peak });
+        if (window.exit >= 0) pushEvent({ window.exit, satellite, window.zone, Exit });
+    }
+}
+
+void CoverageEngine::onTick(double time, double dt)
+{
+    // Часы сброшены назад - прежние прогнозы недействительны
+    if (time < m_lastTime) {
+        m_lastTime = time - dt;
+        reset();
+    }
+    onSatellitesAdded();
+
+    // Прогноз продлевается, когда шаг дошел до конца предыдущего отрезка
+    QVector<int> stale;
+    for (int i = 0; i < m_predictions.size(); i++) {
+        if (m_predictions[i].until <= time) stale.append(i);
+    }
+
+    if (!stale.isEmpty()) {
+        const int *satellites = stale.constData();
+        Prediction *predictions = m_predictions.data();
+
+        m_engine->tickPool()->parallelFor(stale.size(), kPredictionBlock, [=](int begin, int end) {
+            for (int i = begin; i < end; i++) {
+                const int satellite = satellites[i];
+                Prediction &prediction = predictions[satellite];
+                prediction.windows.clear();
+                while (prediction.until <= time) {
+                    const double from = prediction.until;
+                    prediction.until = from + kHorizonSeconds;
+                    predict(satellite, from, prediction.until, &prediction.windows);
+                }
+            }
+        });
+
+        for (int satellite : stale) {
+            scheduleWindows(satellite, m_predictions[satellite].windows);
+        }
+    }
+
+    m_due.clear();
+    while (!m_queue.isEmpty() && m_queue.first().time <= time) {
+        std::pop_heap(m_queue.begin(), m_queue.end(), later);
+        const Event event = m_queue.takeLast();
+        m_due.append(event);
+
+        if (event.kind == Background) {
+            // Как и раньше, при большом ускорении фон не накапливается
+            Event next = event;
+            next.time = event.time + m_backgroundInterval;
+            if (next.time <= time) next.time = time + m_backgroundInterval;
+            pushEvent(next);
+        }
+    }
+
+    m_lastTime = time;
+    if (!m_due.isEmpty()) {
+        emit eventsDue(m_due);
+    }
+}
+
+void CoverageEngine::predict(int satellite, double from, double to, QVector<Window> *windows) const
+{
+    const OrbitPropagator &orbits = m_engine->orbits();
+    const OrbitalElements elements = orbits.elements(satellite);
+    const double apogeeKm = elements.semiMajorAxisKm * (1 + elements.eccentricity)
+                            - OrbitPropagator::kEarthRadiusKm;
+
+    // За полшага подспутниковая точка уходит не дальше margin, поэтому любое
+    // время внутри окна находится в полушаге от отсчета, попавшего в кандидаты
+    const double speed = groundSpeedBound(satellite);
+    const double step = qBound(kMinStep, 2 * kSweepMeters / speed, kMaxStep);
+    const double margin = speed * step / 2;
+    const double searchRadius = footprintRadius(apogeeKm) + margin;
+
+    const int samples = int(std::ceil((to - from) / step));
+    QVector<QPair<int, int>> hits;  // (зона, номер отсчета)
+    for (int k = 0; k <= samples; k++) {
+        double lat, lng, alt;
+        orbits.propagateOne(satellite, qMin(from + k * step, to), &lat, &lng, &alt);
+        for (int zone : m_zones->within(lat, lng, searchRadius, nullptr)) {
+            hits.append(qMakePair(zone, k));
+        }
+    }
+    if (hits.isEmpty()) return;
+
+    // Подряд идущие отсчеты одной зоны - один отрезок с одним окном
+    std::sort(hits.begin(), hits.end());
+    int first = 0;
+    for (int i = 1; i <= hits.size(); i++) {
+        if (i < hits.size() && hits[i].first == hits[first].first
+            && hits[i].second == hits[i - 1].second + 1) {
+            continue;
+        }
+        const double begin = qMax(from, from + hits[first].second * step - step / 2);
+        const double end = qMin(to, from + hits[i - 1].second * step + step / 2);
+        refineWindow(satellite, hits[first].first, begin, end, step, windows);
+        first = i;
+    }
+}
+
+void CoverageEngine::refineWindow(int satellite, int zone, double from, double to, double step,
+                                  QVector<Window> *windows) const
+{
+    // Отрицательное значение - полоса обзора пересекает круг зоны
+    auto gap = [=](double time) {
+        double reach = 0;
+        double distance = distanceTo(satellite, zone, time, &reach);
+        return distance - reach;
+    };
+
+    // Минимум: сначала мелкие отсчеты, затем золотое сечение вокруг лучшего
+    const int samples = qMax(2, int(std::ceil((to - from) / (step / 4))));
+    const double h = (to - from) / samples;
+    const double gapFrom = gap(from);
+    const double gapTo = gap(to);
+    double bestTime = from;
+    double bestGap = gapFrom;
+    for (int j = 1; j <= samples; j++) {
+        const double time = j == samples ? to : from + j * h;
+        const double value = j == samples ? gapTo : gap(time);
+        if (value < bestGap) {
+            bestGap = value;
+            bestTime = time;
+        }
+    }
+
+    double lo = qMax(from, bestTime - h);
+    double hi = qMin(to, bestTime + h);
+    double x1 = hi - kGoldenRatio * (hi - lo);
+    double x2 = lo + kGoldenRatio * (hi - lo);
+    double g1 = gap(x1);
+    double g2 = gap(x2);
+    while (hi - lo > kTimeTolerance) {
+        if (g1 < g2) {
+            hi = x2;
+            x2 = x1;
+            g2 = g1;
+            x1 = hi - kGoldenRatio * (hi - lo);
+            g1 = gap(x1);
+        } else {
+            lo = x1;
+            x1 = x2;
+            g1 = g2;
+            x2 = lo + kGoldenRatio * (hi - lo);
+            g2 = gap(x2);
+        }
+    }
+    const double peak = (lo + hi) / 2;
+    const double peakGap = gap(peak);
+    if (peakGap < bestGap) {
+        bestGap = peakGap;
+        bestTime = peak;
+    }
+    if (bestGap > 0) return;
+
+    // Граница окна между точкой вне окна и точкой внутри
+    auto boundary = [&](double outside, double inside) {
+        while (std::abs(inside - outside) > kTimeTolerance) {
+            const double middle = (outside + inside) / 2;
+            if (gap(middle) > 0) {
+                outside = middle;
+            } else {
+                inside = middle;
+            }
+        }
+        return (outside + inside) / 2;
+    };
+
+    Window window;
+    window.zone = zone;
+    window.entry = gapFrom > 0 ? boundary(from, bestTime) : -1;
+    window.exit = gapTo > 0 ? boundary(to, bestTime) : -1;
+    window.peak = bestTime > from + kTimeTolerance && bestTime < to - kTimeTolerance ? bestTime : -1;
+    windows->append(window);
+}
+
+QVariantList CoverageEngine::passes(int satellite) const
+{
+    QVariantList result;
+    if (satellite < 0 || satellite >= m_predictions.size()) return result;
+
+    for (const Window &window : m_predictions[satellite].windows) {
+        if (window.exit >= 0 && window.exit < m_lastTime) continue;
+
+        QVariantMap item;
+        item["zone"] = window.zone;
+        item["title"] = m_zones->zone(window.zone).title;
+        item["entry"] = window.entry;
+        item["peak"] = window.peak;
+        item["exit"] = window.exit;
+        result.append(item);
+    }
+    return result;
+}
@@ -0,0 +1,114 @@
+#ifndef COVERAGE_ENGINE_H
+#define COVERAGE_ENGINE_H
+
+#include <QObject>
+#include <QVector>
+#include <QVariantList>
+
+class SatelliteEngine;
+class SimulationClock;
+class ZoneIndex;
+
+// Планирование измерений движущихся спутников по пролетам над зонами.
+// Раньше спутник измерял по счетчику времени, и большая часть измерений
+// приходилась на открытую местность, а пролеты над городами попадали в выборку
+// случайно. Здесь для каждого спутника заранее, на kHorizonSeconds вперед,
+// ищутся окна, когда полоса обзора (радиус по высоте и sensorHalfAngle)
+// пересекает круг зоны, и измерения ставятся на вход в окно, на точку
+// наибольшего сближения и на выход. Между ними спутник измеряет фон раз
+// в backgroundInterval.
+//
+// Поиск окна: трасса считается грубыми шагами, на каждом шаге ZoneIndex::within
+// с запасом на путь за полшага дает кандидатов, для кандидата минимум расстояния
+// уточняется золотым сечением, границы окна - делением пополам. Прогноз
+// спутников идет блоками в TickPool движка, события - в одной куче по времени.
+// Время событий точное, а не время шага, в котором они наступили
+class CoverageEngine : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(double backgroundInterval READ backgroundInterval WRITE setBackgroundInterval NOTIFY settingsChanged)
+    Q_PROPERTY(double sensorHalfAngle READ sensorHalfAngle WRITE setSensorHalfAngle NOTIFY settingsChanged)
+
+public:
+    static const double kHorizonSeconds;
+
+    enum EventKind {
+        Background,  // фоновое измерение, зона ищется по положению
+        Entry,       // вход в окно зоны
+        Peak,        // наибольшее сближение с центром зоны
+        Exit         // выход из окна
+    };
+
+    struct Event {
+        double time;    // секунды модельного времени
+        int satellite;  // индекс в SatelliteEngine
+        int zone;       // индекс в ZoneIndex, -1 для фона
+        EventKind kind;
+    };
+
+    CoverageEngine(SatelliteEngine *engine, SimulationClock *clock, ZoneIndex *zones,
+                   QObject *parent = nullptr);
+
+    // Секунды модельного времени между фоновыми измерениями, 0 - без фона
+    double backgroundInterval() const { return m_backgroundInterval; }
+    void setBackgroundInterval(double seconds);
+
+    // Половина угла обзора датчика, градусы
+    double sensorHalfAngle() const { return m_sensorHalfAngle; }
+    void setSensorHalfAngle(double degrees);
+
+    // Радиус полосы обзора на земле, метров
+    double footprintRadius(double altitudeKm) const;
+
+    // Ближайшие окна спутника: [{ zone, title, entry, peak, exit }], время в секундах
+    // модельного времени, peak/exit = -1, если точка за горизонтом прогноза
+    Q_INVOKABLE QVariantList passes(int satellite) const;
+
+signals:
+    void settingsChanged();
+    // События шага по возрастанию времени
+    void eventsDue(const QVector<CoverageEngine::Event> &events);
+
+private:
+    struct Window {
+        int zone;
+        double entry;   // -1, если спутник в окне с начала отрезка прогноза
+        double peak;    // -1, если минимум на краю отрезка
+        double exit;    // -1, если окно открыто за горизонтом
+    };
+
+    // Прогноз спутника: окна текущего отрезка, события до until уже в очереди
+    struct Prediction {
+        double until;
+        QVector<Window> windows;
+    };
+
+    void onTick(double time, double dt);
+    void onSatellitesAdded();
+    void reset();
+    void invalidatePredictions();
+    void predict(int satellite, double from, double to, QVector<Window> *windows) const;
+    void refineWindow(int satellite, int zone, double from, double to, double step,
+                      QVector<Window> *windows) const;
+    double distanceTo(int satellite, int zone, double time, double *reach) const;
+    double groundSpeedBound(int satellite) const;
+
+    void pushEvent(const Event &event);
+    void scheduleWindows(int satellite, const QVector<Window> &windows);
+    void scheduleBackground(int satellite);
+    void rescheduleBackground();
+
+    SatelliteEngine *m_engine;
+    SimulationClock *m_clock;
+    ZoneIndex *m_zones;
+
+    double m_backgroundInterval;
+    double m_sensorHalfAngle;
+    double m_lastTime;
+
+    QVector<Prediction> m_predictions;  // по индексу спутника
+    QVector<Event> m_queue;             // куча по времени
+    QVector<Event> m_due;
+};
+
+#endif // COVERAGE_ENGINE_H
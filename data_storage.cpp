@@ -5,8 +5,14 @@
 #include <QFileDialog>
 #include <QDir>
 #include <QRandomGenerator>
-
-DataStorage::DataStorage(QObject *parent) : QObject(parent) {
+#include <QMetaMethod>
+
+DataStorage::DataStorage(QObject *parent)
+    : QObject(parent)
+    , totalMeasurements(0)
+    , minRadiation(0)
+    , maxRadiation(0)
+    , sumRadiation(0) {
     qDebug() << "DataStorage инициализирован";
 
     // Добавляем тестовые данные при создании
@@ -93,6 +99,7 @@ void DataStorage::addMeasurement(const QString &satelliteName,
 
     // Добавляем в map
     measurementsMap[satelliteName].append(data);
+    addToHistograms(satelliteName, data);
 
     qDebug() << "✅ Добавлено измерение ИЗ СИМУЛЯЦИИ:";
     qDebug() << "   Спутник:" << satelliteName;
@@ -120,6 +127,7 @@ void DataStorage::addMeasurementData(const QString &satelliteName,
 
     // Добавляем данные
     measurementsMap[satelliteName].append(data);
+    addToHistograms(satelliteName, data);
 
     qDebug() << "Добавлено измерение (объект) для спутника:" << satelliteName
              << "время:" << data.measurementTime.toString()
@@ -138,6 +146,37 @@ void DataStorage::addMeasurementData(const QString &satelliteName,
     emit statisticsUpdated(stats);
 }
 
+// Пакетное добавление измерений - используется симуляцией без GUI
+void DataStorage::addMeasurementsBatch(const QString &satelliteName,
+                                       const QVector<SatelliteMeasurementData> &batch) {
+    if (batch.isEmpty()) {
+        return;
+    }
+
+    // Создаем спутник, если его нет
+    if (!measurementsMap.contains(satelliteName)) {
+        addSatellite(satelliteName);
+    }
+
+    QVector<SatelliteMeasurementData> &dataList = measurementsMap[satelliteName];
+    dataList.reserve(dataList.size() + batch.size());
+    dataList += batch;
+    for (const SatelliteMeasurementData &data : batch) {
+        addToHistograms(satelliteName, data);
+    }
+
+    emit dataAdded(satelliteName, dataList.size());
+
+    // Итоги ведутся по ходу, но подписчикам нужен только результат пакета:
+    // сигнал с QVariantMap на каждое измерение лишь будил бы их впустую.
+    // Собираем карту, только если на нее кто-то подписан
+    static const QMetaMethod statisticsSignal = QMetaMethod::fromSignal(&DataStorage::statisticsUpdated);
+    if (isSignalConnected(statisticsSignal)) {
+        QVariantMap stats = getStatistics();
+        emit statisticsUpdated(stats);
+    }
+}
+
 QVariantList DataStorage::getMeasurementsBySatellite(const QString &satelliteName) {
     QVariantList result;
 
@@ -201,6 +240,8 @@ void DataStorage::clearSatelliteData(const QString &satelliteName) {
         int removedCount = measurementsMap[satelliteName].size();
         measurementsMap[satelliteName].clear();
         measurementsMap.remove(satelliteName);
+        satelliteHistograms.remove(satelliteName);
+        rebuildTotals();
         qDebug() << "Данные спутника" << satelliteName << "очищены. Удалено записей:" << removedCount;
         emit dataCleared();
     }
@@ -213,44 +254,20 @@ void DataStorage::clearAllData() {
     }
 
     measurementsMap.clear();
+    satelliteHistograms.clear();
+    rebuildTotals();
     qDebug() << "Все данные измерений очищены. Удалено записей:" << totalRemoved;
     emit dataCleared();
 }
 
 QVariantMap DataStorage::getStatistics() {
     QVariantMap stats;
-    int totalMeasurements = 0;
-    int uniqueSatellites = measurementsMap.size();
-    double minRadiation = 1000;
-    double maxRadiation = -1000;
-    double sumRadiation = 0;
-    QSet<QString> uniqueCities;
-
-    for (const auto &dataList : measurementsMap) {
-        totalMeasurements += dataList.size();
-
-        for (const auto &data : dataList) {
-            double radiation = data.radiationValue;
-            sumRadiation += radiation;
-
-            if (radiation < minRadiation) minRadiation = radiation;
-            if (radiation > maxRadiation) maxRadiation = radiation;
-
-            if (!data.cityName.isEmpty() && data.cityName != "Открытая местность") {
-                uniqueCities.insert(data.cityName);
-            }
-        }
-    }
-
-    // Если нет данных, устанавливаем значения по умолчанию
-    if (totalMeasurements == 0) {
-        minRadiation = 0;
-        maxRadiation = 0;
-    }
 
+    // Итоги и гистограммы городов обновляются при добавлении измерений,
+    // поэтому статистика не зависит от объема данных
     stats["totalMeasurements"] = totalMeasurements;
-    stats["uniqueSatellites"] = uniqueSatellites;
-    stats["uniqueCities"] = uniqueCities.size();
+    stats["uniqueSatellites"] = measurementsMap.size();
+    stats["uniqueCities"] = cityHistograms.size();
     stats["minRadiation"] = minRadiation;
     stats["maxRadiation"] = maxRadiation;
     stats["avgRadiation"] = totalMeasurements > 0 ? sumRadiation / totalMeasurements : 0;
@@ -331,6 +348,107 @@ QVector<SatelliteMeasurementData> DataStorage::getSatelliteData(const QString &s
     return QVector<SatelliteMeasurementData>();
 }
 
+MeasurementSeries DataStorage::getSeries(const QString &satelliteName, int from) const {
+    MeasurementSeries series;
+
+    auto it = measurementsMap.constFind(satelliteName);
+    if (it == measurementsMap.constEnd()) {
+        return series;
+    }
+
+    const QVector<SatelliteMeasurementData> &dataList = it.value();
+    series.rows = dataList.size();
+
+    const int begin = qMax(0, from);
+    if (begin >= dataList.size()) {
+        return series;
+    }
+
+    series.times.reserve(dataList.size() - begin);
+    series.values.reserve(dataList.size() - begin);
+    for (int i = begin; i < dataList.size(); i++) {
+        const SatelliteMeasurementData &data = dataList[i];
+        if (!data.measurementTime.isValid()) continue;
+        series.times.append(data.measurementTime.toMSecsSinceEpoch());
+        series.values.append(data.radiationValue);
+    }
+    return series;
+}
+
+RadiationHistogram DataStorage::satelliteHistogram(const QString &satelliteName) const {
+    return satelliteHistograms.value(satelliteName);
+}
+
+RadiationHistogram DataStorage::cityHistogram(const QString &cityName) const {
+    return cityHistograms.value(cityName);
+}
+
+QStringList DataStorage::histogramCities() const {
+    QStringList cities = cityHistograms.keys();
+    cities.sort();
+    return cities;
+}
+
+void DataStorage::addToHistograms(const QString &satelliteName, const SatelliteMeasurementData &data) {
+    satelliteHistograms[satelliteName].add(data.radiationValue);
+    addToTotals(data);
+}
+
+void DataStorage::addToTotals(const SatelliteMeasurementData &data) {
+    const double radiation = data.radiationValue;
+    minRadiation = totalMeasurements == 0 ? radiation : qMin(minRadiation, radiation);
+    maxRadiation = totalMeasurements == 0 ? radiation : qMax(maxRadiation, radiation);
+    sumRadiation += radiation;
+    totalMeasurements++;
+
+    // Как в getStatistics: открытая местность городом не считается
+    if (!data.cityName.isEmpty() && data.cityName != "Открытая местность") {
+        cityHistograms[data.cityName].add(radiation);
+    }
+}
+
+void DataStorage::rebuildTotals() {
+    cityHistograms.clear();
+    totalMeasurements = 0;
+    minRadiation = 0;
+    maxRadiation = 0;
+    sumRadiation = 0;
+    for (const auto &dataList : measurementsMap) {
+        for (const auto &data : dataList) {
+            addToTotals(data);
+        }
+    }
+}
+
+QVariantList DataStorage::getRecentMeasurements(const QString &satelliteName, int count) const {
+    QVariantList result;
+
+    auto it = measurementsMap.constFind(satelliteName);
+    if (it == measurementsMap.constEnd()) {
+        return result;
+    }
+
+    const QVector<SatelliteMeasurementData> &dataList = it.value();
+    const int begin = qMax(0, dataList.size() - qMax(0, count));
+    result.reserve(dataList.size() - begin);
+    for (int i = dataList.size() - 1; i >= begin; i--) {
+        const SatelliteMeasurementData &data = dataList[i];
+        QVariantMap item;
+        item["satellite"] = satelliteName;
+        item["time"] = data.measurementTime.toString("yyyy-MM-dd HH:mm:ss");
+        item["latitude"] = data.coordinate.first;
+        item["longitude"] = data.coordinate.second;
+        item["radiation"] = data.radiationValue;
+        item["city"] = data.cityName;
+        item["altitude"] = data.altitude;
+        item["distance"] = data.distanceToCity;
+        item["influence"] = data.influenceFactor;
+
+        result.append(item);
+    }
+    return result;
+}
+
 void DataStorage::addTestData() {
     qDebug() << "=== ДОБАВЛЕНИЕ ТЕСТОВЫХ ДАННЫХ ===";
 
@@ -11,6 +11,9 @@
 #include <QVariantMap>
 #include <QVariantList>
 #include <QDebug>
+#include <QHash>
+
+#include "radiation_histogram.h"
 
 struct SatelliteMeasurementData {
     QDateTime measurementTime;
@@ -41,6 +44,15 @@ struct SatelliteMeasurementData {
         , influenceFactor(influence) {}
 };
 
+// Ряд измерений спутника столбцами для графиков и статистики
+struct MeasurementSeries {
+    QVector<qint64> times;   // время в мс от эпохи
+    QVector<double> values;  // уровень излучения в дБм
+    int rows;                // строк спутника в хранилище на момент снимка
+
+    MeasurementSeries() : rows(0) {}
+};
+
 class DataStorage : public QObject {
     Q_OBJECT
 
@@ -66,9 +78,16 @@ public:
     Q_INVOKABLE void addMeasurementData(const QString &satelliteName,
                                        const SatelliteMeasurementData &data);
 
+    // Пакетное добавление измерений (без построчного логирования, один сигнал на пакет)
+    void addMeasurementsBatch(const QString &satelliteName,
+                              const QVector<SatelliteMeasurementData> &batch);
+
     // Получение всех измерений по спутнику
     Q_INVOKABLE QVariantList getMeasurementsBySatellite(const QString &satelliteName);
 
+    // Последние count измерений спутника, новые первыми, формат как у getMeasurementsBySatellite
+    Q_INVOKABLE QVariantList getRecentMeasurements(const QString &satelliteName, int count) const;
+
     // Получение всех данных
     Q_INVOKABLE QVariantList getAllMeasurements();
 
@@ -78,7 +97,7 @@ public:
     // Очистка всех данных
     Q_INVOKABLE void clearAllData();
 
-    // Получение статистики
+    // Получение статистики (по накопленным при добавлении итогам, без прохода по данным)
     Q_INVOKABLE QVariantMap getStatistics();
 
     // Экспорт в CSV
@@ -96,6 +115,16 @@ public:
     // Получение данных спутника в удобном формате
     Q_INVOKABLE QVector<SatelliteMeasurementData> getSatelliteData(const QString &satelliteName);
 
+    // Время и уровень излучения строк спутника начиная с from, без строк и QVariant.
+    // rows результата передается как from следующего запроса, чтобы получить только новые строки
+    MeasurementSeries getSeries(const QString &satelliteName, int from = 0) const;
+
+    // Распределение уровня излучения, обновляется при каждом добавлении измерения
+    RadiationHistogram satelliteHistogram(const QString &satelliteName) const;
+    RadiationHistogram cityHistogram(const QString &cityName) const;
+    // Города, над которыми были измерения
+    QStringList histogramCities() const;
+
     // Добавление тестовых данных
     Q_INVOKABLE void addTestData();
 
@@ -115,7 +144,20 @@ signals:
     void testDataAdded();
 
 private:
+    void addToHistograms(const QString &satelliteName, const SatelliteMeasurementData &data);
+    void addToTotals(const SatelliteMeasurementData &data);
+    // После удаления спутника: города и итоги не знают, какие измерения были его
+    void rebuildTotals();
+
     QMap<QString, QVector<SatelliteMeasurementData>> measurementsMap;
+    QHash<QString, RadiationHistogram> satelliteHistograms;
+    QHash<QString, RadiationHistogram> cityHistograms;
+
+    // Итоги для getStatistics
+    int totalMeasurements;
+    double minRadiation;
+    double maxRadiation;
+    double sumRadiation;
 };
 
 #endif // DATA_STORAGE_H
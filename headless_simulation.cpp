@@ -0,0 +1,159 @@
+#include "headless_simulation.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <QtMath>
+
+namespace {
+const double kSecondsPerDay = 86400.0;
+}
+
+HeadlessSimulation::HeadlessSimulation(const Options &options, QObject *parent)
+    : QObject(parent)
+    , m_options(options)
+    , m_dataStorage(new DataStorage(this))
+    , m_engine(new SatelliteEngine(this))
+    , m_random(options.seed)
+{
+    // Часы без таймера: шаги выполняются в цикле run() так быстро, как возможно.
+    // Движок подписывается первым, чтобы городские датчики видели шаг уже продвинутым
+    m_clock.setStepSeconds(options.stepSeconds);
+    m_engine->setThreadCount(options.threads);
+    m_engine->setClock(&m_clock);
+
+    // Тестовые данные хранилища не должны попадать в результат симуляции
+    m_dataStorage->clearAllData();
+
+    // Измерения движущихся спутников планируются по пролетам и синтезируются
+    // так же, как в GUI, но копятся до ежесуточного сброса в хранилище
+    m_coverage = new CoverageEngine(m_engine, &m_clock, &m_zoneIndex, this);
+    m_synth = new MeasurementSynth(m_engine, m_coverage, &m_clock, &m_zoneIndex, m_dataStorage, this);
+    m_synth->setCelestialModel(&m_celestial);
+    m_synth->setSeed(options.seed);
+    m_synth->setAutoFlush(false);
+
+    m_sensors = new StaticSensorScheduler(&m_clock, &m_zoneIndex, m_dataStorage, this);
+    m_sensors->setCelestialModel(&m_celestial);
+    m_sensors->setSeed(options.seed);
+    m_sensors->setAutoFlush(false);
+}
+
+HeadlessSimulation::~HeadlessSimulation()
+{
+}
+
+int HeadlessSimulation::run()
+{
+    if (m_options.stepSeconds <= 0 || m_options.durationDays <= 0) {
+        qWarning() << "Некорректные параметры симуляции: шаг" << m_options.stepSeconds
+                   << "с, длительность" << m_options.durationDays << "сут.";
+        return 1;
+    }
+
+    if (!loadZones()) {
+        return 1;
+    }
+
+    createSatellites();
+    if (m_options.citySensors) {
+        m_sensors->addAllSensors();
+    }
+
+    // Влияние небесных тел на каждом шаге берется из поминутной таблицы
+    m_celestial.buildTable(qMin(m_options.durationDays, CelestialModel::kDaysPerYear));
+
+    qInfo() << "Симуляция без GUI:" << m_engine->count() << "спутников,"
+            << m_sensors->count() << "городских датчиков,"
+            << m_options.durationDays << "сут., шаг" << m_options.stepSeconds << "с";
+
+    const double totalSeconds = m_options.durationDays * kSecondsPerDay;
+    const double step = m_options.stepSeconds;
+    int reportedDay = 0;
+
+    QElapsedTimer wallClock;
+    wallClock.start();
+
+    while (m_clock.simulationTime() < totalSeconds) {
+        m_clock.advance(step);
+
+        // Раз в модельные сутки сбрасываем накопленное в хранилище
+        int day = static_cast<int>(m_clock.days());
+        if (day != reportedDay) {
+            reportedDay = day;
+            flushPending();
+            qInfo() << "  День" << day << "- измерений:" << measurementCount()
+                    << "- прошло" << wallClock.elapsed() << "мс";
+        }
+    }
+
+    flushPending();
+
+    QString outputPath = m_options.outputPath;
+    if (outputPath.isEmpty()) {
+        outputPath = QDir::currentPath() + "/simulation_" +
+                     QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss") + ".csv";
+    }
+
+    if (!m_dataStorage->exportToCSV(outputPath)) {
+        qWarning() << "Не удалось записать результат симуляции в" << outputPath;
+        return 1;
+    }
+
+    qInfo() << "Симуляция завершена за" << wallClock.elapsed() << "мс. Измерений:"
+            << measurementCount() << "- файл:" << outputPath;
+    return 0;
+}
+
+bool HeadlessSimulation::loadZones()
+{
+    // Тот же разбор и проверка radiation.json, что и в GUI
+    ZoneConfig config;
+    config.setSource(ZoneConfig::defaultSource());
+    if (!config.load()) {
+        qWarning() << "Не удалось загрузить зоны:" << config.errorString();
+        return false;
+    }
+
+    m_zoneIndex.setZones(config.zones());
+    qInfo() << "Загружено зон из" << config.source() << ":" << config.count();
+    return config.count() > 0;
+}
+
+void HeadlessSimulation::createSatellites()
+{
+    for (int i = 0; i < m_options.satelliteCount; i++) {
+        QString name = QString("Случайный-%1").arg(i + 1);
+        OrbitalElements elements;
+        double raan = qDegreesToRadians(m_random.generateDouble() * 360 - 180);
+        double meanAnomaly = m_random.generateDouble() * 2 * M_PI;
+
+        // Те же типы орбит и диапазоны, что и в map.qml::addRandomSatellite
+        switch (m_random.bounded(4)) {
+        case 0:
+            elements = OrbitalElements::polar(800 + m_random.generateDouble() * 1000, raan, meanAnomaly);
+            break;
+        case 1:
+            elements = OrbitalElements::circular(1500 + m_random.generateDouble() * 10000,
+                                                 M_PI / 4 + m_random.generateDouble() * M_PI / 4,
+                                                 raan, meanAnomaly);
+            break;
+        case 2:
+            elements = OrbitalElements::geostationary(m_random.generateDouble() * 360 - 180,
+                                                      qDegreesToRadians(m_random.generateDouble() * 15));
+            break;
+        default:
+            elements = OrbitalElements::molniya(M_PI / 3, raan, meanAnomaly);
+            break;
+        }
+
+        m_dataStorage->addSatellite(name);
+        m_engine->addSatellite(name, elements);
+    }
+}
+
+void HeadlessSimulation::flushPending()
+{
+    m_sensors->flush();
+    m_synth->flush();
+}
@@ -0,0 +1,66 @@
+#ifndef HEADLESS_SIMULATION_H
+#define HEADLESS_SIMULATION_H
+
+#include <QObject>
+#include <QVector>
+#include <QString>
+#include <QDateTime>
+#include <QRandomGenerator>
+
+#include "data_storage.h"
+#include "satellite_engine.h"
+#include "zone_config.h"
+#include "zone_index.h"
+#include "coverage_engine.h"
+#include "measurement_synth.h"
+#include "celestial_model.h"
+#include "simulation_clock.h"
+#include "static_sensor_scheduler.h"
+
+// Симуляция без виджетов и QML: спутники, измерения и влияние небесных тел
+// считаются в C++ с максимально возможной скоростью, результат пишется в CSV
+class HeadlessSimulation : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Options {
+        double durationDays;   // длительность симуляции в сутках
+        double stepSeconds;    // шаг симуляции в секундах модельного времени
+        int satelliteCount;    // количество движущихся спутников
+        bool citySensors;      // статичные спутники над городами из radiation.json
+        QString outputPath;    // путь к итоговому CSV
+        quint32 seed;          // зерно генератора случайных чисел
+        int threads;           // потоков для шага симуляции, 0 - по числу ядер
+
+        Options()
+            : durationDays(30), stepSeconds(10), satelliteCount(12),
+              citySensors(true), seed(1), threads(0) {}
+    };
+
+    explicit HeadlessSimulation(const Options &options, QObject *parent = nullptr);
+    ~HeadlessSimulation();
+
+    // Запуск симуляции. Возвращает код завершения процесса
+    int run();
+
+private:
+    bool loadZones();
+    void createSatellites();
+    void flushPending();
+    qint64 measurementCount() const { return m_sensors->totalCount() + m_synth->totalCount(); }
+
+    Options m_options;
+    DataStorage *m_dataStorage;
+    SatelliteEngine *m_engine;
+    SimulationClock m_clock;
+    QRandomGenerator m_random;
+
+    ZoneIndex m_zoneIndex;
+    CelestialModel m_celestial;
+    CoverageEngine *m_coverage;
+    MeasurementSynth *m_synth;
+    StaticSensorScheduler *m_sensors;
+};
+
+#endif // HEADLESS_SIMULATION_H
@@ -0,0 +1,197 @@
+#include "indicator_layer.h"
+
+#include <QSGGeometryNode>
+#include <QSGVertexColorMaterial>
+#include <QVariantMap>
+#include <QtMath>
+#include <cmath>
+#include <cstring>
+
+namespace {
+const int kSegments = 20;                          // сегментов окружности импульса
+const int kVerticesPerPulse = kSegments * 3 * 3;   // заливка + кольцо из двух треугольников
+const double kRadius = 16.0;                       // пикселей при полном масштабе
+const double kRingWidth = 3.0;
+}
+
+const int IndicatorLayer::kCapacity = 128;
+const int IndicatorLayer::kLifetimeMs = 2000;
+
+IndicatorLayer::IndicatorLayer(QQuickItem *parent)
+    : MapOverlayItem(parent)
+    , m_pulses(kCapacity)
+    , m_next(0)
+    , m_activeCount(0)
+{
+    m_clock.start();
+    m_frameTimer.setInterval(16);
+    connect(&m_frameTimer, &QTimer::timeout, this, &IndicatorLayer::onFrame);
+}
+
+QColor IndicatorLayer::noiseColor(double noiseLevel)
+{
+    if (noiseLevel > -70) return QColor(0xFF, 0x00, 0x00);
+    if (noiseLevel > -80) return QColor(0xFF, 0x88, 0x00);
+    if (noiseLevel > -90) return QColor(0xFF, 0xFF, 0x00);
+    if (noiseLevel > -100) return QColor(0x00, 0xFF, 0x00);
+    return QColor(0x00, 0x00, 0xFF);
+}
+
+void IndicatorLayer::pulse(double lat, double lng, const QColor &color)
+{
+    // Слоты занимаются по кругу: при одинаковом времени жизни следующий слот
+    // всегда свободен или самый старый
+    Pulse &p = m_pulses[m_next];
+    if (!p.active) {
+        m_activeCount++;
+    }
+    p.position = mercator(lat, lng);
+    p.color = color;
+    p.born = m_clock.elapsed();
+    p.active = true;
+    m_next = (m_next + 1) % kCapacity;
+
+    if (!m_frameTimer.isActive()) {
+        m_frameTimer.start();
+    }
+    update();
+    emit activeCountChanged();
+}
+
+void IndicatorLayer::pulseBatch(const QVariantList &batch)
+{
+    for (const QVariant &value : batch) {
+        QVariantMap item = value.toMap();
+        pulse(item.value("latitude").toDouble(), item.value("longitude").toDouble(),
+              noiseColor(item.value("noiseLevel").toDouble()));
+    }
+}
+
+void IndicatorLayer::clear()
+{
+    for (Pulse &p : m_pulses) {
+        p.active = false;
+    }
+    m_activeCount = 0;
+    m_frameTimer.stop();
+    update();
+    emit activeCountChanged();
+}
+
+void IndicatorLayer::onFrame()
+{
+    const qint64 now = m_clock.elapsed();
+    int active = 0;
+
+    for (Pulse &p : m_pulses) {
+        if (p.active && now - p.born >= kLifetimeMs) {
+            p.active = false;
+        }
+        if (p.active) active++;
+    }
+
+    if (active != m_activeCount) {
+        m_activeCount = active;
+        emit activeCountChanged();
+    }
+    if (active == 0) {
+        m_frameTimer.stop();
+    }
+    update();
+}
+
+void IndicatorLayer::writePulse(QSGGeometry *geometry, int slot, qint64 now) const
+{
+    const Pulse &p = m_pulses[slot];
+    QSGGeometry::ColoredPoint2D *v = geometry->vertexDataAsColoredPoint2D() + slot * kVerticesPerPulse;
+
+    // Та же анимация, что была у MeasurementIndicator.qml: масштаб 0.5 -> 1 за 600 мс,
+    // мигание 300 мс появление, 200 мс пауза, 300 мс затухание
+    double age = now - p.born;
+    double scale = 0.5 + 0.5 * qMin(1.0, age / 600.0);
+    double phase = std::fmod(age, 800.0);
+    double opacity = phase < 300 ? phase / 300 : (phase < 500 ? 1.0 : 1.0 - (phase - 500) / 300);
+
+    QPointF c = toItem(p.position);
+    double outer = kRadius * scale;
+    double inner = qMax(0.0, outer - kRingWidth);
+
+    // Цвета с умножением на альфу для QSGVertexColorMaterial
+    uchar ra = uchar(255 * opacity);
+    uchar rr = uchar(p.color.red() * opacity);
+    uchar rg = uchar(p.color.green() * opacity);
+    uchar rb = uchar(p.color.blue() * opacity);
+    uchar fa = uchar(0x88 * opacity);
+
+    for (int i = 0; i < kSegments; i++) {
+        double a0 = 2 * M_PI * i / kSegments;
+        double a1 = 2 * M_PI * (i + 1) / kSegments;
+        float ix0 = float(c.x() + inner * std::cos(a0)), iy0 = float(c.y() + inner * std::sin(a0));
+        float ix1 = float(c.x() + inner * std::cos(a1)), iy1 = float(c.y() + inner * std::sin(a1));
+        float ox0 = float(c.x() + outer * std::cos(a0)), oy0 = float(c.y() + outer * std::sin(a0));
+        float ox1 = float(c.x() + outer * std::cos(a1)), oy1 = float(c.y() + outer * std::sin(a1));
+
+        // Полупрозрачная темная заливка
+        v[0].set(float(c.x()), float(c.y()), 0, 0, 0, fa);
+        v[1].set(ix0, iy0, 0, 0, 0, fa);
+        v[2].set(ix1, iy1, 0, 0, 0, fa);
+
+        // Кольцо цвета уровня шума
+        v[3].set(ix0, iy0, rr, rg, rb, ra);
+        v[4].set(ox0, oy0, rr, rg, rb, ra);
+        v[5].set(ox1, oy1, rr, rg, rb, ra);
+        v[6].set(ix0, iy0, rr, rg, rb, ra);
+        v[7].set(ox1, oy1, rr, rg, rb, ra);
+        v[8].set(ix1, iy1, rr, rg, rb, ra);
+        v += 9;
+    }
+}
+
+QSGNode *IndicatorLayer::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data)
+{
+    Q_UNUSED(data)
+
+    QSGGeometryNode *node = static_cast<QSGGeometryNode *>(oldNode);
+    if (!node) {
+        // Буфер на весь пул выделяется один раз
+        QSGGeometry *geometry = new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(),
+                                                kCapacity * kVerticesPerPulse);
+        geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+        geometry->setVertexDataPattern(QSGGeometry::DynamicPattern);
+        memset(geometry->vertexDataAsColoredPoint2D(), 0,
+               sizeof(QSGGeometry::ColoredPoint2D) * kCapacity * kVerticesPerPulse);
+
+        node = new QSGGeometryNode;
+        node->setGeometry(geometry);
+        node->setFlag(QSGNode::OwnsGeometry);
+        node->setMaterial(new QSGVertexColorMaterial);
+        node->setFlag(QSGNode::OwnsMaterial);
+
+        for (Pulse &p : m_pulses) {
+            p.drawn = false;
+        }
+    }
+
+    QSGGeometry *geometry = node->geometry();
+    const qint64 now = m_clock.elapsed();
+    bool changed = false;
+
+    for (int slot = 0; slot < kCapacity; slot++) {
+        Pulse &p = m_pulses[slot];
+        if (p.active) {
+            writePulse(geometry, slot, now);
+            p.drawn = true;
+            changed = true;
+        } else if (p.drawn) {
+            memset(geometry->vertexDataAsColoredPoint2D() + slot * kVerticesPerPulse, 0,
+                   sizeof(QSGGeometry::ColoredPoint2D) * kVerticesPerPulse);
+            p.drawn = false;
+            changed = true;
+        }
+    }
+
+    if (changed) {
+        node->markDirty(QSGNode::DirtyGeometry);
+    }
+    return node;
+}
@@ -0,0 +1,67 @@
+#ifndef INDICATOR_LAYER_H
+#define INDICATOR_LAYER_H
+
+#include "map_overlay_item.h"
+
+#include <QColor>
+#include <QVector>
+#include <QVariantList>
+#include <QElapsedTimer>
+#include <QTimer>
+
+class QSGGeometry;
+
+// Индикация измерений: затухающие импульсы в точке измерения. Пул импульсов
+// фиксированного размера выделяется один раз, все импульсы анимируются одними
+// общими часами и рисуются одним узлом геометрии. При переполнении пула
+// переиспользуется самый старый импульс, так что в работе ничего не создается
+class IndicatorLayer : public MapOverlayItem
+{
+    Q_OBJECT
+    Q_PROPERTY(int activeCount READ activeCount NOTIFY activeCountChanged)
+
+public:
+    static const int kCapacity;
+    static const int kLifetimeMs;
+
+    explicit IndicatorLayer(QQuickItem *parent = nullptr);
+
+    int activeCount() const { return m_activeCount; }
+
+    Q_INVOKABLE void pulse(double lat, double lng, const QColor &color);
+    // Пакет из measurementSynth.measurementsTaken: цвет по noiseLevel
+    Q_INVOKABLE void pulseBatch(const QVariantList &batch);
+    Q_INVOKABLE void clear();
+
+    // Цвет уровня шума, как getNoiseColor в map.qml
+    static QColor noiseColor(double noiseLevel);
+
+signals:
+    void activeCountChanged();
+
+protected:
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+
+private:
+    struct Pulse {
+        QPointF position;  // нормированные координаты Меркатора
+        QColor color;
+        qint64 born;       // мс по m_clock
+        bool active;
+        bool drawn;        // вершины слота сейчас не нулевые
+
+        Pulse() : born(0), active(false), drawn(false) {}
+    };
+
+    void onFrame();
+    void writePulse(QSGGeometry *geometry, int slot, qint64 now) const;
+
+    QVector<Pulse> m_pulses;
+    int m_next;
+    int m_activeCount;
+
+    QElapsedTimer m_clock;
+    QTimer m_frameTimer;
+};
+
+#endif // INDICATOR_LAYER_H
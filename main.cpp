@@ -1,16 +1,82 @@
 #include <QApplication>
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QLoggingCategory>
 #include <QQmlApplicationEngine>
 #include <QQmlContext>
 #include "mainwindow.h"
 #include "data_storage.h"
+#include "headless_simulation.h"
+
+static void setupApplicationInfo()
+{
+    // Устанавливаем информацию о приложении
+    QCoreApplication::setApplicationName("Мониторинг радиоизлучения");
+    QCoreApplication::setOrganizationName("Геофизика");
+    QCoreApplication::setApplicationVersion("1.0.0");
+}
+
+// Режим без GUI нужно определить до создания QApplication,
+// чтобы не требовать дисплей на сервере
+static bool isHeadless(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; i++) {
+        if (qstrcmp(argv[i], "--headless") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static int runHeadless(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    setupApplicationInfo();
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Симуляция радиоизлучения без графического интерфейса");
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    QCommandLineOption headlessOption("headless", "Запуск симуляции без GUI.");
+    QCommandLineOption daysOption("days", "Длительность симуляции в сутках.", "days", "30");
+    QCommandLineOption stepOption("step", "Шаг модельного времени в секундах.", "seconds", "10");
+    QCommandLineOption satellitesOption("satellites", "Количество движущихся спутников.", "count", "12");
+    QCommandLineOption noCitiesOption("no-cities", "Не создавать статичные спутники над городами.");
+    QCommandLineOption outputOption(QStringList() << "o" << "output", "Файл CSV для результатов.", "file");
+    QCommandLineOption seedOption("seed", "Зерно генератора случайных чисел.", "seed", "1");
+    QCommandLineOption threadsOption("threads", "Потоков для шага симуляции (0 - по числу ядер).", "count", "0");
+    QCommandLineOption verboseOption("verbose", "Подробный отладочный вывод.");
+
+    parser.addOptions({headlessOption, daysOption, stepOption, satellitesOption,
+                       noCitiesOption, outputOption, seedOption, threadsOption, verboseOption});
+    parser.process(app);
+
+    // Построчный отладочный вывод хранилища замедляет симуляцию на порядки
+    if (!parser.isSet(verboseOption)) {
+        QLoggingCategory::setFilterRules("default.debug=false");
+    }
+
+    HeadlessSimulation::Options options;
+    options.durationDays = parser.value(daysOption).toDouble();
+    options.stepSeconds = parser.value(stepOption).toDouble();
+    options.satelliteCount = parser.value(satellitesOption).toInt();
+    options.citySensors = !parser.isSet(noCitiesOption);
+    options.outputPath = parser.value(outputOption);
+    options.seed = parser.value(seedOption).toUInt();
+    options.threads = parser.value(threadsOption).toInt();
+
+    HeadlessSimulation simulation(options);
+    return simulation.run();
+}
 
 int main(int argc, char *argv[]) {
-    QApplication app(argc, argv);
+    if (isHeadless(argc, argv)) {
+        return runHeadless(argc, argv);
+    }
 
-    // Устанавливаем информацию о приложении
-    app.setApplicationName("Мониторинг радиоизлучения");
-    app.setOrganizationName("Геофизика");
-    app.setApplicationVersion("1.0.0");
+    QApplication app(argc, argv);
+    setupApplicationInfo();
 
     MainWindow window;
     window.show();
@@ -1,13 +1,18 @@
 #include "mainwindow.h"
 #include "data_storage.h"
 #include "simplechartwindow.h"  // Изменено
+#include "indicator_layer.h"
+#include "noise_field_layer.h"
+#include "satellite_layer.h"
+#include "trail_layer.h"
 
 #include <QRandomGenerator>
 #include <QMetaObject>
+#include <QQmlEngine>
 #include <QDebug>
 
 // Реализация SolarSystemDialog
-SolarSystemDialog::SolarSystemDialog(QWidget *parent)
+SolarSystemDialog::SolarSystemDialog(CelestialModel *model, QWidget *parent)
     : QDialog(parent), solarSystemWidget(new QQuickWidget(this))
 {
     setWindowTitle("Солнечная система - Влияние на радиоизлучение");
@@ -17,61 +22,20 @@ SolarSystemDialog::SolarSystemDialog(QWidget *parent)
     QVBoxLayout *layout = new QVBoxLayout(this);
     layout->addWidget(solarSystemWidget);
 
-    solarSystemWidget->setResizeMode(QQuickWidget::SizeRootObjectToView);
-    solarSystemWidget->setSource(QUrl("qrc:/SettingsWindow/solarsystem.qml"));
-
     // Устанавливаем начальную дату - 1 января 2025
     currentDateTime = QDateTime(QDate(2025, 1, 1), QTime(6, 0));
 
-    // Устанавливаем контекст для доступа к свойствам
+    // Контекст нужен до загрузки QML: свойства окна привязаны к модели
+    solarSystemWidget->rootContext()->setContextProperty("celestialModel", model);
     solarSystemWidget->rootContext()->setContextProperty("solarSystemDialog", this);
     solarSystemWidget->rootContext()->setContextProperty("mainWindow", qobject_cast<QObject*>(parent));
-}
-
-SolarSystemDialog::~SolarSystemDialog()
-{
-}
-
-void SolarSystemDialog::setCurrentTime(double hour, double days)
-{
-    if (solarSystemWidget->rootObject()) {
-        QMetaObject::invokeMethod(solarSystemWidget->rootObject(), "setCurrentTime",
-                                 Q_ARG(QVariant, hour),
-                                 Q_ARG(QVariant, days));
-    }
-}
-
-double SolarSystemDialog::getSolarInfluence() const
-{
-    if (solarSystemWidget->rootObject()) {
-        QVariant result;
-        QMetaObject::invokeMethod(solarSystemWidget->rootObject(), "getSolarInfluence",
-                                 Q_RETURN_ARG(QVariant, result));
-        return result.toDouble();
-    }
-    return 1.0;
-}
 
-double SolarSystemDialog::getLunarInfluence() const
-{
-    if (solarSystemWidget->rootObject()) {
-        QVariant result;
-        QMetaObject::invokeMethod(solarSystemWidget->rootObject(), "getLunarInfluence",
-                                 Q_RETURN_ARG(QVariant, result));
-        return result.toDouble();
-    }
-    return 1.0;
+    solarSystemWidget->setResizeMode(QQuickWidget::SizeRootObjectToView);
+    solarSystemWidget->setSource(QUrl("qrc:/SettingsWindow/solarsystem.qml"));
 }
 
-double SolarSystemDialog::getPlanetaryInfluence() const
+SolarSystemDialog::~SolarSystemDialog()
 {
-    if (solarSystemWidget->rootObject()) {
-        QVariant result;
-        QMetaObject::invokeMethod(solarSystemWidget->rootObject(), "getPlanetaryInfluence",
-                                 Q_RETURN_ARG(QVariant, result));
-        return result.toDouble();
-    }
-    return 1.0;
 }
 
 // Основной конструктор MainWindow
@@ -79,17 +43,53 @@ MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , qmlBridge(new QmlBridge(this))
     , m_chartWindow(nullptr)
+    , celestialModel(new CelestialModel(this))
+    , simulationClock(new SimulationClock(this))
     , mapWidget(new QQuickWidget(this))
-    , solarSystemDialog(new SolarSystemDialog(this))
+    , solarSystemDialog(new SolarSystemDialog(celestialModel, this))
     , dataStorage(new DataStorage(this))
-    , solarInfluence(1.0)
-    , lunarInfluence(1.0)
-    , planetaryInfluence(1.0)
+    , satelliteEngine(new SatelliteEngine(this))
+    , zoneConfig(new ZoneConfig(this))
+    , zoneIndex(new ZoneIndex(this))
+    , zoneAppearance(new ZoneAppearance(zoneIndex, simulationClock, this))
+    , coverageEngine(new CoverageEngine(satelliteEngine, simulationClock, zoneIndex, this))
+    , measurementSynth(new MeasurementSynth(satelliteEngine, coverageEngine, simulationClock, zoneIndex,
+                                            dataStorage, this))
+    , staticSensors(new StaticSensorScheduler(simulationClock, zoneIndex, dataStorage, this))
+    , areaAnalyzer(new AreaAnalyzer(zoneIndex, this))
     , markerCounter(0)
+    , m_addedSatellites(0)
+    , m_lastAddedCount(0)
 {
     // Передаем DataStorage в мост
     qmlBridge->setDataStorage(dataStorage);
 
+    // Влияние небесных тел на первый год модельного времени - из таблицы
+    celestialModel->buildTable();
+    measurementSynth->setCelestialModel(celestialModel);
+    staticSensors->setCelestialModel(celestialModel);
+    staticSensors->setAppearance(zoneAppearance);
+
+    // Все подсистемы идут по одним часам: движок спутников - по шагам,
+    // небесная модель и карта - по кадрам
+    satelliteEngine->setClock(simulationClock);
+    connect(simulationClock, &SimulationClock::frameAdvanced, this, [this]() {
+        celestialModel->setDays(simulationClock->days());
+        showAddedDataStatus();
+    });
+
+    // Зоны шума: radiation.json разбирается здесь, до загрузки карты.
+    // Правка файла на диске обновляет только изменившиеся зоны
+    connect(zoneConfig, &ZoneConfig::zonesReset, this, [this]() {
+        zoneIndex->setZones(zoneConfig->zones());
+    });
+    connect(zoneConfig, &ZoneConfig::zonesUpdated, this, [this](const QVector<int> &indices) {
+        zoneIndex->updateZones(indices, zoneConfig->zones());
+    });
+    zoneConfig->setSource(ZoneConfig::defaultSource());
+    zoneConfig->setWatching(true);
+    zoneConfig->load();
+
     setupUI();
     setupMap();
 
@@ -106,11 +106,6 @@ MainWindow::MainWindow(QWidget *parent)
     // Подключаем сигнал от DataStorage
     connect(dataStorage, &DataStorage::dataAdded,
             this, &MainWindow::onSatelliteDataAdded);
-
-    // Таймер для постоянной синхронизации времени с solar system
-    QTimer *syncTimer = new QTimer(this);
-    connect(syncTimer, &QTimer::timeout, this, &MainWindow::syncTimeWithSolarSystem);
-    syncTimer->start(100);
 }
 
 MainWindow::~MainWindow()
@@ -250,6 +245,27 @@ void MainWindow::setupMap()
     context->setContextProperty("dataStorageManager", dataStorage);
     context->setContextProperty("mainWindow", this);
 
+    // Модельное время и движение всех спутников считаются в C++
+    context->setContextProperty("simulationClock", simulationClock);
+    context->setContextProperty("satelliteEngine", satelliteEngine);
+    simulationClock->setRunning(true);
+
+    // Зоны шума из radiation.json (демо-набор при ошибке задается из QML)
+    context->setContextProperty("zoneConfig", zoneConfig);
+    context->setContextProperty("zoneIndex", zoneIndex);
+    context->setContextProperty("zoneAppearance", zoneAppearance);
+    context->setContextProperty("coverageEngine", coverageEngine);
+    context->setContextProperty("measurementSynth", measurementSynth);
+    context->setContextProperty("staticSensors", staticSensors);
+    context->setContextProperty("areaAnalyzer", areaAnalyzer);
+    context->setContextProperty("celestialModel", celestialModel);
+
+    // Слои карты, которые рисуются через scene graph
+    qmlRegisterType<TrailLayer>("RSPACER.Map", 1, 0, "TrailLayer");
+    qmlRegisterType<IndicatorLayer>("RSPACER.Map", 1, 0, "IndicatorLayer");
+    qmlRegisterType<NoiseFieldLayer>("RSPACER.Map", 1, 0, "NoiseFieldLayer");
+    qmlRegisterType<SatelliteLayer>("RSPACER.Map", 1, 0, "SatelliteLayer");
+
     qDebug() << "5. Контекстные свойства установлены";
     qDebug() << "   - qmlBridge:" << (qmlBridge ? "✅" : "❌");
     qDebug() << "   - dataStorage:" << (dataStorage ? "✅" : "❌");
@@ -337,7 +353,6 @@ bool MainWindow::invokeQMLMethod(const QString &method, const QVariant &arg1,
 void MainWindow::onMapLoaded()
 {
     statusBar()->showMessage("Карта успешно загружена");
-    syncTimeWithSolarSystem();
 }
 
 void MainWindow::onFlyToClicked()
@@ -364,7 +379,7 @@ void MainWindow::onAddMarkerClicked()
     if (latOk && lngOk) {
         // Генерация тестового уровня шума с учетом влияния небесных тел
         double baseNoiseLevel = -85 - (QRandomGenerator::global()->generate() % 20);
-        double totalInfluence = solarInfluence * lunarInfluence * planetaryInfluence;
+        double totalInfluence = celestialModel->totalInfluence();
         double influencedNoiseLevel = baseNoiseLevel * totalInfluence;
         QString title = QString("Маркер %1").arg(++markerCounter);
 
@@ -392,7 +407,6 @@ void MainWindow::onSolarSystemClicked()
     solarSystemDialog->raise();
     solarSystemDialog->activateWindow();
 
-    syncTimeWithSolarSystem();
     statusBar()->showMessage("Открыто окно солнечной системы");
 }
 
@@ -412,65 +426,15 @@ void MainWindow::onDateTimeChanged(const QDateTime &dateTime)
 {
     Q_UNUSED(dateTime);
 
-    // Обновляем влияние небесных тел при изменении даты/времени
-    solarInfluence = solarSystemDialog->getSolarInfluence();
-    lunarInfluence = solarSystemDialog->getLunarInfluence();
-    planetaryInfluence = solarSystemDialog->getPlanetaryInfluence();
-
-    updateCelestialInfluence();
-
     QString influenceText = QString("Обновлено влияние: Солнце: %1x, Луна: %2x, Планеты: %3x, Общее: %4x")
-                            .arg(solarInfluence, 0, 'f', 2)
-                            .arg(lunarInfluence, 0, 'f', 2)
-                            .arg(planetaryInfluence, 0, 'f', 2)
-                            .arg(solarInfluence * lunarInfluence * planetaryInfluence, 0, 'f', 2);
+                            .arg(celestialModel->solarInfluence(), 0, 'f', 2)
+                            .arg(celestialModel->lunarInfluence(), 0, 'f', 2)
+                            .arg(celestialModel->planetaryInfluence(), 0, 'f', 2)
+                            .arg(celestialModel->totalInfluence(), 0, 'f', 2);
 
     statusBar()->showMessage(influenceText);
 }
 
-void MainWindow::updateCelestialInfluence()
-{
-    // Передаем влияние в QML карту
-    double totalInfluence = solarInfluence * lunarInfluence * planetaryInfluence;
-    invokeQMLMethod("setCelestialInfluence", totalInfluence);
-}
-
-void MainWindow::syncTimeWithSolarSystem()
-{
-    // Синхронизируем только если окно solar system открыто
-    if (solarSystemDialog->isVisible() && mapWidget->rootObject() && solarSystemDialog) {
-        // Получаем текущее время из карты
-        QVariant currentTime;
-        bool success = QMetaObject::invokeMethod(mapWidget->rootObject(), "getCurrentTime",
-                                                Q_RETURN_ARG(QVariant, currentTime));
-
-        QVariant currentDays;
-        bool daysSuccess = QMetaObject::invokeMethod(mapWidget->rootObject(), "getDaysFromStart",
-                                                   Q_RETURN_ARG(QVariant, currentDays));
-
-        if (success && daysSuccess && currentTime.isValid() && currentDays.isValid()) {
-            // Устанавливаем актуальное время в солнечной системе
-            double actualHour = currentTime.toDouble();
-            double actualDays = currentDays.toDouble();
-
-            solarSystemDialog->setCurrentTime(actualHour, actualDays);
-
-            // Обновляем влияние небесных тел
-            solarInfluence = solarSystemDialog->getSolarInfluence();
-            lunarInfluence = solarSystemDialog->getLunarInfluence();
-            planetaryInfluence = solarSystemDialog->getPlanetaryInfluence();
-            updateCelestialInfluence();
-        }
-    }
-}
-
-void MainWindow::syncSolarSystemTime(double hour, double days)
-{
-    Q_UNUSED(hour);
-    Q_UNUSED(days);
-    syncTimeWithSolarSystem();
-}
-
 void MainWindow::onZoomSliderChanged(int value)
 {
     zoomEdit->setText(QString::number(value));
@@ -543,11 +507,38 @@ void MainWindow::showDataStatistics()
 
 void MainWindow::onSatelliteDataAdded(const QString &satelliteName, int count)
 {
-    statusBar()->showMessage(
-        QString("Добавлено измерение от %1 (всего: %2)").arg(satelliteName).arg(count),
-        3000
-    );
-    m_chartWindow;
+    // На ускорении dataAdded приходит по разу на спутник за кадр,
+    // поэтому здесь только запоминаем, а сообщение выводим по кадру
+    ++m_addedSatellites;
+    m_lastAddedSatellite = satelliteName;
+    m_lastAddedCount = count;
+
+    // Без хода часов кадров нет - ручное добавление показываем сразу
+    if (!simulationClock->isRunning()) {
+        showAddedDataStatus();
+    }
+}
+
+void MainWindow::showAddedDataStatus()
+{
+    if (m_addedSatellites == 0) {
+        return;
+    }
+
+    if (m_addedSatellites == 1) {
+        statusBar()->showMessage(
+            QString("Добавлено измерение от %1 (всего: %2)")
+                .arg(m_lastAddedSatellite).arg(m_lastAddedCount),
+            3000
+        );
+    } else {
+        statusBar()->showMessage(
+            QString("Добавлены измерения от %1 источников (последний: %2, всего: %3)")
+                .arg(m_addedSatellites).arg(m_lastAddedSatellite).arg(m_lastAddedCount),
+            3000
+        );
+    }
+    m_addedSatellites = 0;
 }
 
 bool MainWindow::eventFilter(QObject *obj, QEvent *event)
@@ -26,6 +26,16 @@
 
 #include "QmlBridge.h"
 #include "data_storage.h"
+#include "satellite_engine.h"
+#include "zone_config.h"
+#include "zone_index.h"
+#include "zone_appearance.h"
+#include "coverage_engine.h"
+#include "measurement_synth.h"
+#include "area_analyzer.h"
+#include "celestial_model.h"
+#include "simulation_clock.h"
+#include "static_sensor_scheduler.h"
 #include "simplechartwindow.h"  // Изменено на simplechartwindow.h
 
 class SolarSystemDialog : public QDialog
@@ -33,14 +43,10 @@ class SolarSystemDialog : public QDialog
     Q_OBJECT
 
 public:
-    explicit SolarSystemDialog(QWidget *parent = nullptr);
+    // Окно только отображает состояние модели, время в нее пишет карта
+    explicit SolarSystemDialog(CelestialModel *model, QWidget *parent = nullptr);
     ~SolarSystemDialog();
 
-    void setCurrentTime(double hour, double days);
-    double getSolarInfluence() const;
-    double getLunarInfluence() const;
-    double getPlanetaryInfluence() const;
-
 signals:
     void dateTimeChanged(const QDateTime &dateTime);
 
@@ -57,9 +63,6 @@ public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
-public slots:
-    void syncSolarSystemTime(double hour, double days);
-
 private:
     QmlBridge* qmlBridge;
     SimpleChartWindow *m_chartWindow;  // Изменено на SimpleChartWindow
@@ -72,11 +75,11 @@ private slots:
     void onAnalysisRadiusChanged(int value);
     void onSolarSystemClicked();
     void onDateTimeChanged(const QDateTime &dateTime);
-    void syncTimeWithSolarSystem();
     void onMapLoaded();
     void onExportDataClicked();
     void showDataStatistics();
     void onSatelliteDataAdded(const QString &satelliteName, int count);
+    void showAddedDataStatus();
     void onShowChartsClicked(); // Новый слот для открытия графиков
 
 private:
@@ -84,14 +87,23 @@ private:
     void setupMap();
     bool invokeQMLMethod(const QString &method, const QVariant &arg1 = QVariant(),
                         const QVariant &arg2 = QVariant(), const QVariant &arg3 = QVariant());
-    void updateCelestialInfluence();
 
     // Добавляем обработку событий клавиатуры
     bool eventFilter(QObject *obj, QEvent *event) override;
 
+    CelestialModel *celestialModel;
+    SimulationClock *simulationClock;
     QQuickWidget *mapWidget;
     SolarSystemDialog *solarSystemDialog;
     DataStorage *dataStorage;
+    SatelliteEngine *satelliteEngine;
+    ZoneConfig *zoneConfig;
+    ZoneIndex *zoneIndex;
+    ZoneAppearance *zoneAppearance;
+    CoverageEngine *coverageEngine;
+    MeasurementSynth *measurementSynth;
+    StaticSensorScheduler *staticSensors;
+    AreaAnalyzer *areaAnalyzer;
 
     // Элементы управления
     QLineEdit *latEdit;
@@ -100,12 +112,12 @@ private:
     QSlider *radiusSlider;
     QComboBox *mapTypeCombo;
 
-    // Влияние небесных тел
-    double solarInfluence;
-    double lunarInfluence;
-    double planetaryInfluence;
-
     int markerCounter;
+
+    // Пополнения хранилища за текущий кадр - в строку состояния раз в кадр
+    int m_addedSatellites;
+    QString m_lastAddedSatellite;
+    int m_lastAddedCount;
 };
 
 #endif // MAINWINDOW_H
@@ -0,0 +1,107 @@
+#include "map_overlay_item.h"
+
+#include <QtMath>
+#include <cmath>
+
+const double MapOverlayItem::kTileSize = 256.0;
+const double MapOverlayItem::kMaxLatitude = 85.05112878;
+
+MapOverlayItem::MapOverlayItem(QQuickItem *parent)
+    : QQuickItem(parent)
+    , m_center(0, 0)
+    , m_zoomLevel(0)
+    , m_worldSize(kTileSize)
+    , m_centerMercator(0.5, 0.5)
+{
+    setFlag(ItemHasContents, true);
+}
+
+void MapOverlayItem::setCenter(const QGeoCoordinate &center)
+{
+    if (m_center == center) return;
+    m_center = center;
+    updateViewport();
+}
+
+void MapOverlayItem::setZoomLevel(double zoomLevel)
+{
+    if (qFuzzyCompare(m_zoomLevel, zoomLevel)) return;
+    m_zoomLevel = zoomLevel;
+    updateViewport();
+}
+
+void MapOverlayItem::updateViewport()
+{
+    m_worldSize = kTileSize * std::pow(2.0, m_zoomLevel);
+    m_centerMercator = mercator(m_center.latitude(), m_center.longitude());
+    onViewportChanged();
+    emit viewportChanged();
+}
+
+void MapOverlayItem::geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QQuickItem::geometryChanged(newGeometry, oldGeometry);
+    if (newGeometry.size() != oldGeometry.size()) {
+        onViewportChanged();
+        emit viewportChanged();
+    }
+}
+
+void MapOverlayItem::onViewportChanged()
+{
+    update();
+}
+
+QPointF MapOverlayItem::mercator(double lat, double lng)
+{
+    lat = qBound(-kMaxLatitude, lat, kMaxLatitude);
+    double x = (lng + 180.0) / 360.0;
+    x -= std::floor(x);
+
+    double phi = qDegreesToRadians(lat);
+    double y = 0.5 - std::log(std::tan(M_PI / 4 + phi / 2)) / (2 * M_PI);
+    return QPointF(x, y);
+}
+
+QGeoCoordinate MapOverlayItem::fromMercator(const QPointF &point)
+{
+    double lng = point.x() * 360.0 - 180.0;
+    lng -= 360.0 * std::floor((lng + 180.0) / 360.0);
+    double lat = qRadiansToDegrees(2 * std::atan(std::exp((0.5 - point.y()) * 2 * M_PI)) - M_PI / 2);
+    return QGeoCoordinate(lat, lng);
+}
+
+double MapOverlayItem::wrapDelta(double dx)
+{
+    return dx - std::floor(dx + 0.5);
+}
+
+QPointF MapOverlayItem::toItem(const QPointF &mercatorPoint) const
+{
+    double dx = wrapDelta(mercatorPoint.x() - m_centerMercator.x());
+    double dy = mercatorPoint.y() - m_centerMercator.y();
+    return QPointF(width() / 2 + dx * m_worldSize, height() / 2 + dy * m_worldSize);
+}
+
+QPointF MapOverlayItem::fromCoordinate(const QGeoCoordinate &coordinate) const
+{
+    return toItem(mercator(coordinate.latitude(), coordinate.longitude()));
+}
+
+QGeoCoordinate MapOverlayItem::toCoordinate(const QPointF &point) const
+{
+    double x = m_centerMercator.x() + (point.x() - width() / 2) / m_worldSize;
+    double y = m_centerMercator.y() + (point.y() - height() / 2) / m_worldSize;
+    return fromMercator(QPointF(x, y));
+}
+
+QMatrix4x4 MapOverlayItem::viewMatrix(const QPointF &origin) const
+{
+    double tx = width() / 2 + wrapDelta(origin.x() - m_centerMercator.x()) * m_worldSize;
+    double ty = height() / 2 + (origin.y() - m_centerMercator.y()) * m_worldSize;
+
+    QMatrix4x4 matrix;
+    matrix.translate(tx, ty);
+    matrix.scale(m_worldSize, m_worldSize);
+    return matrix;
+}
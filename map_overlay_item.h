@@ -0,0 +1,68 @@
+#ifndef MAP_OVERLAY_ITEM_H
+#define MAP_OVERLAY_ITEM_H
+
+#include <QQuickItem>
+#include <QGeoCoordinate>
+#include <QPointF>
+#include <QMatrix4x4>
+
+// Базовый класс слоев, которые рисуются поверх Map средствами scene graph.
+// Слой кладется внутрь Map с anchors.fill и повторяет её вид через привязки
+// center и zoomLevel. Проекция - Web Mercator с тайлом 256 пикселей, как у
+// плагина osm: при уровне zoom мир занимает 256 * 2^zoom пикселей
+class MapOverlayItem : public QQuickItem
+{
+    Q_OBJECT
+    Q_PROPERTY(QGeoCoordinate center READ center WRITE setCenter NOTIFY viewportChanged)
+    Q_PROPERTY(double zoomLevel READ zoomLevel WRITE setZoomLevel NOTIFY viewportChanged)
+
+public:
+    static const double kTileSize;
+    static const double kMaxLatitude;
+
+    explicit MapOverlayItem(QQuickItem *parent = nullptr);
+
+    QGeoCoordinate center() const { return m_center; }
+    void setCenter(const QGeoCoordinate &center);
+
+    double zoomLevel() const { return m_zoomLevel; }
+    void setZoomLevel(double zoomLevel);
+
+    // Размер мира в пикселях при текущем zoom
+    double worldSize() const { return m_worldSize; }
+    QPointF centerMercator() const { return m_centerMercator; }
+
+    // Нормированные координаты Web Mercator: x и y в [0, 1), начало в левом верхнем углу
+    static QPointF mercator(double lat, double lng);
+    static QGeoCoordinate fromMercator(const QPointF &point);
+    // Разность по x с учетом шва на 180-м меридиане, результат в [-0.5, 0.5)
+    static double wrapDelta(double dx);
+
+    // Пиксели элемента для нормированной точки (ближайшая к центру копия мира)
+    QPointF toItem(const QPointF &mercatorPoint) const;
+    Q_INVOKABLE QPointF fromCoordinate(const QGeoCoordinate &coordinate) const;
+    Q_INVOKABLE QGeoCoordinate toCoordinate(const QPointF &point) const;
+
+    // Матрица из нормированных координат, отсчитанных от origin, в пиксели элемента.
+    // Вершины слоя хранятся относительно origin, чтобы float хватало на крупном zoom
+    QMatrix4x4 viewMatrix(const QPointF &origin) const;
+
+signals:
+    void viewportChanged();
+
+protected:
+    void geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry) override;
+
+    // Вызывается при любом изменении вида: центр, zoom, размер элемента
+    virtual void onViewportChanged();
+
+private:
+    void updateViewport();
+
+    QGeoCoordinate m_center;
+    double m_zoomLevel;
+    double m_worldSize;
+    QPointF m_centerMercator;
+};
+
+#endif // MAP_OVERLAY_ITEM_H
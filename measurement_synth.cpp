@@ -0,0 +1,259 @@
+#include "measurement_synth.h"
+#include "satellite_engine.h"
+#include "simulation_clock.h"
+#include "zone_index.h"
+#include "celestial_model.h"
+#include "tick_pool.h"
+
+#include <QRandomGenerator>
+#include <QVariantMap>
+#include <QMetaMethod>
+#include <QDebug>
+#include <QtMath>
+#include <algorithm>
+
+namespace {
+QString passName(CoverageEngine::EventKind kind)
+{
+    switch (kind) {
+    case CoverageEngine::Entry: return QStringLiteral("entry");
+    case CoverageEngine::Peak: return QStringLiteral("peak");
+    case CoverageEngine::Exit: return QStringLiteral("exit");
+    default: return QStringLiteral("background");
+    }
+}
+}
+
+const int MeasurementSynth::kMaxNoticesPerFrame = 200;
+
+MeasurementSynth::MeasurementSynth(SatelliteEngine *engine, CoverageEngine *coverage,
+                                   SimulationClock *clock, ZoneIndex *zones, DataStorage *storage,
+                                   QObject *parent)
+    : QObject(parent)
+    , m_engine(engine)
+    , m_clock(clock)
+    , m_zones(zones)
+    , m_storage(storage)
+    , m_celestialModel(nullptr)
+    , m_seed(QRandomGenerator::global()->generate64())
+    , m_celestialInfluence(1.0)
+    , m_autoFlush(true)
+    , m_totalCount(0)
+{
+    connect(coverage, &CoverageEngine::eventsDue, this, &MeasurementSynth::onEventsDue);
+    connect(m_engine, &SatelliteEngine::modelReset, this, &MeasurementSynth::resetSatellites);
+    connect(m_clock, &SimulationClock::frameAdvanced, this, &MeasurementSynth::onFrame);
+}
+
+void MeasurementSynth::setSeed(quint32 seed)
+{
+    m_seed = seed;
+    for (int i = 0; i < m_satellites.size(); i++) {
+        m_satellites[i].random = satelliteSeed(m_seed, i);
+    }
+}
+
+quint64 MeasurementSynth::satelliteSeed(quint64 seed, int index)
+{
+    quint64 state = seed ^ (quint64(index + 1) * 0xD1B54A32D192ED03ULL);
+    nextRandom(&state);
+    return state;
+}
+
+double MeasurementSynth::nextRandom(quint64 *state)
+{
+    // splitmix64: восемь байт состояния на спутник вместо QRandomGenerator
+    quint64 z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    return (z >> 11) * (1.0 / 9007199254740992.0);
+}
+
+void MeasurementSynth::syncSatellites()
+{
+    // Новые спутники движка получают состояние до запуска блоков
+    const int count = m_engine->count();
+    for (int i = m_satellites.size(); i < count; i++) {
+        SatelliteState state;
+        state.name = m_engine->name(i);
+        state.random = satelliteSeed(m_seed, i);
+        m_satellites.append(state);
+    }
+}
+
+void MeasurementSynth::resetSatellites()
+{
+    // Накопленное по удаленным спутникам сохраняем, имена есть в состоянии
+    flush();
+    m_satellites.clear();
+    m_notices.clear();
+}
+
+double MeasurementSynth::celestialInfluence() const
+{
+    return m_celestialModel ? m_celestialModel->totalInfluence() : m_celestialInfluence;
+}
+
+void MeasurementSynth::setCelestialInfluence(double influence)
+{
+    if (qFuzzyCompare(m_celestialInfluence, influence)) return;
+    m_celestialInfluence = influence;
+    emit clockChanged();
+}
+
+double MeasurementSynth::timeFactor(double hour)
+{
+    if (hour >= 6 && hour < 18) return 1.15;                                // День
+    if ((hour >= 4 && hour < 6) || (hour >= 18 && hour < 20)) return 1.02;  // Рассвет, закат
+    return 1.0;                                                             // Ночь
+}
+
+void MeasurementSynth::onEventsDue(const QVector<CoverageEngine::Event> &events)
+{
+    const int n = events.size();
+    if (n == 0) return;
+
+    syncSatellites();
+
+    // События приходят по времени, генератор спутника должен видеть их в том же
+    // порядке при любом числе потоков: группируем по спутнику, внутри - по времени
+    QVector<int> order(n);
+    for (int i = 0; i < n; i++) order[i] = i;
+    const CoverageEngine::Event *due = events.constData();
+    std::stable_sort(order.begin(), order.end(), [due](int a, int b) {
+        return due[a].satellite < due[b].satellite;
+    });
+
+    QVector<int> groups;  // начало группы в order, последний элемент - n
+    for (int i = 0; i < n; i++) {
+        if (i == 0 || due[order[i]].satellite != due[order[i - 1]].satellite) groups.append(i);
+    }
+    groups.append(n);
+
+    // Уведомление для QML собираем только если на него кто-то подписан, и не больше
+    // kMaxNoticesPerFrame за кадр: места получают первые по времени события
+    const bool notify = isSignalConnected(QMetaMethod::fromSignal(&MeasurementSynth::measurementsTaken));
+    const int offset = m_notices.size();
+    const int noticeCount = notify ? qBound(0, kMaxNoticesPerFrame - offset, n) : 0;
+    Notice *notices = nullptr;
+    if (noticeCount > 0) {
+        m_notices.resize(offset + noticeCount);
+        notices = m_notices.data() + offset;
+    }
+
+    const int *sorted = order.constData();
+    const int *starts = groups.constData();
+    SatelliteState *satellites = m_satellites.data();
+    const SatelliteEngine *engine = m_engine;
+    const SimulationClock *clock = m_clock;
+    const ZoneIndex *zones = m_zones;
+    const CelestialModel *celestialModel = m_celestialModel;
+    const double fixedCelestial = m_celestialInfluence;
+
+    m_engine->tickPool()->parallelFor(groups.size() - 1, SatelliteEngine::kBlockSize, [=](int begin, int end) {
+        for (int group = begin; group < end; group++) {
+            for (int j = starts[group]; j < starts[group + 1]; j++) {
+                const CoverageEngine::Event &event = due[sorted[j]];
+                SatelliteState &satellite = satellites[event.satellite];
+
+                SatelliteMeasurementData data;
+                double lat, lng, alt;
+                engine->orbits().propagateOne(event.satellite, event.time, &lat, &lng, &alt);
+                data.measurementTime = clock->dateTimeAt(event.time);
+                data.coordinate = qMakePair(lat, lng);
+                data.altitude = alt;
+                // Влияние небесных тел - на минуту события, а не шага часов (таблица, O(1))
+                const double celestial = celestialModel
+                    ? celestialModel->influenceAt(clock->daysAt(event.time)).total()
+                    : fixedCelestial;
+                data.influenceFactor = celestial * timeFactor(clock->hourAt(event.time));
+
+                // Для событий пролета зона известна, для фона ищется ближайшая
+                double distance = 0;
+                int zoneIndex = event.zone;
+                if (zoneIndex >= 0) {
+                    const NoiseZone &zone = zones->zone(zoneIndex);
+                    distance = ZoneIndex::distanceMeters(lat, lng, zone.latitude, zone.longitude);
+                } else {
+                    zoneIndex = zones->nearest(lat, lng, 3.0, &distance);
+                }
+
+                if (zoneIndex >= 0) {
+                    const NoiseZone &zone = zones->zone(zoneIndex);
+                    data.cityName = zone.title;
+                    data.distanceToCity = distance;
+                    // Базовый уровень шума уменьшается с расстоянием, вариация ±3 дБм
+                    double distanceFactor = qMax(0.1, 1 - (distance / (zone.radius * 3)));
+                    double randomVariation = nextRandom(&satellite.random) * 6 - 3;
+                    data.radiationValue = zone.baseNoiseLevel * distanceFactor * data.influenceFactor
+                                          + randomVariation;
+                } else {
+                    // Фоновый шум открытой местности с учетом высоты
+                    data.cityName = "Открытая местность";
+                    data.distanceToCity = 0;
+                    double heightFactor = qMax(0.3, 1 - (data.altitude / 40000));
+                    data.radiationValue = -95 * heightFactor * data.influenceFactor;
+                }
+
+                satellite.pending.append(data);
+
+                if (sorted[j] < noticeCount) {
+                    Notice &notice = notices[sorted[j]];
+                    notice.index = event.satellite;
+                    notice.zone = zoneIndex;
+                    notice.kind = event.kind;
+                    notice.time = data.measurementTime.toMSecsSinceEpoch();
+                    notice.latitude = lat;
+                    notice.longitude = lng;
+                    notice.altitude = alt;
+                    notice.noiseLevel = data.radiationValue;
+                    notice.distance = data.distanceToCity;
+                    notice.influence = data.influenceFactor;
+                }
+            }
+        }
+    });
+
+    m_totalCount += n;
+}
+
+void MeasurementSynth::onFrame()
+{
+    if (m_autoFlush) {
+        flush();
+    }
+
+    if (m_notices.isEmpty()) return;
+
+    QVariantList batch;
+    batch.reserve(m_notices.size());
+    for (const Notice &notice : m_notices) {
+        QVariantMap item;
+        item["index"] = notice.index;
+        item["satelliteName"] = m_satellites[notice.index].name;
+        item["time"] = notice.time;
+        item["latitude"] = notice.latitude;
+        item["longitude"] = notice.longitude;
+        item["altitude"] = notice.altitude;
+        item["noiseLevel"] = notice.noiseLevel;
+        item["cityName"] = notice.zone >= 0 ? m_zones->zone(notice.zone).title
+                                            : QStringLiteral("Открытая местность");
+        item["distance"] = notice.distance;
+        item["influence"] = notice.influence;
+        item["pass"] = passName(notice.kind);
+        batch.append(item);
+    }
+    m_notices.clear();
+
+    emit measurementsTaken(batch);
+}
+
+void MeasurementSynth::flush()
+{
+    for (SatelliteState &satellite : m_satellites) {
+        if (satellite.pending.isEmpty()) continue;
+        m_storage->addMeasurementsBatch(satellite.name, satellite.pending);
+        satellite.pending.clear();
+    }
+}
@@ -0,0 +1,110 @@
+#ifndef MEASUREMENT_SYNTH_H
+#define MEASUREMENT_SYNTH_H
+
+#include <QObject>
+#include <QVector>
+#include <QDateTime>
+#include <QVariantList>
+
+#include "data_storage.h"
+#include "coverage_engine.h"
+
+class SatelliteEngine;
+class SimulationClock;
+class ZoneIndex;
+class CelestialModel;
+
+// Синтез измерений движущихся спутников в C++. Модель шума (расстояние до зоны,
+// время суток, влияние небесных тел) повторяет прежний Satellite.qml::takeMeasurement.
+// Когда измерять, решает CoverageEngine: вход в окно зоны, наибольшее сближение,
+// выход и фон. Положение, метка времени и время суток берутся на точный момент
+// события. Расчет шума идет блоками спутников в TickPool движка, у каждого
+// спутника свой генератор случайных чисел и свой буфер измерений, поэтому
+// результат не зависит от числа потоков.
+// В DataStorage измерения уходят пачками один раз за кадр часов. QML получает
+// за кадр не больше kMaxNoticesPerFrame уведомлений для индикации и таблицы,
+// полные ряды читаются из DataStorage
+class MeasurementSynth : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(double celestialInfluence READ celestialInfluence WRITE setCelestialInfluence NOTIFY clockChanged)
+
+public:
+    static const int kMaxNoticesPerFrame;
+
+    MeasurementSynth(SatelliteEngine *engine, CoverageEngine *coverage, SimulationClock *clock,
+                     ZoneIndex *zones, DataStorage *storage, QObject *parent = nullptr);
+
+    double celestialInfluence() const;
+    void setCelestialInfluence(double influence);
+
+    // Если модель задана, влияние небесных тел берется из нее на момент измерения,
+    // а celestialInfluence только читается
+    void setCelestialModel(CelestialModel *model) { m_celestialModel = model; }
+
+    // Зерно генераторов спутников: генератор спутника i выводится из (seed, i)
+    void setSeed(quint32 seed);
+
+    // При выключенной автозаписи измерения копятся до flush() (симуляция без GUI)
+    void setAutoFlush(bool enabled) { m_autoFlush = enabled; }
+    void flush();
+
+    qint64 totalCount() const { return m_totalCount; }
+
+    // Множитель времени суток из Satellite.qml::calculateTimeFactor
+    static double timeFactor(double hour);
+
+signals:
+    void clockChanged();
+    // Для отображения: [{ index, satelliteName, time, latitude, longitude, altitude,
+    // noiseLevel, cityName, distance, influence, pass }] - index это индекс спутника
+    // в SatelliteEngine, time - время измерения в мс от эпохи,
+    // pass - "background", "entry", "peak" или "exit"
+    void measurementsTaken(const QVariantList &batch);
+
+private:
+    // Состояние спутника по индексу в SatelliteEngine
+    struct SatelliteState {
+        QString name;
+        quint64 random;  // состояние генератора splitmix64
+        QVector<SatelliteMeasurementData> pending;
+    };
+
+    // Измерение для уведомления QML, собирается в потоках пула
+    struct Notice {
+        int index;
+        int zone;
+        CoverageEngine::EventKind kind;
+        qint64 time;
+        double latitude;
+        double longitude;
+        double altitude;
+        double noiseLevel;
+        double distance;
+        double influence;
+    };
+
+    void onEventsDue(const QVector<CoverageEngine::Event> &events);
+    void onFrame();
+    void syncSatellites();
+    void resetSatellites();
+
+    static quint64 satelliteSeed(quint64 seed, int index);
+    static double nextRandom(quint64 *state);
+
+    SatelliteEngine *m_engine;
+    SimulationClock *m_clock;
+    ZoneIndex *m_zones;
+    DataStorage *m_storage;
+    CelestialModel *m_celestialModel;
+
+    quint64 m_seed;
+    double m_celestialInfluence;
+    bool m_autoFlush;
+    qint64 m_totalCount;
+
+    QVector<SatelliteState> m_satellites;
+    QVector<Notice> m_notices;  // измерения текущего кадра для QML, первые по времени
+};
+
+#endif // MEASUREMENT_SYNTH_H
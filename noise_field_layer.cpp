@@ -0,0 +1,492 @@
+#include "noise_field_layer.h"
+#include "zone_index.h"
+#include "zone_appearance.h"
+
+#include <QPainter>
+#include <QQuickWindow>
+#include <QRunnable>
+#include <QSGSimpleTextureNode>
+#include <QSGTexture>
+#include <QThread>
+#include <QDebug>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Тайлы родительских уровней, которые показываются, пока нужный еще рисуется
+const int kFallbackLevels = 4;
+
+// Корневой узел слоя владеет текстурами тайлов: узлы удаляются в потоке
+// рендеринга, там же должны удаляться и текстуры
+class FieldNode : public QSGNode
+{
+public:
+    struct Texture {
+        QSGTexture *texture;
+        quint64 serial;
+        bool used;
+    };
+
+    ~FieldNode() override
+    {
+        for (const Texture &entry : textures) {
+            delete entry.texture;
+        }
+    }
+
+    QHash<quint64, Texture> textures;
+    QVector<QSGSimpleTextureNode *> tileNodes;  // переиспользуемые дочерние узлы
+    int usedNodes = 0;
+};
+}
+
+const int NoiseFieldLayer::kTilePixels = 256;
+const int NoiseFieldLayer::kMaxZoom = 20;
+const int NoiseFieldLayer::kMaxCachedTiles = 256;
+
+// Растеризация одного тайла в пуле. Работает только со снимком зон,
+// результат возвращается в поток слоя отложенным вызовом
+class NoiseFieldLayer::TileJob : public QRunnable
+{
+public:
+    TileJob(NoiseFieldLayer *layer, QSharedPointer<const FieldSnapshot> snapshot, int z, int x, int y)
+        : m_layer(layer), m_snapshot(snapshot), m_z(z), m_x(x), m_y(y)
+    {
+    }
+
+    void run() override
+    {
+        QImage image;
+        bool empty = !NoiseFieldLayer::renderTile(*m_snapshot, m_z, m_x, m_y, &image);
+
+        NoiseFieldLayer *layer = m_layer;
+        quint64 key = NoiseFieldLayer::tileKey(m_z, m_x, m_y);
+        QMetaObject::invokeMethod(layer, [layer, key, image, empty]() {
+            layer->onTileRendered(key, image, empty);
+        }, Qt::QueuedConnection);
+    }
+
+private:
+    NoiseFieldLayer *m_layer;
+    QSharedPointer<const FieldSnapshot> m_snapshot;
+    int m_z, m_x, m_y;
+};
+
+NoiseFieldLayer::NoiseFieldLayer(QQuickItem *parent)
+    : MapOverlayItem(parent)
+    , m_snapshot(new FieldSnapshot)
+    , m_frame(0)
+    , m_serial(0)
+    , m_pendingCount(0)
+{
+    // Один поток оставляем GUI
+    m_pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+}
+
+NoiseFieldLayer::~NoiseFieldLayer()
+{
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+QObject *NoiseFieldLayer::zones() const
+{
+    return m_zones.data();
+}
+
+void NoiseFieldLayer::setZones(QObject *zones)
+{
+    ZoneIndex *zoneIndex = qobject_cast<ZoneIndex *>(zones);
+    if (m_zones == zoneIndex) return;
+
+    if (m_zones) {
+        disconnect(m_zones, nullptr, this, nullptr);
+    }
+
+    m_zones = zoneIndex;
+    if (m_zones) {
+        connect(m_zones, &ZoneIndex::zonesChanged, this, &NoiseFieldLayer::invalidateAll);
+        connect(m_zones, &ZoneIndex::zonesUpdated, this, &NoiseFieldLayer::onZonesUpdated);
+    }
+
+    invalidateAll();
+    emit zonesChanged();
+}
+
+QObject *NoiseFieldLayer::appearance() const
+{
+    return m_appearance.data();
+}
+
+void NoiseFieldLayer::setAppearance(QObject *appearance)
+{
+    ZoneAppearance *zoneAppearance = qobject_cast<ZoneAppearance *>(appearance);
+    if (m_appearance == zoneAppearance) return;
+
+    if (m_appearance) {
+        disconnect(m_appearance, nullptr, this, nullptr);
+    }
+
+    m_appearance = zoneAppearance;
+    if (m_appearance) {
+        connect(m_appearance, &ZoneAppearance::appearanceChanged, this, &NoiseFieldLayer::onAppearanceChanged);
+    }
+
+    invalidateAll();
+    emit appearanceChanged();
+}
+
+void NoiseFieldLayer::onAppearanceChanged(const QVector<int> &indices)
+{
+    // Смена дня и ночи задевает все зоны - проще перерисовать все тайлы
+    const int count = m_snapshot->size();
+    if (indices.size() * 2 > count) {
+        invalidateAll();
+        return;
+    }
+
+    // Снимок могут читать задачи пула, поэтому меняется копия
+    QSharedPointer<FieldSnapshot> snapshot(new FieldSnapshot(*m_snapshot));
+    QVector<QRectF> dirty;
+    dirty.reserve(indices.size());
+    for (int index : indices) {
+        if (index < 0 || index >= count) continue;
+        fillZone(index, count, &(*snapshot)[index]);
+        dirty.append(snapshot->at(index).bounds);
+    }
+    m_snapshot = snapshot;
+    invalidateRects(dirty);
+}
+
+void NoiseFieldLayer::onZonesUpdated(const QVector<int> &indices)
+{
+    // Перерисовываются только тайлы под прежним и новым кругом изменившихся зон
+    QVector<QRectF> dirty;
+    for (int index : indices) {
+        if (index >= 0 && index < m_snapshot->size()) {
+            dirty.append(m_snapshot->at(index).bounds);
+        }
+    }
+
+    rebuildSnapshot();
+    for (int index : indices) {
+        if (index >= 0 && index < m_snapshot->size()) {
+            dirty.append(m_snapshot->at(index).bounds);
+        }
+    }
+    invalidateRects(dirty);
+}
+
+void NoiseFieldLayer::fillZone(int index, int count, FieldZone *field) const
+{
+    if (m_appearance) {
+        field->fill = m_appearance->color(index);
+        field->opacity = m_appearance->opacity(index);
+    } else {
+        field->fill = m_zones->zone(index).color;
+        field->opacity = ZoneAppearance::opacityFor(0.6, index, count);
+    }
+    field->border = field->fill.darker(120);
+}
+
+void NoiseFieldLayer::rebuildSnapshot()
+{
+    QSharedPointer<FieldSnapshot> snapshot(new FieldSnapshot);
+
+    if (m_zones) {
+        const QVector<NoiseZone> &zones = m_zones->zones();
+        const int count = zones.size();
+        snapshot->reserve(count);
+
+        for (int i = 0; i < count; i++) {
+            const NoiseZone &zone = zones[i];
+            FieldZone field;
+            field.center = mercator(zone.latitude, zone.longitude);
+            // Меркатор конформен: малый круг остается кругом с масштабом 1/cos(широты)
+            double latitude = qBound(-kMaxLatitude, zone.latitude, kMaxLatitude);
+            field.radius = zone.radius / (2 * M_PI * ZoneIndex::kEarthRadius * std::cos(qDegreesToRadians(latitude)));
+            field.bounds = QRectF(field.center.x() - field.radius, field.center.y() - field.radius,
+                                  2 * field.radius, 2 * field.radius);
+            fillZone(i, count, &field);
+            snapshot->append(field);
+        }
+    }
+
+    m_snapshot = snapshot;
+}
+
+void NoiseFieldLayer::invalidateAll()
+{
+    rebuildSnapshot();
+    for (Tile &tile : m_tiles) {
+        tile.valid = false;
+        if (tile.pending) tile.invalidatedWhilePending = true;
+    }
+    requestVisibleTiles();
+    update();
+}
+
+void NoiseFieldLayer::invalidateRects(const QVector<QRectF> &rects)
+{
+    if (rects.isEmpty()) return;
+
+    for (auto it = m_tiles.begin(); it != m_tiles.end(); ++it) {
+        int z = int(it.key() >> 58);
+        int x = int((it.key() >> 29) & 0x1FFFFFFF);
+        int y = int(it.key() & 0x1FFFFFFF);
+        QRectF tile = tileBounds(z, x, y);
+
+        // Зона у шва на 180-м меридиане может задеть тайлы с другого края
+        bool hit = false;
+        for (int i = 0; i < rects.size() && !hit; i++) {
+            for (int shift = -1; shift <= 1 && !hit; shift++) {
+                hit = tile.intersects(rects[i].translated(shift, 0));
+            }
+        }
+        if (hit) {
+            it->valid = false;
+            if (it->pending) it->invalidatedWhilePending = true;
+        }
+    }
+    requestVisibleTiles();
+    update();
+}
+
+quint64 NoiseFieldLayer::tileKey(int z, int x, int y)
+{
+    return (quint64(z) << 58) | (quint64(x) << 29) | quint64(y);
+}
+
+QRectF NoiseFieldLayer::tileBounds(int z, int x, int y)
+{
+    double size = std::ldexp(1.0, -z);
+    return QRectF(x * size, y * size, size, size);
+}
+
+int NoiseFieldLayer::tileZoom() const
+{
+    return qBound(0, int(std::floor(zoomLevel())), kMaxZoom);
+}
+
+bool NoiseFieldLayer::renderTile(const FieldSnapshot &zones, int z, int x, int y, QImage *image)
+{
+    const QRectF bounds = tileBounds(z, x, y);
+    const double scale = std::ldexp(double(kTilePixels), z);
+
+    QPainter painter;
+    for (const FieldZone &zone : zones) {
+        for (int shift = -1; shift <= 1; shift++) {
+            if (!bounds.intersects(zone.bounds.translated(shift, 0))) continue;
+
+            // Изображение создается только если в тайл что-то попало
+            if (!painter.isActive()) {
+                *image = QImage(kTilePixels, kTilePixels, QImage::Format_ARGB32_Premultiplied);
+                image->fill(Qt::transparent);
+                painter.begin(image);
+                painter.setRenderHint(QPainter::Antialiasing);
+            }
+
+            QPointF center((zone.center.x() + shift) * scale - x * kTilePixels,
+                           zone.center.y() * scale - y * kTilePixels);
+            double radius = zone.radius * scale;
+
+            painter.setOpacity(zone.opacity);
+            painter.setPen(QPen(zone.border, 1));
+            painter.setBrush(zone.fill);
+            painter.drawEllipse(center, radius, radius);
+        }
+    }
+
+    if (!painter.isActive()) return false;
+    painter.end();
+    return true;
+}
+
+void NoiseFieldLayer::onViewportChanged()
+{
+    requestVisibleTiles();
+    update();
+}
+
+void NoiseFieldLayer::requestVisibleTiles()
+{
+    if (width() <= 0 || height() <= 0 || m_snapshot->isEmpty()) return;
+
+    const int z = tileZoom();
+    const int tiles = 1 << z;
+    const double tileSize = kTilePixels * std::pow(2.0, zoomLevel() - z);
+
+    double cx = centerMercator().x() * tiles;
+    double cy = centerMercator().y() * tiles;
+    int x0 = int(std::floor(cx - width() / 2 / tileSize));
+    int x1 = int(std::floor(cx + width() / 2 / tileSize));
+    int y0 = qMax(0, int(std::floor(cy - height() / 2 / tileSize)));
+    int y1 = qMin(tiles - 1, int(std::floor(cy + height() / 2 / tileSize)));
+    x1 = qMin(x1, x0 + tiles - 1);
+
+    m_frame++;
+    int started = 0;
+
+    for (int y = y0; y <= y1; y++) {
+        for (int ux = x0; ux <= x1; ux++) {
+            int x = ((ux % tiles) + tiles) % tiles;
+            Tile &tile = m_tiles[tileKey(z, x, y)];
+            tile.lastUsed = m_frame;
+
+            if (tile.valid || tile.pending) continue;
+
+            tile.pending = true;
+            tile.invalidatedWhilePending = false;
+            m_pool.start(new TileJob(this, m_snapshot, z, x, y));
+            started++;
+        }
+    }
+
+    if (started > 0) {
+        m_pendingCount += started;
+        emit pendingTilesChanged();
+    }
+
+    evictTiles();
+}
+
+void NoiseFieldLayer::onTileRendered(quint64 key, const QImage &image, bool empty)
+{
+    m_pendingCount--;
+    emit pendingTilesChanged();
+
+    auto it = m_tiles.find(key);
+    if (it == m_tiles.end()) return;
+
+    it->pending = false;
+    it->image = image;
+    it->empty = empty;
+    it->serial = ++m_serial;
+    // Если зоны поменялись во время рисования, тайл уже устарел: изображение
+    // показываем, пока не готово новое, и сразу заказываем перерисовку
+    it->valid = !it->invalidatedWhilePending;
+    it->invalidatedWhilePending = false;
+
+    if (!it->valid) {
+        requestVisibleTiles();
+    }
+    update();
+}
+
+void NoiseFieldLayer::evictTiles()
+{
+    if (m_tiles.size() <= kMaxCachedTiles) return;
+
+    // Давно не видимые тайлы уходят первыми, рисуемые сейчас не трогаем
+    QVector<QPair<quint64, quint64>> candidates;
+    for (auto it = m_tiles.constBegin(); it != m_tiles.constEnd(); ++it) {
+        if (!it->pending && it->lastUsed != m_frame) {
+            candidates.append(qMakePair(it->lastUsed, it.key()));
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    int excess = m_tiles.size() - kMaxCachedTiles;
+    for (int i = 0; i < excess && i < candidates.size(); i++) {
+        m_tiles.remove(candidates[i].second);
+    }
+}
+
+QSGNode *NoiseFieldLayer::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data)
+{
+    Q_UNUSED(data)
+
+    FieldNode *root = static_cast<FieldNode *>(oldNode);
+    if (!root) {
+        root = new FieldNode;
+    }
+
+    for (auto it = root->textures.begin(); it != root->textures.end(); ++it) {
+        it->used = false;
+    }
+    root->usedNodes = 0;
+
+    if (width() > 0 && height() > 0 && !m_snapshot->isEmpty()) {
+        const int z = tileZoom();
+        const int tiles = 1 << z;
+        const double tileSize = kTilePixels * std::pow(2.0, zoomLevel() - z);
+
+        double cx = centerMercator().x() * tiles;
+        double cy = centerMercator().y() * tiles;
+        int x0 = int(std::floor(cx - width() / 2 / tileSize));
+        int x1 = qMin(int(std::floor(cx + width() / 2 / tileSize)), x0 + tiles - 1);
+        int y0 = qMax(0, int(std::floor(cy - height() / 2 / tileSize)));
+        int y1 = qMin(tiles - 1, int(std::floor(cy + height() / 2 / tileSize)));
+
+        for (int y = y0; y <= y1; y++) {
+            for (int ux = x0; ux <= x1; ux++) {
+                int x = ((ux % tiles) + tiles) % tiles;
+
+                // Нужный тайл, а пока его нет - ближайший готовый родитель
+                const Tile *source = nullptr;
+                quint64 sourceKey = 0;
+                int level = 0;
+                for (; level <= kFallbackLevels && level <= z; level++) {
+                    quint64 key = tileKey(z - level, x >> level, y >> level);
+                    auto it = m_tiles.constFind(key);
+                    if (it != m_tiles.constEnd() && it->serial > 0) {
+                        source = &it.value();
+                        sourceKey = key;
+                        break;
+                    }
+                }
+                if (!source || source->empty) continue;
+
+                auto texture = root->textures.find(sourceKey);
+                if (texture == root->textures.end() || texture->serial != source->serial) {
+                    if (texture != root->textures.end()) {
+                        delete texture->texture;
+                    }
+                    FieldNode::Texture entry;
+                    entry.texture = window()->createTextureFromImage(source->image);
+                    entry.serial = source->serial;
+                    entry.used = false;
+                    texture = root->textures.insert(sourceKey, entry);
+                }
+                texture->used = true;
+
+                if (root->usedNodes == root->tileNodes.size()) {
+                    QSGSimpleTextureNode *node = new QSGSimpleTextureNode;
+                    node->setOwnsTexture(false);
+                    root->tileNodes.append(node);
+                }
+                QSGSimpleTextureNode *node = root->tileNodes[root->usedNodes++];
+                if (!node->parent()) {
+                    root->appendChildNode(node);
+                }
+
+                // Часть родительского тайла, которая приходится на этот тайл
+                int part = 1 << level;
+                double sourceSize = double(kTilePixels) / part;
+                node->setTexture(texture->texture);
+                node->setSourceRect(QRectF((x % part) * sourceSize, (y % part) * sourceSize,
+                                           sourceSize, sourceSize));
+                node->setRect(QRectF(width() / 2 + (ux - cx) * tileSize,
+                                     height() / 2 + (y - cy) * tileSize, tileSize, tileSize));
+            }
+        }
+    }
+
+    // Лишние узлы и неиспользуемые текстуры освобождаем
+    while (root->tileNodes.size() > root->usedNodes) {
+        QSGSimpleTextureNode *node = root->tileNodes.takeLast();
+        if (node->parent()) root->removeChildNode(node);
+        delete node;
+    }
+    for (auto it = root->textures.begin(); it != root->textures.end();) {
+        if (!it->used) {
+            delete it->texture;
+            it = root->textures.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    return root;
+}
@@ -0,0 +1,113 @@
+#ifndef NOISE_FIELD_LAYER_H
+#define NOISE_FIELD_LAYER_H
+
+#include "map_overlay_item.h"
+
+#include <QColor>
+#include <QHash>
+#include <QImage>
+#include <QPointer>
+#include <QRectF>
+#include <QSharedPointer>
+#include <QThreadPool>
+#include <QVector>
+
+class ZoneIndex;
+class ZoneAppearance;
+
+// Зоны шума одним слоем вместо MapCircle на каждую зону. Круги зон растеризуются
+// в тайлы 256x256 по целым уровням zoom (Web Mercator) в пуле рабочих потоков,
+// готовые тайлы кэшируются. Сдвиг и масштаб карты только переставляют текстуры,
+// тайлы перерисовываются лишь при смене зон или их вида. Цвет и прозрачность
+// берутся из ZoneAppearance: за кадр приходит одна пачка изменившихся зон,
+// и тайлы под ними помечаются одним проходом
+class NoiseFieldLayer : public MapOverlayItem
+{
+    Q_OBJECT
+    Q_PROPERTY(QObject *zones READ zones WRITE setZones NOTIFY zonesChanged)
+    Q_PROPERTY(QObject *appearance READ appearance WRITE setAppearance NOTIFY appearanceChanged)
+    Q_PROPERTY(int pendingTiles READ pendingTiles NOTIFY pendingTilesChanged)
+
+public:
+    static const int kTilePixels;
+    static const int kMaxZoom;
+    static const int kMaxCachedTiles;
+
+    explicit NoiseFieldLayer(QQuickItem *parent = nullptr);
+    ~NoiseFieldLayer() override;
+
+    // Источник зон - ZoneIndex, перестроение индекса сбрасывает все тайлы
+    QObject *zones() const;
+    void setZones(QObject *zones);
+
+    // Вид зон - ZoneAppearance. Без него зоны рисуются цветом из конфигурации
+    QObject *appearance() const;
+    void setAppearance(QObject *appearance);
+
+    int pendingTiles() const { return m_pendingCount; }
+
+signals:
+    void zonesChanged();
+    void appearanceChanged();
+    void pendingTilesChanged();
+
+protected:
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+    void onViewportChanged() override;
+
+private:
+    // Круг зоны в нормированных координатах Меркатора
+    struct FieldZone {
+        QPointF center;
+        double radius;
+        QRectF bounds;
+        QColor fill;
+        QColor border;
+        double opacity;
+    };
+    typedef QVector<FieldZone> FieldSnapshot;
+
+    struct Tile {
+        QImage image;
+        bool empty;            // в тайл не попадает ни одна зона
+        bool valid;            // изображение соответствует текущим зонам
+        bool pending;          // тайл сейчас рисуется в пуле
+        bool invalidatedWhilePending;
+        quint64 serial;        // меняется при каждом новом изображении
+        quint64 lastUsed;
+
+        Tile() : empty(false), valid(false), pending(false), invalidatedWhilePending(false),
+                 serial(0), lastUsed(0) {}
+    };
+
+    class TileJob;
+    friend class TileJob;
+
+    static quint64 tileKey(int z, int x, int y);
+    static bool renderTile(const FieldSnapshot &zones, int z, int x, int y, QImage *image);
+    static QRectF tileBounds(int z, int x, int y);
+
+    int tileZoom() const;
+    void rebuildSnapshot();
+    void invalidateAll();
+    void invalidateRects(const QVector<QRectF> &rects);
+    void onZonesUpdated(const QVector<int> &indices);
+    void onAppearanceChanged(const QVector<int> &indices);
+    void fillZone(int index, int count, FieldZone *field) const;
+    void requestVisibleTiles();
+    void onTileRendered(quint64 key, const QImage &image, bool empty);
+    void evictTiles();
+
+    QPointer<ZoneIndex> m_zones;
+    QPointer<ZoneAppearance> m_appearance;
+
+    QSharedPointer<const FieldSnapshot> m_snapshot;
+    QHash<quint64, Tile> m_tiles;
+    quint64 m_frame;
+    quint64 m_serial;
+    int m_pendingCount;
+
+    QThreadPool m_pool;
+};
+
+#endif // NOISE_FIELD_LAYER_H
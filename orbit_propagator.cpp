@@ -0,0 +1,219 @@
+#include "orbit_propagator.h"
+
+#include <QtMath>
+#include <cmath>
+
+const double OrbitPropagator::kEarthRadiusKm = 6371.0;
+const double OrbitPropagator::kEarthMu = 398600.4418;
+const double OrbitPropagator::kEarthRotationRate = 7.2921159e-5;
+
+namespace {
+const double kTwoPi = 2.0 * M_PI;
+
+double wrapAngle(double angle)
+{
+    angle = std::fmod(angle, kTwoPi);
+    if (angle < 0) angle += kTwoPi;
+    return angle;
+}
+
+double wrapLongitudeDeg(double lng)
+{
+    lng = std::fmod(lng + 180.0, 360.0);
+    if (lng < 0) lng += 360.0;
+    return lng - 180.0;
+}
+}
+
+OrbitalElements OrbitalElements::circular(double altitudeKm, double inclination,
+                                          double raan, double meanAnomaly)
+{
+    OrbitalElements e;
+    e.semiMajorAxisKm = OrbitPropagator::kEarthRadiusKm + altitudeKm;
+    e.eccentricity = 0;
+    e.inclination = inclination;
+    e.raan = raan;
+    e.argumentOfPerigee = 0;
+    e.meanAnomaly = meanAnomaly;
+    return e;
+}
+
+OrbitalElements OrbitalElements::polar(double altitudeKm, double raan, double meanAnomaly)
+{
+    return circular(altitudeKm, M_PI / 2, raan, meanAnomaly);
+}
+
+OrbitalElements OrbitalElements::geostationary(double longitudeDeg, double inclination)
+{
+    // Радиус, на котором период обращения равен звездным суткам
+    double a = std::cbrt(OrbitPropagator::kEarthMu /
+                         (OrbitPropagator::kEarthRotationRate * OrbitPropagator::kEarthRotationRate));
+
+    OrbitalElements e;
+    e.semiMajorAxisKm = a;
+    e.inclination = inclination;
+    e.raan = qDegreesToRadians(longitudeDeg);
+    return e;
+}
+
+OrbitalElements OrbitalElements::molniya(double inclination, double raan, double meanAnomaly)
+{
+    // Период ~12 ч, апогей над северным полушарием
+    OrbitalElements e;
+    e.semiMajorAxisKm = 26600;
+    e.eccentricity = 0.74;
+    e.inclination = inclination;
+    e.raan = raan;
+    e.argumentOfPerigee = qDegreesToRadians(270.0);
+    e.meanAnomaly = meanAnomaly;
+    return e;
+}
+
+double OrbitalElements::periodSeconds() const
+{
+    return 2 * M_PI * std::sqrt(std::pow(semiMajorAxisKm, 3) / OrbitPropagator::kEarthMu);
+}
+
+OrbitPropagator::OrbitPropagator()
+{
+}
+
+int OrbitPropagator::add(const OrbitalElements &elements)
+{
+    double a = elements.semiMajorAxisKm;
+    double e = qBound(0.0, elements.eccentricity, 0.99);
+
+    m_semiMajorAxis.append(a);
+    m_eccentricity.append(e);
+    m_meanAnomaly.append(elements.meanAnomaly);
+    m_meanMotion.append(std::sqrt(kEarthMu / (a * a * a)));
+    m_sinInclination.append(std::sin(elements.inclination));
+    m_cosInclination.append(std::cos(elements.inclination));
+    m_raan.append(elements.raan);
+    m_argumentOfPerigee.append(elements.argumentOfPerigee);
+    m_semiMinorFactor.append(std::sqrt(1 - e * e));
+
+    return m_semiMajorAxis.size() - 1;
+}
+
+void OrbitPropagator::clear()
+{
+    m_semiMajorAxis.clear();
+    m_eccentricity.clear();
+    m_meanAnomaly.clear();
+    m_meanMotion.clear();
+    m_sinInclination.clear();
+    m_cosInclination.clear();
+    m_raan.clear();
+    m_argumentOfPerigee.clear();
+    m_semiMinorFactor.clear();
+}
+
+OrbitalElements OrbitPropagator::elements(int index) const
+{
+    OrbitalElements e;
+    e.semiMajorAxisKm = m_semiMajorAxis[index];
+    e.eccentricity = m_eccentricity[index];
+    e.inclination = std::atan2(m_sinInclination[index], m_cosInclination[index]);
+    e.raan = m_raan[index];
+    e.argumentOfPerigee = m_argumentOfPerigee[index];
+    e.meanAnomaly = m_meanAnomaly[index];
+    return e;
+}
+
+double OrbitPropagator::solveKepler(double meanAnomaly, double eccentricity)
+{
+    double m = wrapAngle(meanAnomaly);
+    if (eccentricity < 1e-9) return m;
+
+    // Для больших эксцентриситетов старт с π сходится надежнее
+    double E = eccentricity < 0.8 ? m : M_PI;
+    for (int i = 0; i < 12; i++) {
+        double f = E - eccentricity * std::sin(E) - m;
+        double delta = f / (1 - eccentricity * std::cos(E));
+        E -= delta;
+        if (std::fabs(delta) < 1e-12) break;
+    }
+    return E;
+}
+
+void OrbitPropagator::propagate(double time, double *latitudes, double *longitudes,
+                                double *altitudesKm) const
+{
+    propagate(time, 0, m_semiMajorAxis.size(), latitudes, longitudes, altitudesKm);
+}
+
+void OrbitPropagator::propagate(double time, int begin, int end, double *latitudes, double *longitudes,
+                                double *altitudesKm) const
+{
+    const double earthAngle = kEarthRotationRate * time;
+
+    const double *a = m_semiMajorAxis.constData();
+    const double *ecc = m_eccentricity.constData();
+    const double *m0 = m_meanAnomaly.constData();
+    const double *n = m_meanMotion.constData();
+    const double *si = m_sinInclination.constData();
+    const double *ci = m_cosInclination.constData();
+    const double *raan = m_raan.constData();
+    const double *argp = m_argumentOfPerigee.constData();
+    const double *b = m_semiMinorFactor.constData();
+
+    for (int k = begin; k < end; k++) {
+        double E = solveKepler(m0[k] + n[k] * time, ecc[k]);
+        double cosE = std::cos(E);
+        double sinE = std::sin(E);
+
+        // Истинная аномалия и радиус в плоскости орбиты
+        double nu = std::atan2(b[k] * sinE, cosE - ecc[k]);
+        double r = a[k] * (1 - ecc[k] * cosE);
+
+        // Аргумент широты и переход к географическим координатам
+        double u = argp[k] + nu;
+        double sinU = std::sin(u);
+        double cosU = std::cos(u);
+
+        double lat = std::asin(qBound(-1.0, sinU * si[k], 1.0));
+        double lng = raan[k] + std::atan2(sinU * ci[k], cosU) - earthAngle;
+
+        latitudes[k] = qRadiansToDegrees(lat);
+        longitudes[k] = wrapLongitudeDeg(qRadiansToDegrees(lng));
+        if (altitudesKm) altitudesKm[k] = r - kEarthRadiusKm;
+    }
+}
+
+void OrbitPropagator::propagateOne(int index, double time, double *latitude, double *longitude,
+                                   double *altitudeKm) const
+{
+    double E = solveKepler(m_meanAnomaly[index] + m_meanMotion[index] * time, m_eccentricity[index]);
+    double cosE = std::cos(E);
+    double sinE = std::sin(E);
+    double nu = std::atan2(m_semiMinorFactor[index] * sinE, cosE - m_eccentricity[index]);
+    double u = m_argumentOfPerigee[index] + nu;
+
+    double lat = std::asin(qBound(-1.0, std::sin(u) * m_sinInclination[index], 1.0));
+    double lng = m_raan[index] + std::atan2(std::sin(u) * m_cosInclination[index], std::cos(u))
+                 - kEarthRotationRate * time;
+
+    *latitude = qRadiansToDegrees(lat);
+    *longitude = wrapLongitudeDeg(qRadiansToDegrees(lng));
+    if (altitudeKm) {
+        *altitudeKm = m_semiMajorAxis[index] * (1 - m_eccentricity[index] * cosE) - kEarthRadiusKm;
+    }
+}
+
+QVector<QPair<double, double>> OrbitPropagator::groundTrack(int index, double time, int samples) const
+{
+    QVector<QPair<double, double>> track;
+    if (index < 0 || index >= size() || samples < 2) {
+        return track;
+    }
+
+    double period = 2 * M_PI / m_meanMotion[index];
+    track.reserve(samples);
+    for (int i = 0; i < samples; i++) {
+        double lat, lng;
+        propagateOne(index, time + period * i / (samples - 1), &lat, &lng, nullptr);
+        track.append(qMakePair(lat, lng));
+    }
+    return track;
+}
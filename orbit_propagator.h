@@ -0,0 +1,79 @@
+#ifndef ORBIT_PROPAGATOR_H
+#define ORBIT_PROPAGATOR_H
+
+#include <QVector>
+#include <QPair>
+
+// Кеплеровы элементы орбиты. Углы в радианах, время в секундах модельного времени
+struct OrbitalElements {
+    double semiMajorAxisKm;   // большая полуось
+    double eccentricity;      // эксцентриситет
+    double inclination;       // наклонение
+    double raan;              // долгота восходящего узла (в момент t = 0)
+    double argumentOfPerigee; // аргумент перигея
+    double meanAnomaly;       // средняя аномалия в момент t = 0
+
+    OrbitalElements()
+        : semiMajorAxisKm(7171), eccentricity(0), inclination(0),
+          raan(0), argumentOfPerigee(0), meanAnomaly(0) {}
+
+    // Типовые орбиты, которые раньше строились массивами точек в map.qml
+    static OrbitalElements circular(double altitudeKm, double inclination,
+                                    double raan, double meanAnomaly = 0);
+    static OrbitalElements polar(double altitudeKm, double raan, double meanAnomaly = 0);
+    static OrbitalElements geostationary(double longitudeDeg, double inclination = 0);
+    static OrbitalElements molniya(double inclination, double raan, double meanAnomaly = 0);
+
+    double periodSeconds() const;
+};
+
+// Аналитическое распространение орбит: положение каждого спутника вычисляется
+// для произвольного момента времени без заранее построенной траектории.
+// Элементы хранятся массивами, расчет идет одним проходом по всем спутникам
+class OrbitPropagator
+{
+public:
+    static const double kEarthRadiusKm;
+    static const double kEarthMu;             // км³/с²
+    static const double kEarthRotationRate;   // рад/с
+
+    OrbitPropagator();
+
+    int add(const OrbitalElements &elements);
+    void clear();
+    int size() const { return m_semiMajorAxis.size(); }
+
+    OrbitalElements elements(int index) const;
+
+    // Подспутниковые точки всех спутников на момент time (секунды от начала симуляции).
+    // Выходные массивы должны вмещать size() элементов
+    void propagate(double time, double *latitudes, double *longitudes, double *altitudesKm) const;
+    // То же для спутников [begin, end), выходные массивы индексируются номером спутника.
+    // Разные диапазоны можно считать параллельно
+    void propagate(double time, int begin, int end, double *latitudes, double *longitudes,
+                   double *altitudesKm) const;
+
+    // Подспутниковая точка одного спутника
+    void propagateOne(int index, double time, double *latitude, double *longitude,
+                      double *altitudeKm) const;
+
+    // Трасса спутника (широта, долгота) за один виток начиная с момента time
+    QVector<QPair<double, double>> groundTrack(int index, double time, int samples) const;
+
+    // Решение уравнения Кеплера M = E - e·sin(E) методом Ньютона
+    static double solveKepler(double meanAnomaly, double eccentricity);
+
+private:
+    // Элементы (структура массивов) и производные величины, которые не зависят от времени
+    QVector<double> m_semiMajorAxis;
+    QVector<double> m_eccentricity;
+    QVector<double> m_meanAnomaly;
+    QVector<double> m_meanMotion;     // рад/с
+    QVector<double> m_sinInclination;
+    QVector<double> m_cosInclination;
+    QVector<double> m_raan;
+    QVector<double> m_argumentOfPerigee;
+    QVector<double> m_semiMinorFactor; // √(1 - e²)
+};
+
+#endif // ORBIT_PROPAGATOR_H
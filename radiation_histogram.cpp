@@ -0,0 +1,56 @@
+#include "radiation_histogram.h"
+
+#include <QtMath>
+
+const double RadiationHistogram::kMinLevel = -110;
+const double RadiationHistogram::kMaxLevel = -40;
+const double RadiationHistogram::kBinWidth = 2.5;
+
+RadiationHistogram::RadiationHistogram()
+    : m_counts(qRound((kMaxLevel - kMinLevel) / kBinWidth) + 2, 0)
+    , m_total(0)
+    , m_maxCount(0)
+{
+}
+
+void RadiationHistogram::clear()
+{
+    m_counts.fill(0);
+    m_total = 0;
+    m_maxCount = 0;
+}
+
+void RadiationHistogram::add(double value)
+{
+    int &bin = m_counts[binFor(value)];
+    bin++;
+    m_total++;
+    m_maxCount = qMax(m_maxCount, bin);
+}
+
+void RadiationHistogram::add(const RadiationHistogram &other)
+{
+    for (int i = 0; i < m_counts.size(); i++) {
+        m_counts[i] += other.m_counts[i];
+        m_maxCount = qMax(m_maxCount, m_counts[i]);
+    }
+    m_total += other.m_total;
+}
+
+int RadiationHistogram::binFor(double value) const
+{
+    // Корзина i шкалы - (kMinLevel + (i - 1) * kBinWidth, kMinLevel + i * kBinWidth]
+    if (qIsNaN(value) || value <= kMinLevel) return 0;
+    if (value > kMaxLevel) return m_counts.size() - 1;
+    return qBound(1, int(qCeil((value - kMinLevel) / kBinWidth)), m_counts.size() - 2);
+}
+
+double RadiationHistogram::binLower(int bin) const
+{
+    return kMinLevel + (qBound(1, bin, m_counts.size() - 1) - 1) * kBinWidth;
+}
+
+double RadiationHistogram::binUpper(int bin) const
+{
+    return kMinLevel + qBound(0, bin, m_counts.size() - 2) * kBinWidth;
+}
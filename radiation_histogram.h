@@ -0,0 +1,43 @@
+#ifndef RADIATION_HISTOGRAM_H
+#define RADIATION_HISTOGRAM_H
+
+#include <QVector>
+#include <QtGlobal>
+
+// Распределение уровня излучения по корзинам фиксированной ширины в дБм
+// (шкала дБм уже логарифмическая по мощности). Границы полос легенды
+// map.qml::noiseLevels (-60, -65 ... -90) кратны ширине корзины и совпадают
+// с границами корзин, корзина (нижняя, верхняя] относится к одной полосе
+// ZoneAppearance::bandFor. Значения вне шкалы собираются в крайние корзины.
+// Измерение добавляется за O(1), размер не зависит от числа измерений
+class RadiationHistogram
+{
+public:
+    static const double kMinLevel;
+    static const double kMaxLevel;
+    static const double kBinWidth;
+
+    RadiationHistogram();
+
+    void clear();
+    void add(double value);
+    void add(const RadiationHistogram &other);
+
+    // Корзины шкалы и две крайние: 0 - не выше kMinLevel, последняя - выше kMaxLevel
+    int binCount() const { return m_counts.size(); }
+    int binFor(double value) const;
+    double binLower(int bin) const;
+    double binUpper(int bin) const;
+
+    int count(int bin) const { return m_counts[bin]; }
+    int total() const { return m_total; }
+    int maxCount() const { return m_maxCount; }
+    bool isEmpty() const { return m_total == 0; }
+
+private:
+    QVector<int> m_counts;
+    int m_total;
+    int m_maxCount;   // самая полная корзина - масштаб столбцов
+};
+
+#endif // RADIATION_HISTOGRAM_H
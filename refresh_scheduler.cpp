@@ -0,0 +1,74 @@
+#include "refresh_scheduler.h"
+
+const int RefreshScheduler::kDefaultRate = 30;
+
+RefreshScheduler::RefreshScheduler(QObject *parent)
+    : QObject(parent)
+    , m_rate(0)
+    , m_paused(false)
+{
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, &RefreshScheduler::onTimeout);
+    setRate(kDefaultRate);
+}
+
+void RefreshScheduler::setRate(int rate)
+{
+    m_rate = qBound(1, rate, 60);
+    m_timer.setInterval(1000 / m_rate);
+}
+
+void RefreshScheduler::setPaused(bool paused)
+{
+    if (m_paused == paused) return;
+    m_paused = paused;
+
+    if (m_paused) {
+        m_timer.stop();
+    } else if (!m_pending.isEmpty()) {
+        // Накопленное за паузу уходит одной пачкой сразу после возобновления
+        flush();
+    }
+}
+
+void RefreshScheduler::request(const QString &key)
+{
+    m_counters.requests++;
+    if (m_paused) {
+        m_counters.deferred++;
+    }
+
+    if (m_pending.contains(key)) {
+        m_counters.coalesced++;
+        return;
+    }
+    m_pending.insert(key);
+
+    // Первый запрос после обновления запускает таймер, остальные к нему присоединяются
+    if (!m_paused && !m_timer.isActive()) {
+        m_timer.start();
+    }
+}
+
+void RefreshScheduler::flush()
+{
+    m_timer.stop();
+    if (m_pending.isEmpty()) return;
+
+    const QStringList keys = m_pending.values();
+    m_pending.clear();
+    m_counters.refreshes++;
+    emit refreshDue(keys);
+}
+
+void RefreshScheduler::clear()
+{
+    m_timer.stop();
+    m_pending.clear();
+}
+
+void RefreshScheduler::onTimeout()
+{
+    if (m_paused) return;
+    flush();
+}
@@ -0,0 +1,60 @@
+#ifndef REFRESH_SCHEDULER_H
+#define REFRESH_SCHEDULER_H
+
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+// Объединение уведомлений об обновлении по ключам (именам спутников).
+// Запрос только помечает ключ, и не чаще rate раз в секунду подписчик получает
+// одним сигналом все помеченные ключи. Пока планировщик приостановлен (окно
+// скрыто или свернуто), ключи копятся и уходят одной пачкой после возобновления.
+// Счетчики показывают, сколько запросов слилось с уже ожидающими
+class RefreshScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int kDefaultRate;
+
+    struct Counters {
+        quint64 requests;    // всего запросов
+        quint64 coalesced;   // запросов по ключу, который уже ожидал обновления
+        quint64 deferred;    // запросов, пришедших во время паузы
+        quint64 refreshes;   // отправленных пачек
+
+        Counters() : requests(0), coalesced(0), deferred(0), refreshes(0) {}
+    };
+
+    explicit RefreshScheduler(QObject *parent = nullptr);
+
+    // Обновлений в секунду, не больше частоты кадров экрана
+    int rate() const { return m_rate; }
+    void setRate(int rate);
+
+    bool isPaused() const { return m_paused; }
+    void setPaused(bool paused);
+
+    void request(const QString &key);
+    // Отправить ожидающие ключи сразу, не дожидаясь таймера
+    void flush();
+    void clear();
+
+    const Counters &counters() const { return m_counters; }
+
+signals:
+    void refreshDue(const QStringList &keys);
+
+private:
+    void onTimeout();
+
+    QTimer m_timer;
+    QSet<QString> m_pending;
+    int m_rate;
+    bool m_paused;
+    Counters m_counters;
+};
+
+#endif // REFRESH_SCHEDULER_H
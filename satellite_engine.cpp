@@ -0,0 +1,339 @@
+#include "satellite_engine.h"
+#include "simulation_clock.h"
+#include "tick_pool.h"
+
+#include <QDebug>
+#include <QtMath>
+
+namespace {
+// Секунды модельного времени между точками следа по высоте орбиты. Значения
+// соответствуют прежним интервалам Satellite.qml::updateMovementSpeed
+double trailPeriod(double altitudeKm)
+{
+    if (altitudeKm <= 1000) return 15;
+    if (altitudeKm <= 20000) return 38;
+    return 86;
+}
+}
+
+const int SatelliteEngine::kBlockSize = 256;
+
+SatelliteEngine::SatelliteEngine(QObject *parent)
+    : QAbstractListModel(parent)
+    , m_clock(nullptr)
+    , m_pool(nullptr)
+    , m_threadCount(0)
+    , m_simulationTime(0)
+{
+}
+
+SatelliteEngine::~SatelliteEngine()
+{
+    delete m_pool;
+}
+
+TickPool *SatelliteEngine::tickPool()
+{
+    // Потоки заводятся при первом шаге, а не при создании движка
+    if (!m_pool) {
+        m_pool = new TickPool(m_threadCount);
+    }
+    return m_pool;
+}
+
+void SatelliteEngine::setThreadCount(int threadCount)
+{
+    if (m_threadCount == threadCount) return;
+    m_threadCount = threadCount;
+    delete m_pool;
+    m_pool = nullptr;
+}
+
+int SatelliteEngine::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_names.size();
+}
+
+QVariant SatelliteEngine::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_names.size()) {
+        return QVariant();
+    }
+
+    int row = index.row();
+    switch (role) {
+    case Qt::DisplayRole:
+    case NameRole: return m_names[row];
+    case LatitudeRole: return m_latitudes[row];
+    case LongitudeRole: return m_longitudes[row];
+    case AltitudeRole: return m_altitudes[row];
+    case ColorRole: return m_colors[row];
+    case TrailSeqRole: return m_trailSeq[row];
+    default: return QVariant();
+    }
+}
+
+QHash<int, QByteArray> SatelliteEngine::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[NameRole] = "name";
+    roles[LatitudeRole] = "latitude";
+    roles[LongitudeRole] = "longitude";
+    roles[AltitudeRole] = "altitude";
+    roles[ColorRole] = "satelliteColor";
+    roles[TrailSeqRole] = "trailSeq";
+    return roles;
+}
+
+OrbitalElements SatelliteEngine::elementsFromMap(const QVariantMap &orbit)
+{
+    QString type = orbit.value("type", "inclined").toString();
+    double altitude = orbit.value("altitude", 800).toDouble();
+    double inclination = qDegreesToRadians(orbit.value("inclination", 45).toDouble());
+    double raan = qDegreesToRadians(orbit.value("raan", 0).toDouble());
+    double meanAnomaly = qDegreesToRadians(orbit.value("meanAnomaly", 0).toDouble());
+
+    if (type == "polar") {
+        return OrbitalElements::polar(altitude, raan, meanAnomaly);
+    }
+    if (type == "geostationary") {
+        return OrbitalElements::geostationary(orbit.value("longitude", 0).toDouble(),
+                                              qDegreesToRadians(orbit.value("inclination", 0).toDouble()));
+    }
+    if (type == "molniya") {
+        return OrbitalElements::molniya(inclination, raan, meanAnomaly);
+    }
+    return OrbitalElements::circular(altitude, inclination, raan, meanAnomaly);
+}
+
+int SatelliteEngine::addSatellite(const QString &name, const QVariantMap &orbit, const QColor &color)
+{
+    return addSatellite(name, elementsFromMap(orbit), color);
+}
+
+int SatelliteEngine::addSatellite(const QString &name, const OrbitalElements &elements,
+                                  const QColor &color)
+{
+    int index = m_names.size();
+    beginInsertRows(QModelIndex(), index, index);
+    appendSatellite(name, elements, color);
+    endInsertRows();
+    emit countChanged();
+
+    qDebug() << "SatelliteEngine: добавлен спутник" << name
+             << "период:" << elements.periodSeconds() / 60 << "мин";
+    return index;
+}
+
+int SatelliteEngine::addConstellation(const QString &prefix, const QVariantMap &params,
+                                      const QColor &color)
+{
+    const int total = params.value("count", 100).toInt();
+    if (total <= 0) return -1;
+
+    const int planes = qBound(1, params.value("planes", 10).toInt(), total);
+    const int phasing = params.value("phasing", 1).toInt();
+    const double altitude = params.value("altitude", 550).toDouble();
+    const double inclination = qDegreesToRadians(params.value("inclination", 53).toDouble());
+    const int perPlane = (total + planes - 1) / planes;
+
+    int first = m_names.size();
+    beginInsertRows(QModelIndex(), first, first + total - 1);
+    for (int i = 0; i < total; i++) {
+        int plane = i / perPlane;
+        int slot = i % perPlane;
+        double raan = 2 * M_PI * plane / planes;
+        double meanAnomaly = 2 * M_PI * slot / perPlane + 2 * M_PI * phasing * plane / total;
+        appendSatellite(QString("%1-%2").arg(prefix).arg(i + 1),
+                        OrbitalElements::circular(altitude, inclination, raan, meanAnomaly), color);
+    }
+    endInsertRows();
+    emit countChanged();
+
+    qDebug() << "SatelliteEngine: добавлена группировка" << prefix << "-" << total
+             << "спутников в" << planes << "плоскостях";
+    return first;
+}
+
+void SatelliteEngine::appendSatellite(const QString &name, const OrbitalElements &elements,
+                                      const QColor &color)
+{
+    int index = m_names.size();
+    m_orbits.add(elements);
+
+    double lat, lng, alt;
+    m_orbits.propagateOne(index, m_simulationTime, &lat, &lng, &alt);
+
+    m_names.append(name);
+    m_colors.append(color);
+    m_altitudes.append(alt);
+    m_latitudes.append(lat);
+    m_longitudes.append(lng);
+    m_trailPeriods.append(trailPeriod(elements.semiMajorAxisKm - OrbitPropagator::kEarthRadiusKm));
+    m_trailClock.append(0);
+    m_trailSeq.append(0);
+}
+
+void SatelliteEngine::clear()
+{
+    if (m_names.isEmpty()) return;
+
+    beginResetModel();
+    m_orbits.clear();
+    m_names.clear();
+    m_colors.clear();
+    m_altitudes.clear();
+    m_latitudes.clear();
+    m_longitudes.clear();
+    m_trailPeriods.clear();
+    m_trailClock.clear();
+    m_trailSeq.clear();
+    endResetModel();
+
+    emit countChanged();
+}
+
+int SatelliteEngine::indexOf(const QString &name) const
+{
+    return m_names.indexOf(name);
+}
+
+QStringList SatelliteEngine::names() const
+{
+    return QStringList(m_names.toList());
+}
+
+QGeoCoordinate SatelliteEngine::position(int index) const
+{
+    if (index < 0 || index >= m_names.size()) {
+        return QGeoCoordinate();
+    }
+    return QGeoCoordinate(m_latitudes[index], m_longitudes[index], m_altitudes[index] * 1000);
+}
+
+QVariantList SatelliteEngine::positions() const
+{
+    QVariantList result;
+    result.reserve(m_names.size());
+    for (int i = 0; i < m_names.size(); i++) {
+        result.append(QVariant::fromValue(QGeoCoordinate(m_latitudes[i], m_longitudes[i],
+                                                         m_altitudes[i] * 1000)));
+    }
+    return result;
+}
+
+QVariantList SatelliteEngine::groundTrack(int index, int samples) const
+{
+    QVariantList result;
+    const auto track = m_orbits.groundTrack(index, m_simulationTime, samples);
+    result.reserve(track.size());
+    for (const auto &point : track) {
+        result.append(QVariant::fromValue(QGeoCoordinate(point.first, point.second)));
+    }
+    return result;
+}
+
+void SatelliteEngine::setClock(SimulationClock *clock)
+{
+    if (m_clock == clock) return;
+    if (m_clock) {
+        disconnect(m_clock, nullptr, this, nullptr);
+    }
+
+    m_clock = clock;
+    if (m_clock) {
+        connect(m_clock, &SimulationClock::ticked, this, &SatelliteEngine::onTick);
+        connect(m_clock, &SimulationClock::frameAdvanced, this, &SatelliteEngine::onFrame);
+        m_simulationTime = m_clock->simulationTime();
+        updatePositions();
+    }
+}
+
+void SatelliteEngine::onTick(double time, double dt)
+{
+    m_simulationTime = time;
+
+    const int count = m_names.size();
+    if (count == 0) return;
+
+    const int blocks = (count + kBlockSize - 1) / kBlockSize;
+    m_blockTrailPoints.resize(blocks);
+
+    // Каждый блок пишет только в элементы своих спутников и в свои списки событий
+    QVector<int> *trailBlocks = m_blockTrailPoints.data();
+    double *latitudes = m_latitudes.data();
+    double *longitudes = m_longitudes.data();
+    double *altitudes = m_altitudes.data();
+
+    tickPool()->parallelFor(count, kBlockSize, [=](int begin, int end) {
+        QVector<int> &trail = trailBlocks[begin / kBlockSize];
+        trail.clear();
+
+        updateEventClocks(begin, end, dt, &trail);
+
+        // Позиции на шаге нужны только спутникам с точкой следа,
+        // для отображения они пересчитываются один раз за кадр
+        for (int index : trail) {
+            m_orbits.propagateOne(index, time, &latitudes[index], &longitudes[index], &altitudes[index]);
+        }
+    });
+
+    for (int block = 0; block < blocks; block++) {
+        m_dueTrailPoints += m_blockTrailPoints[block];
+    }
+
+    if (!m_dueTrailPoints.isEmpty()) {
+        publishEvents();
+    }
+}
+
+void SatelliteEngine::onFrame()
+{
+    updatePositions();
+
+    const int count = m_names.size();
+    if (count > 0) {
+        // Одно уведомление о позициях и счетчиках событий на кадр для всех спутников
+        emit dataChanged(index(0), index(count - 1), { LatitudeRole, LongitudeRole, AltitudeRole,
+                                                       TrailSeqRole });
+    }
+
+    emit simulationTimeChanged();
+    emit stepped();
+}
+
+void SatelliteEngine::updatePositions()
+{
+    if (m_names.isEmpty()) return;
+
+    const double time = m_simulationTime;
+    double *latitudes = m_latitudes.data();
+    double *longitudes = m_longitudes.data();
+    double *altitudes = m_altitudes.data();
+
+    tickPool()->parallelFor(m_names.size(), kBlockSize, [=](int begin, int end) {
+        m_orbits.propagate(time, begin, end, latitudes, longitudes, altitudes);
+    });
+}
+
+void SatelliteEngine::updateEventClocks(int begin, int end, double dt, QVector<int> *trail)
+{
+    for (int i = begin; i < end; i++) {
+        // При большом ускорении времени пропущенные события не накапливаются:
+        // за один шаг не больше одной точки следа на спутник
+        m_trailClock[i] += dt;
+        if (m_trailClock[i] >= m_trailPeriods[i]) {
+            m_trailClock[i] = std::fmod(m_trailClock[i], m_trailPeriods[i]);
+            m_trailSeq[i]++;
+            trail->append(i);
+        }
+    }
+}
+
+void SatelliteEngine::publishEvents()
+{
+    if (!m_dueTrailPoints.isEmpty()) {
+        emit trailPointsDue(m_dueTrailPoints);
+        m_dueTrailPoints.clear();
+    }
+}
@@ -0,0 +1,131 @@
+#ifndef SATELLITE_ENGINE_H
+#define SATELLITE_ENGINE_H
+
+#include <QAbstractListModel>
+#include <QVector>
+#include <QString>
+#include <QStringList>
+#include <QColor>
+#include <QPair>
+#include <QGeoCoordinate>
+#include <QVariantList>
+#include <QVariantMap>
+
+#include "orbit_propagator.h"
+
+class SimulationClock;
+class TickPool;
+
+// Движок движения спутников: орбиты всех спутников хранятся в OrbitPropagator,
+// положения пересчитываются аналитически на текущий момент модельного времени.
+// Время задает SimulationClock: на каждом шаге часов считаются точки следа,
+// на кадре позиции отдаются в QML как модель
+// (одно dataChanged на кадр) вместо таймера в каждом спутнике.
+// Шаг и кадр считаются блоками по kBlockSize спутников в TickPool,
+// порядок событий при этом тот же, что и при последовательном расчете.
+// Когда измерять, решает CoverageEngine по прогнозу пролетов над зонами
+class SatelliteEngine : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(double simulationTime READ simulationTime NOTIFY simulationTimeChanged)
+
+public:
+    enum Roles {
+        NameRole = Qt::UserRole + 1,
+        LatitudeRole,
+        LongitudeRole,
+        AltitudeRole,
+        ColorRole,
+        TrailSeqRole        // увеличивается, когда спутнику пора ставить точку следа
+    };
+
+    explicit SatelliteEngine(QObject *parent = nullptr);
+    ~SatelliteEngine();
+
+    // QAbstractListModel
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    // Добавление спутника из QML. orbit: { type: "polar" | "inclined" | "geostationary" |
+    // "molniya", altitude (км), inclination, raan, meanAnomaly, longitude (градусы) }
+    Q_INVOKABLE int addSatellite(const QString &name, const QVariantMap &orbit, const QColor &color);
+    // То же для C++
+    int addSatellite(const QString &name, const OrbitalElements &elements,
+                     const QColor &color = QColor(Qt::red));
+    // Группировка Уокера одним добавлением в модель. params: { count, planes,
+    // phasing, altitude (км), inclination (градусы) }. Возвращает индекс первого спутника
+    Q_INVOKABLE int addConstellation(const QString &prefix, const QVariantMap &params,
+                                     const QColor &color);
+
+    Q_INVOKABLE void clear();
+    Q_INVOKABLE int indexOf(const QString &name) const;
+    Q_INVOKABLE QStringList names() const;
+    Q_INVOKABLE QGeoCoordinate position(int index) const;
+    // Позиции всех спутников одним вызовом (индекс = индекс в движке, высота в метрах)
+    Q_INVOKABLE QVariantList positions() const;
+    // Трасса спутника за один виток от текущего момента
+    Q_INVOKABLE QVariantList groundTrack(int index, int samples = 180) const;
+
+    int count() const { return m_names.size(); }
+    const QString &name(int index) const { return m_names[index]; }
+    double latitude(int index) const { return m_latitudes[index]; }
+    double longitude(int index) const { return m_longitudes[index]; }
+    double altitude(int index) const { return m_altitudes[index]; }
+    const QColor &color(int index) const { return m_colors[index]; }
+    const OrbitPropagator &orbits() const { return m_orbits; }
+
+    static const int kBlockSize;
+
+    // Подписка на шаги и кадры часов модельного времени
+    void setClock(SimulationClock *clock);
+
+    // Пул потоков шага, общий с теми, кто обрабатывает события движка
+    // (синтез измерений). threadCount <= 0 - по числу ядер
+    TickPool *tickPool();
+    void setThreadCount(int threadCount);
+
+    double simulationTime() const { return m_simulationTime; }
+
+signals:
+    void countChanged();
+    void simulationTimeChanged();
+    void stepped();
+    void trailPointsDue(const QVector<int> &indices);
+
+private slots:
+    void onTick(double time, double dt);
+    void onFrame();
+
+private:
+    void appendSatellite(const QString &name, const OrbitalElements &elements, const QColor &color);
+    void updatePositions();
+    void updateEventClocks(int begin, int end, double dt, QVector<int> *trail);
+    void publishEvents();
+
+    static OrbitalElements elementsFromMap(const QVariantMap &orbit);
+
+    OrbitPropagator m_orbits;
+
+    // Состояние спутников (структура массивов)
+    QVector<QString> m_names;
+    QVector<QColor> m_colors;
+    QVector<double> m_altitudes;
+    QVector<double> m_latitudes;
+    QVector<double> m_longitudes;
+    QVector<double> m_trailPeriods;       // секунды модельного времени
+    QVector<double> m_trailClock;         // накопленное время до точки следа
+    QVector<int> m_trailSeq;
+
+    QVector<int> m_dueTrailPoints;
+    // События по блокам шага, сливаются в порядке блоков
+    QVector<QVector<int>> m_blockTrailPoints;
+
+    SimulationClock *m_clock;
+    TickPool *m_pool;
+    int m_threadCount;
+    double m_simulationTime;
+};
+
+#endif // SATELLITE_ENGINE_H
@@ -0,0 +1,683 @@
+#include "satellite_layer.h"
+#include "satellite_engine.h"
+#include "static_sensor_scheduler.h"
+
+#include <QQuickWindow>
+#include <QSGGeometryNode>
+#include <QSGImageNode>
+#include <QSGRendererInterface>
+#include <QSGVertexColorMaterial>
+#include <QHash>
+#include <QPainter>
+#include <QFont>
+#include <QFontMetrics>
+#include <QHoverEvent>
+#include <QMouseEvent>
+#include <QtMath>
+#include <cmath>
+
+namespace {
+const int kGridCells = 256;         // ячеек сетки выбора по каждой оси мира
+const int kPointSegments = 6;       // точка при мелком масштабе
+const int kIconSegments = 12;       // значок при крупном
+const double kPointRadius = 3.0;
+const double kFixedPointRadius = 4.5;
+const double kIconRadius = 7.0;     // как 14-пиксельный значок Satellite.qml
+const double kFixedIconRadius = 9.0;
+const double kIconBorder = 2.0;
+const double kFixedIconBorder = 3.0;
+const double kHaloWidth = 4.0;      // подсветка выбранного и наведенного
+const double kPickSlack = 4.0;      // запас к радиусу значка при выборе
+const double kCullMargin = 80.0;    // пикселей за краем, чтобы подписи не обрывались
+const double kLabelAltitudeStep = 10.0;  // км: на эллиптической орбите подпись не меняется каждый шаг
+
+// Текстура подписи спутника и текст, из которого она нарисована
+struct LabelTexture {
+    QString text;
+    QSGTexture *texture;
+
+    LabelTexture() : texture(nullptr) {}
+};
+
+// Корень слоя: держит кеш текстур подписей по ключу спутника. Узлы удаляются
+// в потоке рендера, вместе с ними - текстуры
+class SatelliteLayerNode : public QSGNode
+{
+public:
+    explicit SatelliteLayerNode(bool software)
+        : software(software), shapes(nullptr), labels(nullptr), image(nullptr), imageTexture(nullptr) {}
+
+    ~SatelliteLayerNode() override
+    {
+        for (const LabelTexture &label : labelTextures) {
+            delete label.texture;
+        }
+        delete imageTexture;
+    }
+
+    bool software;
+
+    // OpenGL: треугольники всех значков и по узлу на подпись
+    QSGGeometryNode *shapes;
+    QSGNode *labels;
+    QHash<int, LabelTexture> labelTextures;
+
+    // Без OpenGL: одно изображение на весь слой
+    QSGImageNode *image;
+    QSGTexture *imageTexture;
+};
+
+// Цвет с умножением на альфу для QSGVertexColorMaterial
+struct Rgba {
+    uchar r, g, b, a;
+
+    explicit Rgba(const QColor &color, double opacity = 1.0)
+    {
+        int alpha = qRound(color.alpha() * opacity);
+        r = uchar(color.red() * alpha / 255);
+        g = uchar(color.green() * alpha / 255);
+        b = uchar(color.blue() * alpha / 255);
+        a = uchar(alpha);
+    }
+};
+
+int writeDisc(QSGGeometry::ColoredPoint2D *v, const QPointF &c, double radius, int segments, const Rgba &color)
+{
+    for (int i = 0; i < segments; i++) {
+        double a0 = 2 * M_PI * i / segments;
+        double a1 = 2 * M_PI * (i + 1) / segments;
+        v[0].set(float(c.x()), float(c.y()), color.r, color.g, color.b, color.a);
+        v[1].set(float(c.x() + radius * std::cos(a0)), float(c.y() + radius * std::sin(a0)),
+                 color.r, color.g, color.b, color.a);
+        v[2].set(float(c.x() + radius * std::cos(a1)), float(c.y() + radius * std::sin(a1)),
+                 color.r, color.g, color.b, color.a);
+        v += 3;
+    }
+    return segments * 3;
+}
+}
+
+SatelliteLayer::SatelliteLayer(QQuickItem *parent)
+    : MapOverlayItem(parent)
+    , m_iconZoom(4)
+    , m_labelZoom(5)
+    , m_maxLabels(200)
+    , m_softwareRendering(false)
+    , m_selectedIndex(-1)
+    , m_hoveredKey(-1)
+    , m_dirty(true)
+    , m_gridDirty(true)
+{
+    setAcceptHoverEvents(true);
+    setAcceptedMouseButtons(Qt::LeftButton);
+}
+
+QObject *SatelliteLayer::engine() const
+{
+    return m_engine.data();
+}
+
+void SatelliteLayer::setEngine(QObject *engine)
+{
+    SatelliteEngine *satelliteEngine = qobject_cast<SatelliteEngine *>(engine);
+    if (m_engine == satelliteEngine) return;
+
+    if (m_engine) {
+        disconnect(m_engine, nullptr, this, nullptr);
+    }
+
+    m_engine = satelliteEngine;
+    if (m_engine) {
+        connect(m_engine, &SatelliteEngine::stepped, this, &SatelliteLayer::onEngineChanged);
+        connect(m_engine, &SatelliteEngine::rowsInserted, this, &SatelliteLayer::onEngineChanged);
+        connect(m_engine, &SatelliteEngine::modelReset, this, [this]() {
+            setHoveredKey(-1);
+            setSelectedIndex(-1);
+            onEngineChanged();
+        });
+    }
+
+    m_gridDirty = true;
+    invalidate();
+    emit engineChanged();
+}
+
+QObject *SatelliteLayer::sensors() const
+{
+    return m_sensors.data();
+}
+
+void SatelliteLayer::setSensors(QObject *sensors)
+{
+    StaticSensorScheduler *scheduler = qobject_cast<StaticSensorScheduler *>(sensors);
+    if (m_sensors == scheduler) return;
+
+    if (m_sensors) {
+        disconnect(m_sensors, nullptr, this, nullptr);
+    }
+
+    m_sensors = scheduler;
+    if (m_sensors) {
+        connect(m_sensors, &StaticSensorScheduler::sensorsChanged, this, &SatelliteLayer::onSensorsChanged);
+    }
+
+    onSensorsChanged();
+    emit sensorsChanged();
+}
+
+void SatelliteLayer::setIconZoom(double zoom)
+{
+    if (qFuzzyCompare(m_iconZoom, zoom)) return;
+    m_iconZoom = zoom;
+    invalidate();
+    emit detailChanged();
+}
+
+void SatelliteLayer::setLabelZoom(double zoom)
+{
+    if (qFuzzyCompare(m_labelZoom, zoom)) return;
+    m_labelZoom = zoom;
+    invalidate();
+    emit detailChanged();
+}
+
+void SatelliteLayer::setMaxLabels(int count)
+{
+    count = qMax(0, count);
+    if (m_maxLabels == count) return;
+    m_maxLabels = count;
+    invalidate();
+    emit detailChanged();
+}
+
+void SatelliteLayer::setSoftwareRendering(bool enabled)
+{
+    if (m_softwareRendering == enabled) return;
+    m_softwareRendering = enabled;
+    invalidate();
+    emit softwareRenderingChanged();
+}
+
+void SatelliteLayer::setSelectedIndex(int index)
+{
+    if (index < -1) index = -1;
+    if (m_selectedIndex == index) return;
+    m_selectedIndex = index;
+    invalidate();
+    emit selectedIndexChanged();
+}
+
+QVariantMap SatelliteLayer::hovered() const
+{
+    return m_hoveredKey == -1 ? QVariantMap() : describe(m_hoveredKey);
+}
+
+void SatelliteLayer::onSensorsChanged()
+{
+    const int count = m_sensors ? m_sensors->count() : 0;
+    m_fixed.resize(count);
+    for (int i = 0; i < count; i++) {
+        m_fixed[i] = mercator(m_sensors->latitude(i), m_sensors->longitude(i));
+    }
+
+    if (isFixedKey(m_hoveredKey) && fixedIndex(m_hoveredKey) >= count) {
+        setHoveredKey(-1);
+    }
+    m_gridDirty = true;
+    invalidate();
+}
+
+void SatelliteLayer::onEngineChanged()
+{
+    m_gridDirty = true;
+    invalidate();
+}
+
+void SatelliteLayer::invalidate()
+{
+    m_dirty = true;
+    update();
+}
+
+void SatelliteLayer::onViewportChanged()
+{
+    invalidate();
+}
+
+bool SatelliteLayer::useSoftware() const
+{
+    if (m_softwareRendering) return true;
+    QQuickWindow *w = window();
+    return w && w->rendererInterface()->graphicsApi() == QSGRendererInterface::Software;
+}
+
+QString SatelliteLayer::labelText(int key) const
+{
+    if (isFixedKey(key)) {
+        int index = fixedIndex(key);
+        return m_sensors->name(index) + "\n" + QString::number(qRound(m_sensors->altitude(index))) + " км";
+    }
+    // Высота с шагом kLabelAltitudeStep: текстура подписи перерисовывается,
+    // только когда высота заметно изменилась
+    const double altitude = qRound(m_engine->altitude(key) / kLabelAltitudeStep) * kLabelAltitudeStep;
+    return m_engine->name(key) + "\n" + QString::number(qRound(altitude)) + " км";
+}
+
+QColor SatelliteLayer::colorOf(int key) const
+{
+    return isFixedKey(key) ? m_sensors->color(fixedIndex(key)) : m_engine->color(key);
+}
+
+QVariantMap SatelliteLayer::describe(int key) const
+{
+    QVariantMap result;
+    if (isFixedKey(key)) {
+        if (!m_sensors || fixedIndex(key) >= m_sensors->count()) return result;
+        int index = fixedIndex(key);
+        result["fixed"] = true;
+        result["index"] = index;
+        result["name"] = m_sensors->name(index);
+        result["latitude"] = m_sensors->latitude(index);
+        result["longitude"] = m_sensors->longitude(index);
+        result["altitude"] = m_sensors->altitude(index);
+    } else if (m_engine && key >= 0 && key < m_engine->count()) {
+        result["fixed"] = false;
+        result["index"] = key;
+        result["name"] = m_engine->name(key);
+        result["latitude"] = m_engine->latitude(key);
+        result["longitude"] = m_engine->longitude(key);
+        result["altitude"] = m_engine->altitude(key);
+    }
+    return result;
+}
+
+bool SatelliteLayer::isHighlighted(int key) const
+{
+    return key == m_hoveredKey || (key >= 0 && key == m_selectedIndex);
+}
+
+void SatelliteLayer::collectVisible()
+{
+    m_visible.clear();
+    const QRectF bounds = QRectF(0, 0, width(), height()).adjusted(-kCullMargin, -kCullMargin,
+                                                                   kCullMargin, kCullMargin);
+
+    // Неподвижные - под движущимися
+    for (int i = 0; i < m_fixed.size(); i++) {
+        QPointF point = toItem(m_fixed[i]);
+        if (bounds.contains(point)) {
+            m_visible.append({fixedKey(i), point});
+        }
+    }
+
+    const int count = m_engine ? m_engine->count() : 0;
+    for (int i = 0; i < count; i++) {
+        QPointF point = toItem(mercator(m_engine->latitude(i), m_engine->longitude(i)));
+        if (bounds.contains(point)) {
+            m_visible.append({i, point});
+        }
+    }
+}
+
+int SatelliteLayer::verticesFor(int key) const
+{
+    // Точка - один круг, значок - обводка и круг, подсветка - еще один круг под ними
+    const bool icons = zoomLevel() >= m_iconZoom;
+    int discs = (icons ? 2 : 1) + (isHighlighted(key) ? 1 : 0);
+    return discs * (icons ? kIconSegments : kPointSegments) * 3;
+}
+
+int SatelliteLayer::writeSatellite(QSGGeometry *geometry, int vertex, const Visible &satellite) const
+{
+    QSGGeometry::ColoredPoint2D *v = geometry->vertexDataAsColoredPoint2D() + vertex;
+    const bool fixed = isFixedKey(satellite.key);
+    const bool highlighted = isHighlighted(satellite.key);
+    const Rgba color(colorOf(satellite.key));
+    int written = 0;
+
+    if (zoomLevel() < m_iconZoom) {
+        double radius = fixed ? kFixedPointRadius : kPointRadius;
+        if (highlighted) {
+            written += writeDisc(v + written, satellite.point, radius + kHaloWidth, kPointSegments,
+                                 Rgba(Qt::black, 0.3));
+        }
+        written += writeDisc(v + written, satellite.point, radius, kPointSegments, color);
+        return written;
+    }
+
+    double radius = fixed ? kFixedIconRadius : kIconRadius;
+    double border = fixed ? kFixedIconBorder : kIconBorder;
+    if (highlighted) {
+        written += writeDisc(v + written, satellite.point, radius + border + kHaloWidth, kIconSegments,
+                             Rgba(Qt::black, 0.3));
+    }
+    written += writeDisc(v + written, satellite.point, radius + border, kIconSegments, Rgba(Qt::white));
+    written += writeDisc(v + written, satellite.point, radius, kIconSegments, color);
+    return written;
+}
+
+QImage SatelliteLayer::renderLabel(const QString &text, double devicePixelRatio)
+{
+    // Подпись как в Satellite.qml: белая плашка с серой рамкой, жирный 8px
+    QFont font;
+    font.setPixelSize(8);
+    font.setBold(true);
+
+    QFontMetrics metrics(font);
+    QRect textRect = metrics.boundingRect(QRect(0, 0, 400, 100), Qt::AlignCenter, text);
+    QRectF rect(0, 0, textRect.width() + 8, textRect.height() + 4);
+
+    QImage image((rect.size() * devicePixelRatio).toSize(), QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(devicePixelRatio);
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(QColor(Qt::gray));
+    painter.setBrush(QColor(0xFF, 0xFF, 0xFF, 0xE0));
+    painter.drawRoundedRect(rect.adjusted(0.5, 0.5, -0.5, -0.5), 3, 3);
+    painter.setFont(font);
+    painter.setPen(Qt::black);
+    painter.drawText(rect, Qt::AlignCenter, text);
+    return image;
+}
+
+QSGNode *SatelliteLayer::updateGeometryNodes(QSGNode *rootNode)
+{
+    SatelliteLayerNode *root = static_cast<SatelliteLayerNode *>(rootNode);
+
+    if (!root->shapes) {
+        QSGGeometry *geometry = new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), 0);
+        geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+        geometry->setVertexDataPattern(QSGGeometry::DynamicPattern);
+
+        root->shapes = new QSGGeometryNode;
+        root->shapes->setGeometry(geometry);
+        root->shapes->setFlag(QSGNode::OwnsGeometry);
+        root->shapes->setMaterial(new QSGVertexColorMaterial);
+        root->shapes->setFlag(QSGNode::OwnsMaterial);
+        root->appendChildNode(root->shapes);
+
+        root->labels = new QSGNode;
+        root->appendChildNode(root->labels);
+    }
+
+    // Значки: размер буфера - по числу спутников на экране
+    int vertexCount = 0;
+    for (const Visible &satellite : m_visible) {
+        vertexCount += verticesFor(satellite.key);
+    }
+
+    QSGGeometry *geometry = root->shapes->geometry();
+    if (geometry->vertexCount() != vertexCount) {
+        geometry->allocate(vertexCount);
+    }
+    int vertex = 0;
+    for (const Visible &satellite : m_visible) {
+        vertex += writeSatellite(geometry, vertex, satellite);
+    }
+    root->shapes->markDirty(QSGNode::DirtyGeometry);
+
+    // Подписи: выбранный и наведенный всегда, остальные - с labelZoom и до maxLabels.
+    // Текстуры кешируются по спутнику, перерисовываются при смене текста
+    // и удаляются, когда подпись уходит с экрана
+    const bool allLabels = zoomLevel() > m_labelZoom;
+    const double dpr = window() ? window()->effectiveDevicePixelRatio() : 1.0;
+    QHash<int, LabelTexture> used;
+    QSGNode *labelNode = root->labels->firstChild();
+    int labels = 0;
+
+    for (const Visible &satellite : m_visible) {
+        bool forced = isHighlighted(satellite.key);
+        if (!forced && (!allLabels || labels >= m_maxLabels)) continue;
+
+        const QString text = labelText(satellite.key);
+        LabelTexture label = root->labelTextures.take(satellite.key);
+        if (label.texture && label.text != text) {
+            delete label.texture;
+            label.texture = nullptr;
+        }
+        if (!label.texture) {
+            label.text = text;
+            label.texture = window()->createTextureFromImage(renderLabel(text, dpr));
+        }
+        used.insert(satellite.key, label);
+        QSGTexture *texture = label.texture;
+
+        QSGImageNode *node = static_cast<QSGImageNode *>(labelNode);
+        if (!node) {
+            node = window()->createImageNode();
+            node->setFiltering(QSGTexture::Linear);
+            root->labels->appendChildNode(node);
+        } else {
+            labelNode = labelNode->nextSibling();
+        }
+
+        QSizeF size = QSizeF(texture->textureSize()) / dpr;
+        double offset = isFixedKey(satellite.key) ? kFixedIconRadius + kFixedIconBorder
+                                                  : kIconRadius + kIconBorder;
+        node->setTexture(texture);
+        node->setRect(QRectF(satellite.point.x() - size.width() / 2,
+                             satellite.point.y() + offset + 2, size.width(), size.height()));
+        labels++;
+    }
+
+    // Лишние узлы подписей и текстуры, которые не понадобились в этом кадре
+    while (labelNode) {
+        QSGNode *next = labelNode->nextSibling();
+        root->labels->removeChildNode(labelNode);
+        delete labelNode;
+        labelNode = next;
+    }
+    for (const LabelTexture &label : root->labelTextures) {
+        delete label.texture;
+    }
+    root->labelTextures = used;
+
+    return root;
+}
+
+QImage SatelliteLayer::renderImage() const
+{
+    const double dpr = window() ? window()->effectiveDevicePixelRatio() : 1.0;
+    QImage image(QSize(qCeil(width() * dpr), qCeil(height() * dpr)), QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(dpr);
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    const bool icons = zoomLevel() >= m_iconZoom;
+    const bool allLabels = zoomLevel() > m_labelZoom;
+    int labels = 0;
+
+    for (const Visible &satellite : m_visible) {
+        const bool fixed = isFixedKey(satellite.key);
+        const bool highlighted = isHighlighted(satellite.key);
+        double radius = icons ? (fixed ? kFixedIconRadius : kIconRadius)
+                              : (fixed ? kFixedPointRadius : kPointRadius);
+        double border = icons ? (fixed ? kFixedIconBorder : kIconBorder) : 0;
+
+        painter.setPen(Qt::NoPen);
+        if (highlighted) {
+            painter.setBrush(QColor(0, 0, 0, 77));
+            double r = radius + border + kHaloWidth;
+            painter.drawEllipse(satellite.point, r, r);
+        }
+        if (border > 0) {
+            painter.setBrush(Qt::white);
+            painter.drawEllipse(satellite.point, radius + border, radius + border);
+        }
+        painter.setBrush(colorOf(satellite.key));
+        painter.drawEllipse(satellite.point, radius, radius);
+
+        if (highlighted || (allLabels && labels < m_maxLabels)) {
+            QImage label = renderLabel(labelText(satellite.key), dpr);
+            double offset = (fixed ? kFixedIconRadius + kFixedIconBorder : kIconRadius + kIconBorder) + 2;
+            painter.drawImage(QPointF(satellite.point.x() - label.width() / (2.0 * dpr),
+                                      satellite.point.y() + offset), label);
+            if (!highlighted) labels++;
+        }
+    }
+    return image;
+}
+
+QSGNode *SatelliteLayer::updateImageNode(QSGNode *rootNode)
+{
+    SatelliteLayerNode *root = static_cast<SatelliteLayerNode *>(rootNode);
+
+    if (!root->image) {
+        root->image = window()->createImageNode();
+        root->image->setFiltering(QSGTexture::Linear);
+        root->appendChildNode(root->image);
+    }
+
+    QSGTexture *texture = window()->createTextureFromImage(renderImage());
+    root->image->setTexture(texture);
+    root->image->setRect(QRectF(0, 0, width(), height()));
+    delete root->imageTexture;
+    root->imageTexture = texture;
+    return root;
+}
+
+QSGNode *SatelliteLayer::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data)
+{
+    Q_UNUSED(data)
+
+    const bool software = useSoftware();
+    SatelliteLayerNode *root = static_cast<SatelliteLayerNode *>(oldNode);
+    if (root && root->software != software) {
+        delete root;
+        root = nullptr;
+    }
+    if (!root) {
+        root = new SatelliteLayerNode(software);
+        m_dirty = true;
+    }
+
+    if (width() <= 0 || height() <= 0) return root;
+    if (!m_dirty) return root;
+    m_dirty = false;
+
+    collectVisible();
+    return software ? updateImageNode(root) : updateGeometryNodes(root);
+}
+
+void SatelliteLayer::rebuildGrid()
+{
+    const int moving = m_engine ? m_engine->count() : 0;
+    const int total = moving + m_fixed.size();
+
+    QVector<int> cells(total);
+    QVector<QPointF> points(total);
+    m_gridStart.fill(0, kGridCells * kGridCells + 1);
+
+    for (int i = 0; i < total; i++) {
+        QPointF point = i < moving ? mercator(m_engine->latitude(i), m_engine->longitude(i))
+                                   : m_fixed[i - moving];
+        int cx = qBound(0, int(point.x() * kGridCells), kGridCells - 1);
+        int cy = qBound(0, int(point.y() * kGridCells), kGridCells - 1);
+        cells[i] = cy * kGridCells + cx;
+        points[i] = point;
+        m_gridStart[cells[i] + 1]++;
+    }
+    for (int cell = 0; cell < kGridCells * kGridCells; cell++) {
+        m_gridStart[cell + 1] += m_gridStart[cell];
+    }
+
+    // Раскладка подсчетом: ключи каждой ячейки лежат подряд
+    QVector<int> fill = m_gridStart;
+    m_gridKeys.resize(total);
+    for (int i = 0; i < total; i++) {
+        m_gridKeys[fill[cells[i]]++] = i < moving ? i : fixedKey(i - moving);
+    }
+    m_gridDirty = false;
+}
+
+int SatelliteLayer::pick(const QPointF &point)
+{
+    if (worldSize() <= 0) return -1;
+    if (m_gridDirty) rebuildGrid();
+
+    const bool icons = zoomLevel() >= m_iconZoom;
+    const double radiusPixels = (icons ? kFixedIconRadius + kFixedIconBorder : kFixedPointRadius) + kPickSlack;
+    const double radius = radiusPixels / worldSize();
+
+    double mx = centerMercator().x() + (point.x() - width() / 2) / worldSize();
+    double my = centerMercator().y() + (point.y() - height() / 2) / worldSize();
+
+    int x0 = int(std::floor((mx - radius) * kGridCells));
+    int x1 = int(std::floor((mx + radius) * kGridCells));
+    int y0 = qMax(0, int(std::floor((my - radius) * kGridCells)));
+    int y1 = qMin(kGridCells - 1, int(std::floor((my + radius) * kGridCells)));
+    x1 = qMin(x1, x0 + kGridCells - 1);
+
+    const int moving = m_engine ? m_engine->count() : 0;
+    int best = -1;
+    double bestDistance = radiusPixels * radiusPixels;
+
+    for (int cy = y0; cy <= y1; cy++) {
+        for (int x = x0; x <= x1; x++) {
+            int cx = ((x % kGridCells) + kGridCells) % kGridCells;  // шов на 180-м меридиане
+            int cell = cy * kGridCells + cx;
+            for (int k = m_gridStart[cell]; k < m_gridStart[cell + 1]; k++) {
+                int key = m_gridKeys[k];
+                bool fixed = isFixedKey(key);
+                if ((fixed && fixedIndex(key) >= m_fixed.size()) || (!fixed && key >= moving)) continue;
+
+                QPointF p = toItem(fixed ? m_fixed[fixedIndex(key)]
+                                         : mercator(m_engine->latitude(key), m_engine->longitude(key)));
+                double dx = p.x() - point.x();
+                double dy = p.y() - point.y();
+                double distance = dx * dx + dy * dy;
+                if (distance <= bestDistance) {
+                    bestDistance = distance;
+                    best = key;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+QVariantMap SatelliteLayer::satelliteAt(double x, double y)
+{
+    int key = pick(QPointF(x, y));
+    return key == -1 ? QVariantMap() : describe(key);
+}
+
+void SatelliteLayer::setHoveredKey(int key)
+{
+    if (m_hoveredKey == key) return;
+    m_hoveredKey = key;
+    invalidate();
+    emit hoveredChanged();
+}
+
+void SatelliteLayer::hoverMoveEvent(QHoverEvent *event)
+{
+    setHoveredKey(pick(event->posF()));
+    event->ignore();
+}
+
+void SatelliteLayer::hoverLeaveEvent(QHoverEvent *event)
+{
+    setHoveredKey(-1);
+    event->ignore();
+}
+
+void SatelliteLayer::mousePressEvent(QMouseEvent *event)
+{
+    // Промах отдается карте - жесты перетаскивания и масштаба работают как раньше
+    int key = pick(event->localPos());
+    if (key == -1) {
+        event->ignore();
+        return;
+    }
+
+    if (!isFixedKey(key)) {
+        setSelectedIndex(key);
+    }
+    emit satelliteClicked(describe(key));
+    event->accept();
+}
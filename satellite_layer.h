@@ -0,0 +1,144 @@
+#ifndef SATELLITE_LAYER_H
+#define SATELLITE_LAYER_H
+
+#include "map_overlay_item.h"
+
+#include <QColor>
+#include <QVector>
+#include <QPointer>
+#include <QImage>
+#include <QVariantMap>
+
+class SatelliteEngine;
+class StaticSensorScheduler;
+class QSGGeometry;
+class QSGNode;
+
+// Все спутники одним элементом scene graph вместо MapQuickItem на каждый спутник.
+// Движущиеся берутся прямо из массивов положений SatelliteEngine, неподвижные
+// (над городами) - из StaticSensorScheduler. Вершины строятся только для спутников
+// в пределах экрана и только когда изменились положения или вид.
+//
+// Уровни детализации: до iconZoom - точки, дальше - значки с обводкой, подписи
+// с именем и высотой - от labelZoom (не больше maxLabels) и всегда у спутника
+// под курсором и выбранного. Выбор и наведение идут через сетку по координатам
+// Меркатора, а не через MouseArea у каждого спутника.
+//
+// Без OpenGL (QT_QUICK_BACKEND=software) или с softwareRendering слой рисуется
+// QPainter в одно изображение
+class SatelliteLayer : public MapOverlayItem
+{
+    Q_OBJECT
+    Q_PROPERTY(QObject *engine READ engine WRITE setEngine NOTIFY engineChanged)
+    Q_PROPERTY(double iconZoom READ iconZoom WRITE setIconZoom NOTIFY detailChanged)
+    Q_PROPERTY(double labelZoom READ labelZoom WRITE setLabelZoom NOTIFY detailChanged)
+    Q_PROPERTY(int maxLabels READ maxLabels WRITE setMaxLabels NOTIFY detailChanged)
+    Q_PROPERTY(bool softwareRendering READ softwareRendering WRITE setSoftwareRendering NOTIFY softwareRenderingChanged)
+    Q_PROPERTY(int selectedIndex READ selectedIndex WRITE setSelectedIndex NOTIFY selectedIndexChanged)
+    Q_PROPERTY(QVariantMap hovered READ hovered NOTIFY hoveredChanged)
+    Q_PROPERTY(QObject *sensors READ sensors WRITE setSensors NOTIFY sensorsChanged)
+
+public:
+    explicit SatelliteLayer(QQuickItem *parent = nullptr);
+
+    QObject *engine() const;
+    void setEngine(QObject *engine);
+
+    // Неподвижные спутники над городами
+    QObject *sensors() const;
+    void setSensors(QObject *sensors);
+
+    double iconZoom() const { return m_iconZoom; }
+    void setIconZoom(double zoom);
+
+    double labelZoom() const { return m_labelZoom; }
+    void setLabelZoom(double zoom);
+
+    int maxLabels() const { return m_maxLabels; }
+    void setMaxLabels(int count);
+
+    bool softwareRendering() const { return m_softwareRendering; }
+    void setSoftwareRendering(bool enabled);
+
+    // Выбранный движущийся спутник (индекс в движке), -1 - нет
+    int selectedIndex() const { return m_selectedIndex; }
+    void setSelectedIndex(int index);
+
+    // Спутник под курсором в формате satelliteAt, пустой - нет
+    QVariantMap hovered() const;
+
+    // Ближайший к точке элемента спутник в радиусе значка:
+    // { fixed, index, name, latitude, longitude, altitude }, пустой - промах
+    Q_INVOKABLE QVariantMap satelliteAt(double x, double y);
+
+signals:
+    void engineChanged();
+    void detailChanged();
+    void softwareRenderingChanged();
+    void selectedIndexChanged();
+    void hoveredChanged();
+    void sensorsChanged();
+    void satelliteClicked(const QVariantMap &satellite);
+
+protected:
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+    void onViewportChanged() override;
+
+    void hoverMoveEvent(QHoverEvent *event) override;
+    void hoverLeaveEvent(QHoverEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+
+private:
+    // Спутник на экране в этом кадре
+    struct Visible {
+        int key;
+        QPointF point;  // пиксели элемента
+    };
+
+    // Ключ спутника: индекс движка для движущихся, -2 - i для неподвижного i
+    static int fixedKey(int index) { return -2 - index; }
+    static bool isFixedKey(int key) { return key <= -2; }
+    static int fixedIndex(int key) { return -2 - key; }
+
+    void onEngineChanged();
+    void onSensorsChanged();
+    void invalidate();
+    void collectVisible();
+    bool isHighlighted(int key) const;
+    QString labelText(int key) const;
+    QColor colorOf(int key) const;
+    QVariantMap describe(int key) const;
+    int pick(const QPointF &point);
+    void rebuildGrid();
+    void setHoveredKey(int key);
+    bool useSoftware() const;
+
+    int verticesFor(int key) const;
+    int writeSatellite(QSGGeometry *geometry, int vertex, const Visible &satellite) const;
+    QSGNode *updateGeometryNodes(QSGNode *root);
+    QSGNode *updateImageNode(QSGNode *root);
+    QImage renderImage() const;
+    static QImage renderLabel(const QString &text, double devicePixelRatio);
+
+    QPointer<SatelliteEngine> m_engine;
+    QPointer<StaticSensorScheduler> m_sensors;
+    QVector<QPointF> m_fixed;  // координаты Меркатора датчиков, датчики не движутся
+
+    double m_iconZoom;
+    double m_labelZoom;
+    int m_maxLabels;
+    bool m_softwareRendering;
+    int m_selectedIndex;
+    int m_hoveredKey;
+
+    // Кадр: спутники в пределах экрана
+    QVector<Visible> m_visible;
+    bool m_dirty;
+
+    // Сетка выбора: m_gridStart[cell]..m_gridStart[cell + 1] в m_gridKeys
+    QVector<int> m_gridStart;
+    QVector<int> m_gridKeys;
+    bool m_gridDirty;
+};
+
+#endif // SATELLITE_LAYER_H
@@ -0,0 +1,230 @@
+#include "series_lod.h"
+
+#include <algorithm>
+#include <numeric>
+
+const int SeriesLod::kFanout = 4;
+
+SeriesLod::SeriesLod()
+    : m_min(0)
+    , m_max(0)
+{
+}
+
+void SeriesLod::clear()
+{
+    m_times.clear();
+    m_values.clear();
+    m_levels.clear();
+    m_bucketSizes.clear();
+    m_min = 0;
+    m_max = 0;
+}
+
+void SeriesLod::setData(const QVector<qint64> &times, const QVector<double> &values)
+{
+    const int n = qMin(times.size(), values.size());
+    m_times = times.mid(0, n);
+    m_values = values.mid(0, n);
+
+    if (!std::is_sorted(m_times.begin(), m_times.end())) {
+        QVector<int> order(n);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(),
+                         [&times](int a, int b) { return times[a] < times[b]; });
+        for (int i = 0; i < n; i++) {
+            m_times[i] = times[order[i]];
+            m_values[i] = values[order[i]];
+        }
+    }
+
+    rebuild();
+}
+
+void SeriesLod::append(qint64 time, double value)
+{
+    if (!m_times.isEmpty() && time < m_times.last()) {
+        const int position = upperBound(time);
+        m_times.insert(position, time);
+        m_values.insert(position, value);
+        rebuild();
+        return;
+    }
+
+    m_times.append(time);
+    m_values.append(value);
+    if (m_times.size() == 1) {
+        m_min = m_max = value;
+    } else {
+        m_min = qMin(m_min, value);
+        m_max = qMax(m_max, value);
+    }
+    appendToLevels(m_times.size() - 1);
+}
+
+void SeriesLod::rebuild()
+{
+    m_levels.clear();
+    m_bucketSizes.clear();
+
+    const int n = m_values.size();
+    if (n == 0) {
+        m_min = m_max = 0;
+        return;
+    }
+
+    m_min = m_max = m_values.first();
+    for (double value : m_values) {
+        m_min = qMin(m_min, value);
+        m_max = qMax(m_max, value);
+    }
+
+    // Уровень k строится из уровня k - 1, пока в корзину помещается весь ряд
+    for (int size = kFanout; size <= n; size *= kFanout) {
+        QVector<Bucket> level;
+        level.reserve((n + size - 1) / size);
+
+        if (m_levels.isEmpty()) {
+            for (int begin = 0; begin < n; begin += size) {
+                const int end = qMin(begin + size, n);
+                Bucket bucket = { m_values[begin], m_values[begin] };
+                for (int i = begin + 1; i < end; i++) {
+                    bucket.min = qMin(bucket.min, m_values[i]);
+                    bucket.max = qMax(bucket.max, m_values[i]);
+                }
+                level.append(bucket);
+            }
+        } else {
+            const QVector<Bucket> &lower = m_levels.last();
+            for (int begin = 0; begin < lower.size(); begin += kFanout) {
+                const int end = qMin(begin + kFanout, lower.size());
+                Bucket bucket = lower[begin];
+                for (int i = begin + 1; i < end; i++) {
+                    bucket.min = qMin(bucket.min, lower[i].min);
+                    bucket.max = qMax(bucket.max, lower[i].max);
+                }
+                level.append(bucket);
+            }
+        }
+
+        m_levels.append(level);
+        m_bucketSizes.append(size);
+    }
+}
+
+void SeriesLod::appendToLevels(int index)
+{
+    const double value = m_values[index];
+    for (int level = 0; level < m_levels.size(); level++) {
+        QVector<Bucket> &buckets = m_levels[level];
+        const int bucket = index / bucketSize(level);
+        if (bucket == buckets.size()) {
+            buckets.append(Bucket{ value, value });
+        } else {
+            buckets[bucket].min = qMin(buckets[bucket].min, value);
+            buckets[bucket].max = qMax(buckets[bucket].max, value);
+        }
+    }
+
+    // Ряд дорос до корзины следующего уровня: она покрывает весь ряд
+    const int next = m_bucketSizes.isEmpty() ? kFanout : m_bucketSizes.last() * kFanout;
+    if (index + 1 == next) {
+        m_levels.append(QVector<Bucket>(1, Bucket{ m_min, m_max }));
+        m_bucketSizes.append(next);
+    }
+}
+
+int SeriesLod::lowerBound(qint64 time) const
+{
+    return int(std::lower_bound(m_times.begin(), m_times.end(), time) - m_times.begin());
+}
+
+int SeriesLod::upperBound(qint64 time) const
+{
+    return int(std::upper_bound(m_times.begin(), m_times.end(), time) - m_times.begin());
+}
+
+void SeriesLod::valueRange(int begin, int end, double *min, double *max) const
+{
+    begin = qMax(0, begin);
+    end = qMin(end, m_values.size());
+    if (begin >= end) {
+        *min = *max = 0;
+        return;
+    }
+
+    *min = *max = m_values[begin];
+    int i = begin;
+    while (i < end) {
+        // Самая крупная корзина, которая начинается в i и не выходит за end
+        int level = m_levels.size() - 1;
+        while (level >= 0 && (i % bucketSize(level) != 0 || i + bucketSize(level) > end)) {
+            level--;
+        }
+
+        if (level < 0) {
+            *min = qMin(*min, m_values[i]);
+            *max = qMax(*max, m_values[i]);
+            i++;
+        } else {
+            const Bucket &bucket = m_levels[level][i / bucketSize(level)];
+            *min = qMin(*min, bucket.min);
+            *max = qMax(*max, bucket.max);
+            i += bucketSize(level);
+        }
+    }
+}
+
+QVector<SeriesLod::Column> SeriesLod::decimate(qint64 from, qint64 to, int columns) const
+{
+    QVector<Column> result;
+    if (columns <= 0 || to < from) return result;
+
+    const int begin = lowerBound(from);
+    const int end = upperBound(to);
+    result.resize(columns);
+    for (Column &column : result) {
+        column.count = 0;
+    }
+    if (begin >= end) return result;
+
+    // Уровень, корзины которого не шире половины столбца
+    const int perColumn = (end - begin) / columns;
+    int level = -1;
+    while (level + 1 < m_levels.size() && bucketSize(level + 1) * 2 <= perColumn) {
+        level++;
+    }
+
+    const double scale = double(columns) / qMax<qint64>(1, to - from);
+    auto columnOf = [=](qint64 time) {
+        return qBound(0, int((time - from) * scale), columns - 1);
+    };
+    auto merge = [&](int index, int count, double min, double max, double first, double last) {
+        Column &column = result[columnOf(m_times[index])];
+        if (column.count == 0) {
+            column.first = first;
+            column.min = min;
+            column.max = max;
+        } else {
+            column.min = qMin(column.min, min);
+            column.max = qMax(column.max, max);
+        }
+        column.last = last;
+        column.count += count;
+    };
+
+    const int size = level >= 0 ? bucketSize(level) : 1;
+    int i = begin;
+    while (i < end) {
+        if (level >= 0 && i % size == 0 && i + size <= end) {
+            const Bucket &bucket = m_levels[level][i / size];
+            merge(i, size, bucket.min, bucket.max, m_values[i], m_values[i + size - 1]);
+            i += size;
+        } else {
+            const double value = m_values[i];
+            merge(i, 1, value, value, value, value);
+            i++;
+        }
+    }
+    return result;
+}
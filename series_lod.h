@@ -0,0 +1,74 @@
+#ifndef SERIES_LOD_H
+#define SERIES_LOD_H
+
+#include <QVector>
+#include <QtGlobal>
+
+// Ряд графика (время в мс от эпохи, значение) с пирамидой минимумов и максимумов.
+// Уровень k хранит min/max по корзинам из kFanout^(k+1) отсчетов, поэтому
+// прореживание до ширины графика и поиск диапазона значений на любом отрезке
+// времени стоят O(пикселей), а не O(отсчетов). Добавление в конец обновляет
+// по одной корзине на уровень
+class SeriesLod
+{
+public:
+    static const int kFanout;
+
+    // Столбец пикселей после прореживания (схема M4: первое, последнее,
+    // минимум и максимум отсчетов, попавших в столбец)
+    struct Column {
+        double first;
+        double last;
+        double min;
+        double max;
+        int count;
+    };
+
+    SeriesLod();
+
+    void clear();
+    // Отсчеты сортируются по времени, если пришли не по порядку
+    void setData(const QVector<qint64> &times, const QVector<double> &values);
+    // Отсчет не по порядку времени вставляется на место с перестроением пирамиды
+    void append(qint64 time, double value);
+
+    int size() const { return m_times.size(); }
+    bool isEmpty() const { return m_times.isEmpty(); }
+    const QVector<qint64> &times() const { return m_times; }
+    const QVector<double> &values() const { return m_values; }
+    qint64 firstTime() const { return m_times.first(); }
+    qint64 lastTime() const { return m_times.last(); }
+    double minValue() const { return m_min; }
+    double maxValue() const { return m_max; }
+
+    // Первый отсчет со временем не раньше time
+    int lowerBound(qint64 time) const;
+    // Первый отсчет со временем позже time
+    int upperBound(qint64 time) const;
+
+    // Минимум и максимум отсчетов [begin, end)
+    void valueRange(int begin, int end, double *min, double *max) const;
+
+    // Отсчеты отрезка [from, to] по columns столбцам. Корзина пирамиды относится
+    // к столбцу своего первого отсчета и не шире половины столбца
+    QVector<Column> decimate(qint64 from, qint64 to, int columns) const;
+
+private:
+    struct Bucket {
+        double min;
+        double max;
+    };
+
+    int bucketSize(int level) const { return m_bucketSizes[level]; }
+    void rebuild();
+    void appendToLevels(int index);
+
+    QVector<qint64> m_times;
+    QVector<double> m_values;
+    QVector<QVector<Bucket>> m_levels;
+    QVector<int> m_bucketSizes;   // отсчетов в корзине уровня
+    double m_min;
+    double m_max;
+};
+
+#endif // SERIES_LOD_H
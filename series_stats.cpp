@@ -0,0 +1,117 @@
+#include "series_stats.h"
+
+#include <iterator>
+
+SeriesStats::SeriesStats()
+    : m_window(0)
+    , m_sum(0)
+{
+}
+
+void SeriesStats::clear()
+{
+    m_samples.clear();
+    m_lower.clear();
+    m_upper.clear();
+    m_sum = 0;
+}
+
+void SeriesStats::setWindow(qint64 window)
+{
+    m_window = qMax<qint64>(0, window);
+    evict();
+}
+
+void SeriesStats::add(qint64 time, double value)
+{
+    // Отсчет старше окна не попадает в статистику
+    if (m_window > 0 && !m_samples.empty() && time < lastTime() - m_window) return;
+
+    m_samples.emplace(time, value);
+    insertValue(value);
+    evict();
+}
+
+void SeriesStats::add(const QVector<qint64> &times, const QVector<double> &values)
+{
+    const int n = qMin(times.size(), values.size());
+    for (int i = 0; i < n; i++) {
+        add(times[i], values[i]);
+    }
+}
+
+double SeriesStats::min() const
+{
+    return m_lower.empty() ? 0 : *m_lower.begin();
+}
+
+double SeriesStats::max() const
+{
+    if (!m_upper.empty()) return *m_upper.rbegin();
+    return m_lower.empty() ? 0 : *m_lower.rbegin();
+}
+
+double SeriesStats::mean() const
+{
+    return m_samples.empty() ? 0 : m_sum / m_samples.size();
+}
+
+double SeriesStats::median() const
+{
+    if (m_lower.empty()) return 0;
+    if (m_lower.size() > m_upper.size()) return *m_lower.rbegin();
+    return (*m_lower.rbegin() + *m_upper.begin()) / 2.0;
+}
+
+void SeriesStats::insertValue(double value)
+{
+    if (m_lower.empty() || value <= *m_lower.rbegin()) {
+        m_lower.insert(value);
+    } else {
+        m_upper.insert(value);
+    }
+    m_sum += value;
+    balance();
+}
+
+void SeriesStats::eraseValue(double value)
+{
+    // Удаляется один экземпляр значения из той половины, где он лежит
+    auto it = m_lower.find(value);
+    if (it != m_lower.end()) {
+        m_lower.erase(it);
+    } else {
+        it = m_upper.find(value);
+        if (it == m_upper.end()) return;
+        m_upper.erase(it);
+    }
+
+    // Сумма после удалений копит ошибку округления, пустое окно ее сбрасывает
+    m_sum = m_samples.empty() ? 0 : m_sum - value;
+    balance();
+}
+
+void SeriesStats::balance()
+{
+    if (m_lower.size() > m_upper.size() + 1) {
+        auto last = std::prev(m_lower.end());
+        m_upper.insert(*last);
+        m_lower.erase(last);
+    } else if (m_upper.size() > m_lower.size()) {
+        auto first = m_upper.begin();
+        m_lower.insert(*first);
+        m_upper.erase(first);
+    }
+}
+
+void SeriesStats::evict()
+{
+    if (m_window <= 0 || m_samples.empty()) return;
+
+    const qint64 cutoff = lastTime() - m_window;
+    while (m_samples.begin()->first < cutoff) {
+        const double value = m_samples.begin()->second;
+        m_samples.erase(m_samples.begin());
+        eraseValue(value);
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef SERIES_STATS_H
+#define SERIES_STATS_H
+
+#include <QVector>
+#include <QtGlobal>
+
+#include <map>
+#include <set>
+
+// Порядковые статистики ряда измерений, обновляемые по одному отсчету.
+// Значения делятся на две упорядоченные половины (нижняя не меньше верхней
+// и больше нее не более чем на один): медиана берется с их границы,
+// минимум и максимум - с краев, среднее - из текущей суммы. Отсчеты
+// хранятся по времени, поэтому в режиме скользящего окна (последние
+// window мс до самого позднего отсчета) устаревшие отсчеты удаляются
+// из половин. Добавление и удаление стоят O(log N), чтение - O(1)
+class SeriesStats
+{
+public:
+    SeriesStats();
+
+    void clear();
+
+    // Длина окна в мс, 0 - весь ряд. Уже удаленные отсчеты не возвращаются,
+    // поэтому при расширении окна ряд нужно загрузить заново
+    qint64 window() const { return m_window; }
+    void setWindow(qint64 window);
+
+    void add(qint64 time, double value);
+    void add(const QVector<qint64> &times, const QVector<double> &values);
+
+    int count() const { return int(m_samples.size()); }
+    bool isEmpty() const { return m_samples.empty(); }
+    double min() const;
+    double max() const;
+    double mean() const;
+    double median() const;
+    qint64 firstTime() const { return m_samples.begin()->first; }
+    qint64 lastTime() const { return m_samples.rbegin()->first; }
+
+private:
+    void insertValue(double value);
+    void eraseValue(double value);
+    void balance();
+    void evict();
+
+    qint64 m_window;
+    std::multimap<qint64, double> m_samples;   // отсчеты в окне по времени
+    std::multiset<double> m_lower;             // меньшая половина значений
+    std::multiset<double> m_upper;             // большая половина значений
+    double m_sum;
+};
+
+#endif // SERIES_STATS_H
@@ -4,329 +4,768 @@
 #include <QVBoxLayout>
 #include <QPushButton>
 #include <QDir>
+#include <QResizeEvent>
+#include <QShowEvent>
+#include <QHideEvent>
+#include <QWheelEvent>
+#include <QMouseEvent>
+#include <QtMath>
+#include <QRunnable>
+#include <QSharedPointer>
+#include <QMetaObject>
+
+#include "zone_appearance.h"
 
 // ================= SimpleChartWidget =================
 
+const int SimpleChartWidget::kPointSpacing = 8;
+const int SimpleChartWidget::kLabelSpacing = 50;
+const double SimpleChartWidget::kTimeHeadroom = 0.25;
+const double SimpleChartWidget::kValueHeadroom = 0.1;
+const double SimpleChartWidget::kZoomStep = 0.8;
+const qint64 SimpleChartWidget::kMinTimeSpan = 1000;
+const qreal SimpleChartWindow::kExportScale = 2.0;
+
 SimpleChartWidget::SimpleChartWidget(QWidget *parent)
     : QWidget(parent)
+    , m_staticValid(false)
+    , m_dataValid(false)
+    , m_generation(0)
+    , m_requestedGeneration(-1)
+    , m_autoRange(true)
+    , m_minTime(0)
+    , m_maxTime(0)
+    , m_minValue(0)
+    , m_maxValue(0)
+    , m_dragging(false)
+    , m_dragStartX(0)
+    , m_dragMinTime(0)
+    , m_dragMaxTime(0)
 {
     setMinimumSize(600, 400);
+
+    // Кадр и экспорт могут рисоваться одновременно
+    m_pool.setMaxThreadCount(2);
+}
+
+SimpleChartWidget::~SimpleChartWidget()
+{
+    // Задания обращаются к поколению виджета
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+int SimpleChartWidget::indexOf(const QString &name) const
+{
+    for (int i = 0; i < m_series.size(); i++) {
+        if (m_series[i].name == name) return i;
+    }
+    return -1;
+}
+
+QColor SimpleChartWidget::nextColor() const
+{
+    // Первый ряд - прежний синий, остальные хорошо различимы на белом фоне
+    static const QRgb kPalette[] = {
+        0xFF0078D7, 0xFFE04B1A, 0xFF2CA02C, 0xFF9467BD,
+        0xFF8C564B, 0xFFD62790, 0xFF17BECF, 0xFFBCBD22
+    };
+    const int paletteSize = int(sizeof(kPalette) / sizeof(kPalette[0]));
+
+    // Первый цвет палитры, которого нет у показанных рядов
+    for (int i = 0; i < paletteSize; i++) {
+        const QColor color = QColor::fromRgba(kPalette[i]);
+        bool used = false;
+        for (const Series &series : m_series) {
+            used = used || series.color == color;
+        }
+        if (!used) return color;
+    }
+    return QColor::fromRgba(kPalette[m_series.size() % paletteSize]);
+}
+
+void SimpleChartWidget::setSeries(const QString &name, const QVector<qint64> &times, const QVector<double> &values)
+{
+    int index = indexOf(name);
+    if (index < 0) {
+        Series series;
+        series.name = name;
+        series.color = nextColor();
+        series.pointsDrawn = false;
+        series.labelStride = 1;
+        series.hasVertex = false;
+        m_series.append(series);
+        index = m_series.size() - 1;
+    }
+
+    m_series[index].data.setData(times, values);
+    updateRanges();
+    invalidateLayers();
+    update();
+}
+
+void SimpleChartWidget::appendSeries(const QString &name, const QVector<qint64> &times, const QVector<double> &values)
+{
+    const int index = indexOf(name);
+    if (index < 0) {
+        setSeries(name, times, values);
+        return;
+    }
+
+    const int count = qMin(times.size(), values.size());
+    for (int i = 0; i < count; i++) {
+        appendSample(index, times[i], values[i]);
+    }
+    if (count > 0) update();
+}
+
+void SimpleChartWidget::appendPoint(const QString &name, const QDateTime &time, double value)
+{
+    const int index = indexOf(name);
+    if (index < 0) {
+        setSeries(name, QVector<qint64>(1, time.toMSecsSinceEpoch()), QVector<double>(1, value));
+        return;
+    }
+
+    appendSample(index, time.toMSecsSinceEpoch(), value);
+    update();
 }
 
-void SimpleChartWidget::setData(const QVector<QDateTime> &times, const QVector<double> &values)
+void SimpleChartWidget::removeSeries(const QString &name)
 {
-    m_times = times;
-    m_values = values;
+    const int index = indexOf(name);
+    if (index < 0) return;
+
+    m_series.remove(index);
+    if (count() == 0) {
+        m_autoRange = true;
+    }
+    updateRanges();
+    invalidateLayers();
     update();
 }
 
 void SimpleChartWidget::setTitle(const QString &title)
 {
+    // Заголовок рисуется поверх слоев и их не сбрасывает
     m_title = title;
     update();
 }
 
 void SimpleChartWidget::clearData()
 {
-    m_times.clear();
-    m_values.clear();
+    m_series.clear();
+    m_autoRange = true;
+    invalidateLayers();
     update();
 }
 
-double SimpleChartWidget::findMinValue() const
+int SimpleChartWidget::count() const
 {
-    if (m_values.isEmpty()) return 0.0;
-    return *std::min_element(m_values.begin(), m_values.end());
+    int total = 0;
+    for (const Series &series : m_series) {
+        total += series.data.size();
+    }
+    return total;
 }
 
-double SimpleChartWidget::findMaxValue() const
+int SimpleChartWidget::count(const QString &name) const
 {
-    if (m_values.isEmpty()) return 0.0;
-    return *std::max_element(m_values.begin(), m_values.end());
+    const int index = indexOf(name);
+    return index < 0 ? 0 : m_series[index].data.size();
 }
 
-void SimpleChartWidget::paintEvent(QPaintEvent *event)
+void SimpleChartWidget::resetView()
 {
-    Q_UNUSED(event);
+    m_autoRange = true;
+    updateRanges();
+    invalidateLayers();
+    update();
+}
 
-    QPainter painter(this);
-    painter.setRenderHint(QPainter::Antialiasing);
+void SimpleChartWidget::appendSample(int index, qint64 time, double value)
+{
+    Series &series = m_series[index];
+    const bool inOrder = series.data.isEmpty() || time >= series.data.lastTime();
+    series.data.append(time, value);
+
+    // Первые две точки задают оси заново (у одной точки своя ось времени)
+    if (count() <= 2) {
+        updateRanges();
+        invalidateLayers();
+        return;
+    }
 
-    // Задний фон
-    painter.fillRect(rect(), QColor(255, 255, 255));
+    if (time < m_minTime || time > m_maxTime) {
+        if (m_autoRange) {
+            // Измерение вышло за оси с запасом
+            updateRanges();
+            invalidateLayers();
+        } else if (series.hasVertex) {
+            // Ряд ушел за край выбранного окна: линия должна дойти до края
+            invalidateData();
+        }
+        return;
+    }
 
-    if (m_times.isEmpty() || m_values.isEmpty() || m_times.size() != m_values.size()) {
-        painter.setPen(QColor(100, 100, 100));
-        painter.setFont(QFont("Arial", 14));
-        painter.drawText(rect(), Qt::AlignCenter, "Нет данных для отображения");
+    if (value < m_minValue || value > m_maxValue) {
+        updateRanges();
+        invalidateLayers();
+    } else if (!inOrder || !m_dataValid) {
+        // Заказанный кадр уже не содержит этого измерения
+        invalidateData();
+    } else {
+        appendToDataLayer(index);
+    }
+}
+
+void SimpleChartWidget::updateRanges()
+{
+    if (count() == 0) return;
+
+    if (m_autoRange) {
+        bool found = false;
+        qint64 firstTime = 0;
+        qint64 lastTime = 0;
+        for (const Series &series : m_series) {
+            if (series.data.isEmpty()) continue;
+            firstTime = found ? qMin(firstTime, series.data.firstTime()) : series.data.firstTime();
+            lastTime = found ? qMax(lastTime, series.data.lastTime()) : series.data.lastTime();
+            found = true;
+        }
+
+        m_minTime = firstTime;
+        const qint64 span = lastTime - firstTime;
+        if (span > 0) {
+            m_maxTime = lastTime + qint64(span * kTimeHeadroom);
+        } else {
+            m_maxTime = m_minTime + 24 * 60 * 60 * 1000; // 1 день для одной точки
+        }
+    }
+
+    // Ось значений - по видимому окну, пирамида рядов дает минимум и максимум
+    // отрезка без прохода по отсчетам
+    bool found = false;
+    double minValue = 0;
+    double maxValue = 0;
+    for (const Series &series : m_series) {
+        const int begin = series.data.lowerBound(m_minTime);
+        const int end = series.data.upperBound(m_maxTime);
+        if (begin >= end) continue;
+
+        double seriesMin, seriesMax;
+        series.data.valueRange(begin, end, &seriesMin, &seriesMax);
+        minValue = found ? qMin(minValue, seriesMin) : seriesMin;
+        maxValue = found ? qMax(maxValue, seriesMax) : seriesMax;
+        found = true;
+    }
+
+    // В пустом окне ось значений остается прежней
+    if (!found) {
+        if (m_maxValue <= m_minValue) {
+            m_minValue = -1.0;
+            m_maxValue = 1.0;
+        }
         return;
     }
 
-    drawTitle(painter);
-    drawChart(painter);
+    const double margin = maxValue > minValue ? (maxValue - minValue) * kValueHeadroom : 1.0;
+    m_minValue = minValue - margin;
+    m_maxValue = maxValue + margin;
 }
 
-void SimpleChartWidget::drawTitle(QPainter &painter)
+void SimpleChartWidget::setTimeWindow(qint64 minTime, qint64 maxTime)
 {
-    if (m_title.isEmpty()) return;
+    // Окно не уже kMinTimeSpan
+    if (maxTime - minTime < kMinTimeSpan) {
+        const qint64 center = minTime + (maxTime - minTime) / 2;
+        minTime = center - kMinTimeSpan / 2;
+        maxTime = minTime + kMinTimeSpan;
+    }
 
-    painter.setPen(QColor(0, 0, 0));
-    painter.setFont(QFont("Arial", 14, QFont::Bold));
+    m_autoRange = false;
+    m_minTime = minTime;
+    m_maxTime = maxTime;
+    updateRanges();
+    invalidateLayers();
+    update();
+}
 
-    QRect titleRect(0, 10, width(), 30);
-    painter.drawText(titleRect, Qt::AlignCenter, m_title);
+void SimpleChartWidget::invalidateLayers()
+{
+    m_staticValid = false;
+    m_dataValid = false;
+    m_generation.ref();
 }
 
-void SimpleChartWidget::drawChart(QPainter &painter)
+void SimpleChartWidget::invalidateData()
 {
-    QRect chartRect = rect().adjusted(80, 50, -40, -80);
+    m_dataValid = false;
+    m_generation.ref();
+}
 
-    drawGrid(painter, chartRect);
+QRect SimpleChartWidget::chartRect() const
+{
+    return rect().adjusted(80, 50, -40, -80);
+}
 
-    // Сначала рисуем точки (для одного измерения)
-    drawPoints(painter, chartRect);
+QPointF SimpleChartWidget::mapToChart(const QRect &chartRect, qint64 time, double value) const
+{
+    // Большие значения вверху. Отсчеты за краем окна остаются за краем
+    const double x = chartRect.left() + chartRect.width() * double(time - m_minTime) / (m_maxTime - m_minTime);
+    const double y = chartRect.bottom() - chartRect.height() * (value - m_minValue) / (m_maxValue - m_minValue);
+    return QPointF(x, y);
+}
 
-    // Затем рисуем линию (только если есть хотя бы 2 измерения)
-    if (m_times.size() >= 2) {
-        drawLine(painter, chartRect);
+QPointF SimpleChartWidget::vertexAt(const QRect &chartRect, qint64 time, double value) const
+{
+    // Тот же столбец пикселей, что у SeriesLod::decimate по окну осей
+    const int columns = chartRect.width();
+    const double scale = double(columns) / qMax<qint64>(1, m_maxTime - m_minTime);
+    const int column = qBound(0, int((time - m_minTime) * scale), columns - 1);
+    const double y = chartRect.bottom() - chartRect.height() * (value - m_minValue) / (m_maxValue - m_minValue);
+    return QPointF(chartRect.left() + column + 0.5, y);
+}
+
+qint64 SimpleChartWidget::timeAt(const QRect &chartRect, double x) const
+{
+    return m_minTime + qint64((x - chartRect.left()) / qMax(1, chartRect.width()) * (m_maxTime - m_minTime));
+}
+
+int SimpleChartWidget::visibleCount(const Series &series) const
+{
+    return series.data.upperBound(m_maxTime) - series.data.lowerBound(m_minTime);
+}
+
+int SimpleChartWidget::labelStride(const QRect &chartRect, int count) const
+{
+    const int width = qMax(1, chartRect.width());
+    return qMax(1, (count * kLabelSpacing + width - 1) / width);
+}
+
+void SimpleChartWidget::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    invalidateLayers();
+}
+
+void SimpleChartWidget::wheelEvent(QWheelEvent *event)
+{
+    const int delta = event->angleDelta().y();
+    if (count() == 0 || delta == 0) {
+        event->ignore();
+        return;
     }
 
-    drawAxes(painter, chartRect);
+    // Время под курсором остается на месте
+    const QRect rect = chartRect();
+    const double x = qBound<double>(rect.left(), event->posF().x(), rect.right());
+    const qint64 anchor = timeAt(rect, x);
+    const double factor = qPow(kZoomStep, delta / 120.0);
+    setTimeWindow(anchor - qint64((anchor - m_minTime) * factor),
+                  anchor + qint64((m_maxTime - anchor) * factor));
+    event->accept();
 }
 
-void SimpleChartWidget::drawGrid(QPainter &painter, const QRect &chartRect)
+void SimpleChartWidget::mousePressEvent(QMouseEvent *event)
 {
-    painter.setPen(QPen(QColor(230, 230, 230), 1));
+    if (event->button() != Qt::LeftButton || count() == 0) {
+        QWidget::mousePressEvent(event);
+        return;
+    }
 
-    // Вертикальные линии
-    int xSteps = 10;
-    for (int i = 0; i <= xSteps; i++) {
-        int x = chartRect.left() + (chartRect.width() * i) / xSteps;
-        painter.drawLine(x, chartRect.top(), x, chartRect.bottom());
+    m_dragging = true;
+    m_dragStartX = event->pos().x();
+    m_dragMinTime = m_minTime;
+    m_dragMaxTime = m_maxTime;
+    setCursor(Qt::ClosedHandCursor);
+    event->accept();
+}
+
+void SimpleChartWidget::mouseMoveEvent(QMouseEvent *event)
+{
+    if (!m_dragging) {
+        QWidget::mouseMoveEvent(event);
+        return;
     }
 
-    // Горизонтальные линии
-    int ySteps = 8;
-    for (int i = 0; i <= ySteps; i++) {
-        int y = chartRect.top() + (chartRect.height() * i) / ySteps;
-        painter.drawLine(chartRect.left(), y, chartRect.right(), y);
+    // Окно сдвигается вслед за курсором: пиксель - одна ширина столбца времени
+    const QRect rect = chartRect();
+    const qint64 span = m_dragMaxTime - m_dragMinTime;
+    const qint64 shift = qint64(double(m_dragStartX - event->pos().x()) * span / qMax(1, rect.width()));
+    if (m_dragMinTime + shift != m_minTime) {
+        setTimeWindow(m_dragMinTime + shift, m_dragMaxTime + shift);
     }
+    event->accept();
 }
 
-void SimpleChartWidget::drawLine(QPainter &painter, const QRect &chartRect)
+void SimpleChartWidget::mouseReleaseEvent(QMouseEvent *event)
 {
-    // Проверяем, что есть хотя бы 2 точки
-    if (m_times.size() < 2) {
+    if (!m_dragging) {
+        QWidget::mouseReleaseEvent(event);
         return;
     }
 
-    double minValue = findMinValue();
-    double maxValue = findMaxValue();
-    double valueRange = maxValue - minValue;
-    if (valueRange == 0) valueRange = 1;
+    m_dragging = false;
+    unsetCursor();
+    event->accept();
+}
+
+void SimpleChartWidget::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    Q_UNUSED(event);
+    resetView();
+}
 
-    // Подготавливаем перо для линии
-    QPen linePen(QColor(0, 120, 215), 2);
-    painter.setPen(linePen);
+void SimpleChartWidget::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
 
-    // Рисуем линию
-    qint64 minTime = m_times.first().toMSecsSinceEpoch();
-    qint64 maxTime = m_times.last().toMSecsSinceEpoch();
-    qint64 timeRange = maxTime - minTime;
-    if (timeRange == 0) timeRange = 1;
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
 
-    for (int i = 0; i < m_times.size() - 1; i++) {
-        int x1 = chartRect.left() + chartRect.width() *
-                 (m_times[i].toMSecsSinceEpoch() - minTime) / timeRange;
-        int x2 = chartRect.left() + chartRect.width() *
-                 (m_times[i+1].toMSecsSinceEpoch() - minTime) / timeRange;
+    if (count() == 0) {
+        // Задний фон
+        painter.fillRect(rect(), QColor(255, 255, 255));
+        painter.setPen(QColor(100, 100, 100));
+        painter.setFont(QFont("Arial", 14));
+        painter.drawText(rect(), Qt::AlignCenter, "Нет данных для отображения");
+        return;
+    }
 
-        // Нормализуем Y (значения) - инвертируем ось Y (большие значения внизу)
-        int y1 = chartRect.bottom() - chartRect.height() *
-                 (m_values[i] - minValue) / valueRange;
-        int y2 = chartRect.bottom() - chartRect.height() *
-                 (m_values[i+1] - minValue) / valueRange;
+    // Недействительные слои заказываются пулу один раз на поколение,
+    // пока кадр не готов, на экране остается предыдущий
+    if ((!m_staticValid || !m_dataValid) && m_requestedGeneration != m_generation.loadAcquire()) {
+        requestFrame();
+    }
 
-        painter.drawLine(x1, y1, x2, y2);
+    if (m_staticLayer.isNull()) {
+        painter.fillRect(rect(), QColor(255, 255, 255));
+    } else {
+        painter.drawImage(0, 0, m_staticLayer);
     }
+    if (!m_dataLayer.isNull()) {
+        painter.drawImage(0, 0, m_dataLayer);
+    }
+
+    ChartRenderer::drawTitle(painter, m_title, width());
+
+    QStringList names;
+    QVector<QColor> colors;
+    for (const Series &series : m_series) {
+        names.append(series.name);
+        colors.append(series.color);
+    }
+    ChartRenderer::drawLegend(painter, chartRect(), names, colors);
 }
 
-void SimpleChartWidget::drawPoints(QPainter &painter, const QRect &chartRect)
+ChartScene SimpleChartWidget::buildScene(qreal ratio, QVector<FrameState> *states) const
 {
-    if (m_times.isEmpty()) return;
+    ChartScene scene;
+    scene.size = size();
+    scene.ratio = ratio;
+    scene.chartRect = chartRect();
+    scene.minTime = m_minTime;
+    scene.maxTime = m_maxTime;
+    scene.minValue = m_minValue;
+    scene.maxValue = m_maxValue;
+    scene.singlePoint = count() == 1;
+    scene.title = m_title;
+
+    if (!states) return scene;
+
+    const QRect &rect = scene.chartRect;
+    const double scale = rect.height() / (m_maxValue - m_minValue);
+    auto yOf = [&](double value) { return rect.bottom() - (value - m_minValue) * scale; };
+
+    states->resize(m_series.size());
+    scene.lines.reserve(m_series.size());
+    for (int s = 0; s < m_series.size(); s++) {
+        const Series &series = m_series[s];
+        const SeriesLod &data = series.data;
+        const int begin = data.lowerBound(m_minTime);
+        const int end = data.upperBound(m_maxTime);
+
+        ChartScene::Line line;
+        line.name = series.name;
+        line.color = series.color;
+
+        // Соседние с окном отсчеты: линия уходит за края графика, а не обрывается
+        if (begin > 0) {
+            line.polyline.append(mapToChart(rect, data.times()[begin - 1], data.values()[begin - 1]));
+        }
 
-    double minValue = findMinValue();
-    double maxValue = findMaxValue();
-    double valueRange = maxValue - minValue;
-    if (valueRange == 0) valueRange = 1;
+        // Видимое окно по столбцам пикселей, не больше четырех вершин на столбец:
+        // первое, минимум, максимум, последнее
+        if (begin < end) {
+            const QVector<SeriesLod::Column> columns = data.decimate(m_minTime, m_maxTime, rect.width());
+            line.polyline.reserve(line.polyline.size() + columns.size() * 4 + 1);
+            for (int c = 0; c < columns.size(); c++) {
+                const SeriesLod::Column &column = columns[c];
+                if (column.count == 0) continue;
+
+                const double x = rect.left() + c + 0.5;
+                line.polyline.append(QPointF(x, yOf(column.first)));
+                if (column.count > 1) {
+                    line.polyline.append(QPointF(x, yOf(column.min)));
+                    line.polyline.append(QPointF(x, yOf(column.max)));
+                    line.polyline.append(QPointF(x, yOf(column.last)));
+                }
+            }
+        }
 
-    qint64 minTime, maxTime, timeRange;
+        if (end < data.size()) {
+            line.polyline.append(mapToChart(rect, data.times()[end], data.values()[end]));
+        }
 
-    // Определяем диапазон времени
-    if (m_times.size() == 1) {
-        minTime = m_times.first().toMSecsSinceEpoch();
-        maxTime = minTime + 24 * 60 * 60 * 1000; // 1 день для одной точки
-        timeRange = maxTime - minTime;
-    } else {
-        minTime = m_times.first().toMSecsSinceEpoch();
-        maxTime = m_times.last().toMSecsSinceEpoch();
-        timeRange = maxTime - minTime;
-        if (timeRange == 0) timeRange = 1;
+        // Точки и подписи - только для одного ряда и пока они не сливаются
+        FrameState &state = (*states)[s];
+        state.pointsDrawn = m_series.size() == 1 && (end - begin) * kPointSpacing <= rect.width();
+        state.labelStride = labelStride(rect, end - begin);
+        if (state.pointsDrawn) {
+            for (int i = begin; i < end; i++) {
+                line.points.append(mapToChart(rect, data.times()[i], data.values()[i]));
+                line.values.append(data.values()[i]);
+                line.labels.append(i % state.labelStride == 0);
+            }
+        }
+
+        state.hasVertex = !data.isEmpty() && data.lastTime() >= m_minTime && data.lastTime() <= m_maxTime;
+        if (state.hasVertex) {
+            state.lastVertex = vertexAt(rect, data.lastTime(), data.values().last());
+        }
+
+        scene.lines.append(line);
+    }
+    return scene;
+}
+
+class SimpleChartWidget::FrameJob : public QRunnable
+{
+public:
+    FrameJob(SimpleChartWidget *widget, QSharedPointer<const ChartScene> scene,
+             bool renderStatic, bool renderData, int generation)
+        : m_widget(widget), m_scene(scene), m_static(renderStatic), m_data(renderData),
+          m_generation(generation)
+    {
     }
 
-    painter.setBrush(QColor(255, 50, 50));
-    painter.setPen(QPen(QColor(200, 0, 0), 1));
+    void run() override
+    {
+        const QAtomicInt *current = &m_widget->m_generation;
+        if (current->loadAcquire() != m_generation) return;
 
-    for (int i = 0; i < m_times.size(); i++) {
-        // Для одной точки размещаем ее в начале диапазона (не в середине!)
-        int x;
-        if (m_times.size() == 1) {
-            x = chartRect.left(); // Размещаем в начале оси X
-        } else {
-            x = chartRect.left() + chartRect.width() *
-                (m_times[i].toMSecsSinceEpoch() - minTime) / timeRange;
+        QImage staticLayer;
+        if (m_static) {
+            staticLayer = ChartRenderer::renderStatic(*m_scene);
         }
 
-        int y = chartRect.bottom() - chartRect.height() *
-                (m_values[i] - minValue) / valueRange;
+        QImage dataLayer;
+        if (m_data) {
+            dataLayer = ChartRenderer::renderData(*m_scene, current, m_generation);
+            if (dataLayer.isNull()) return;
+        }
 
-        // Рисуем точку с обводкой
-        painter.drawEllipse(QPoint(x, y), 5, 5);
+        // Пока кадр рисовался, слои успели сбросить еще раз
+        if (current->loadAcquire() != m_generation) return;
 
-        // Подписи значений для всех точек, если их мало
-        if (m_times.size() <= 10 || i % 5 == 0) {
-            painter.save();
-            painter.setPen(QColor(0, 0, 0));
-            painter.setFont(QFont("Arial", 8));
+        SimpleChartWidget *widget = m_widget;
+        const int generation = m_generation;
+        QMetaObject::invokeMethod(widget, [widget, generation, staticLayer, dataLayer]() {
+            widget->onFrameRendered(generation, staticLayer, dataLayer);
+        }, Qt::QueuedConnection);
+    }
 
-            QString valueText = QString::number(m_values[i], 'f', 1);
-            QRect textRect(x - 25, y - 25, 50, 20);
-            painter.drawText(textRect, Qt::AlignCenter, valueText);
-            painter.restore();
-        }
+private:
+    SimpleChartWidget *m_widget;
+    QSharedPointer<const ChartScene> m_scene;
+    bool m_static;
+    bool m_data;
+    int m_generation;
+};
+
+class SimpleChartWidget::ExportJob : public QRunnable
+{
+public:
+    ExportJob(SimpleChartWidget *widget, QSharedPointer<const ChartScene> scene, const QString &fileName)
+        : m_widget(widget), m_scene(scene), m_fileName(fileName)
+    {
+    }
+
+    void run() override
+    {
+        const bool ok = ChartRenderer::render(*m_scene).save(m_fileName);
+
+        SimpleChartWidget *widget = m_widget;
+        const QString fileName = m_fileName;
+        QMetaObject::invokeMethod(widget, [widget, fileName, ok]() {
+            emit widget->imageExported(fileName, ok);
+        }, Qt::QueuedConnection);
     }
+
+private:
+    SimpleChartWidget *m_widget;
+    QSharedPointer<const ChartScene> m_scene;
+    QString m_fileName;
+};
+
+void SimpleChartWidget::requestFrame()
+{
+    const int generation = m_generation.loadAcquire();
+    m_requestedGeneration = generation;
+
+    // Линии нужны, только если недействителен слой данных
+    QSharedPointer<const ChartScene> scene(
+        new ChartScene(buildScene(devicePixelRatioF(), m_dataValid ? nullptr : &m_frameStates)));
+    m_pool.start(new FrameJob(this, scene, !m_staticValid, !m_dataValid, generation));
 }
-void SimpleChartWidget::drawAxes(QPainter &painter, const QRect &chartRect)
+
+void SimpleChartWidget::onFrameRendered(int generation, const QImage &staticLayer, const QImage &dataLayer)
 {
-    painter.setPen(QPen(Qt::black, 2));
+    // Кадр снят до последнего изменения данных, окна или размера
+    if (generation != m_generation.loadAcquire()) return;
 
-    // Ось X
-    painter.drawLine(chartRect.left(), chartRect.bottom(),
-                     chartRect.right(), chartRect.bottom());
+    if (!staticLayer.isNull()) {
+        m_staticLayer = staticLayer;
+        m_staticValid = true;
+    }
 
-    // Ось Y
-    painter.drawLine(chartRect.left(), chartRect.top(),
-                     chartRect.left(), chartRect.bottom());
+    if (!dataLayer.isNull()) {
+        m_dataLayer = dataLayer;
+        m_dataValid = true;
+        for (int i = 0; i < m_series.size() && i < m_frameStates.size(); i++) {
+            const FrameState &state = m_frameStates[i];
+            m_series[i].pointsDrawn = state.pointsDrawn;
+            m_series[i].labelStride = state.labelStride;
+            m_series[i].hasVertex = state.hasVertex;
+            m_series[i].lastVertex = state.lastVertex;
+        }
+    }
 
-    // Подписи оси Y
-    painter.setPen(QColor(100, 100, 100));
-    painter.setFont(QFont("Arial", 9));
+    update();
+}
 
-    double minValue = findMinValue();
-    double maxValue = findMaxValue();
-    double valueRange = maxValue - minValue;
+void SimpleChartWidget::exportImage(const QString &fileName, qreal scale)
+{
+    // Снимок строится сразу: пока файл пишется, данные могут измениться
+    QVector<FrameState> states;
+    QSharedPointer<const ChartScene> scene(new ChartScene(buildScene(qMax<qreal>(1, scale), &states)));
+    m_pool.start(new ExportJob(this, scene, fileName));
+}
 
-    // Для одной точки делаем небольшой диапазон
-    if (minValue == maxValue) {
-        minValue -= 1.0;
-        maxValue += 1.0;
-        valueRange = 2.0;
+void SimpleChartWidget::appendToDataLayer(int index)
+{
+    Series &series = m_series[index];
+    const QRect rect = chartRect();
+
+    // Точки перестали помещаться или сменился шаг подписей - слой рисуется заново
+    const int visible = visibleCount(series);
+    const bool points = m_series.size() == 1 && visible * kPointSpacing <= rect.width();
+    if (points != series.pointsDrawn || (points && labelStride(rect, visible) != series.labelStride)) {
+        invalidateData();
+        return;
+    }
+
+    // Ряд входит в окно из-за левого края - линия от края рисуется целиком
+    if (!series.hasVertex && series.data.size() > 1) {
+        invalidateData();
+        return;
     }
 
-    // Рисуем 5 делений на оси Y
-    for (int i = 0; i <= 5; i++) {
-        double value = minValue + (maxValue - minValue) * i / 5;
-        int y = chartRect.bottom() - chartRect.height() * i / 5;
+    // Один отрезок дешевле заказа кадра, он дорисовывается прямо в готовый слой
+    QPainter painter(&m_dataLayer);
+    painter.setRenderHint(QPainter::Antialiasing);
 
-        // Горизонтальная черточка на оси
-        painter.setPen(QPen(Qt::black, 1));
-        painter.drawLine(chartRect.left() - 5, y, chartRect.left(), y);
+    const int last = series.data.size() - 1;
+    const QPointF vertex = vertexAt(rect, series.data.times()[last], series.data.values()[last]);
+    if (series.hasVertex) {
+        ChartRenderer::drawSegment(painter, series.color, series.lastVertex, vertex);
+    }
+    series.hasVertex = true;
+    series.lastVertex = vertex;
 
-        // Подпись значения
-        painter.setPen(QColor(100, 100, 100));
-        QString label = QString::number(value, 'f', 1);
-        QRect labelRect(chartRect.left() - 75, y - 10, 65, 20);
-        painter.drawText(labelRect, Qt::AlignRight | Qt::AlignVCenter, label);
+    if (points) {
+        const QPointF point = mapToChart(rect, series.data.times()[last], series.data.values()[last]);
+        ChartRenderer::drawPoint(painter, point, series.data.values()[last], last % series.labelStride == 0);
     }
+}
+
+// ================= HistogramWidget =================
+
+HistogramWidget::HistogramWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    setMinimumSize(300, 200);
+}
+
+void HistogramWidget::setHistogram(const RadiationHistogram &histogram, const QString &title)
+{
+    m_histogram = histogram;
+    m_title = title;
+    update();
+}
+
+void HistogramWidget::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    painter.fillRect(rect(), QColor(255, 255, 255));
 
-    // Название оси Y
-    painter.save();
-    painter.translate(30, chartRect.top() + chartRect.height() / 2);
-    painter.rotate(-90);
     painter.setPen(QColor(0, 0, 0));
     painter.setFont(QFont("Arial", 10, QFont::Bold));
-    painter.drawText(QRect(-200, 0, 400, 20), Qt::AlignCenter, "Уровень излучения (дБм)");
-    painter.restore();
-
-    // Подписи оси X (время)
-    if (!m_times.isEmpty()) {
-        qint64 minTime, maxTime, timeRange;
-
-        if (m_times.size() == 1) {
-            minTime = m_times.first().toMSecsSinceEpoch();
-            maxTime = minTime + 24 * 60 * 60 * 1000; // Добавляем 1 день для одной точки
-            timeRange = maxTime - minTime;
-
-            // Для одной точки создаем 3 метки: начало, середина и конец диапазона
-            for (int i = 0; i <= 2; i++) {
-                qint64 currentTime = minTime + (timeRange * i / 2);
-                QDateTime timeLabel = QDateTime::fromMSecsSinceEpoch(currentTime);
-
-                int x = chartRect.left() + chartRect.width() * i / 2;
-
-                // Вертикальная черточка на оси
-                painter.setPen(QPen(Qt::black, 1));
-                painter.drawLine(x, chartRect.bottom(), x, chartRect.bottom() + 5);
-
-                // Подпись времени
-                painter.setPen(QColor(100, 100, 100));
-                QString label;
-                if (i == 0) {
-                    label = timeLabel.toString("dd.MM.yyyy\nHH:mm:ss");
-                } else if (i == 2) {
-                    label = timeLabel.toString("dd.MM.yyyy\nHH:mm:ss");
-                } else {
-                    label = timeLabel.toString("HH:mm:ss");
-                }
+    painter.drawText(QRect(0, 5, width(), 20), Qt::AlignCenter,
+                     m_histogram.isEmpty() ? m_title
+                                           : QString("%1 (%2 измерений)").arg(m_title).arg(m_histogram.total()));
 
-                QRect labelRect(x - 40, chartRect.bottom() + 10, 80, 40);
-                painter.drawText(labelRect, Qt::AlignCenter, label);
-            }
-        } else {
-            minTime = m_times.first().toMSecsSinceEpoch();
-            maxTime = m_times.last().toMSecsSinceEpoch();
-            timeRange = maxTime - minTime;
-            if (timeRange == 0) timeRange = 1;
-
-            // Рисуем до 5 делений на оси X
-            int steps = qMin(5, m_times.size());
-            for (int i = 0; i <= steps; i++) {
-                int idx = m_times.size() * i / steps;
-                if (idx >= m_times.size()) idx = m_times.size() - 1;
-
-                int x = chartRect.left() + chartRect.width() *
-                        (m_times[idx].toMSecsSinceEpoch() - minTime) / timeRange;
-
-                // Вертикальная черточка на оси
-                painter.setPen(QPen(Qt::black, 1));
-                painter.drawLine(x, chartRect.bottom(), x, chartRect.bottom() + 5);
-
-                // Подпись времени
-                painter.setPen(QColor(100, 100, 100));
-                QString label = m_times[idx].toString("dd.MM.yy\nHH:mm");
-
-                QRect labelRect(x - 40, chartRect.bottom() + 10, 80, 40);
-                painter.drawText(labelRect, Qt::AlignCenter, label);
-            }
-        }
+    if (m_histogram.isEmpty()) {
+        painter.setPen(QColor(100, 100, 100));
+        painter.setFont(QFont("Arial", 10));
+        painter.drawText(rect(), Qt::AlignCenter, "Нет данных для отображения");
+        return;
+    }
+
+    const QRect chartRect = rect().adjusted(50, 30, -15, -35);
+    const int bins = m_histogram.binCount();
+    const double barWidth = double(chartRect.width()) / bins;
+    const double scale = double(chartRect.height()) / m_histogram.maxCount();
+
+    // Столбец корзины - цветом полосы легенды, в которую она попадает
+    painter.setPen(Qt::NoPen);
+    for (int i = 0; i < bins; i++) {
+        const int count = m_histogram.count(i);
+        if (count == 0) continue;
+
+        const double level = i == bins - 1 ? m_histogram.binLower(i) + RadiationHistogram::kBinWidth
+                                           : m_histogram.binUpper(i);
+        const double height = count * scale;
+        painter.setBrush(ZoneAppearance::bandColor(ZoneAppearance::bandFor(level)));
+        painter.drawRect(QRectF(chartRect.left() + i * barWidth, chartRect.bottom() - height,
+                                barWidth - 1, height));
+    }
+
+    // Оси
+    painter.setPen(QPen(Qt::black, 1));
+    painter.drawLine(chartRect.left(), chartRect.bottom(), chartRect.right(), chartRect.bottom());
+    painter.drawLine(chartRect.left(), chartRect.top(), chartRect.left(), chartRect.bottom());
 
-        // Название оси X
-        painter.setPen(QColor(0, 0, 0));
-        painter.setFont(QFont("Arial", 10, QFont::Bold));
-        painter.drawText(QRect(chartRect.left(), chartRect.bottom() + 60,
-                              chartRect.width(), 20),
-                        Qt::AlignCenter, "Время");
+    painter.setFont(QFont("Arial", 8));
+    painter.setPen(QColor(100, 100, 100));
+    painter.drawText(QRect(0, chartRect.top() - 8, chartRect.left() - 5, 16),
+                     Qt::AlignRight | Qt::AlignVCenter, QString::number(m_histogram.maxCount()));
+    painter.drawText(QRect(0, chartRect.bottom() - 8, chartRect.left() - 5, 16),
+                     Qt::AlignRight | Qt::AlignVCenter, "0");
+
+    // Подписи шкалы через 10 дБм по границам корзин, крайние корзины - вне шкалы
+    for (double level = RadiationHistogram::kMinLevel; level <= RadiationHistogram::kMaxLevel; level += 10) {
+        const double x = chartRect.left() + barWidth * (1 + (level - RadiationHistogram::kMinLevel) / RadiationHistogram::kBinWidth);
+        painter.drawLine(QPointF(x, chartRect.bottom()), QPointF(x, chartRect.bottom() + 4));
+        painter.drawText(QRectF(x - 20, chartRect.bottom() + 5, 40, 14), Qt::AlignCenter, QString::number(level));
     }
+
+    painter.setPen(QColor(0, 0, 0));
+    painter.drawText(QRect(chartRect.left(), chartRect.bottom() + 18, chartRect.width(), 14),
+                     Qt::AlignCenter, "Уровень излучения (дБм)");
 }
 
 // ================= SimpleChartWindow =================
@@ -335,13 +774,23 @@ SimpleChartWindow::SimpleChartWindow(DataStorage *dataStorage, QWidget *parent)
     : QMainWindow(parent)
     , m_dataStorage(dataStorage)
     , m_chartWidget(nullptr)
+    , m_refresh(new RefreshScheduler(this))
+    , m_statsRows(0)
+    , m_statsWindowBox(nullptr)
+    , m_histogramWidget(nullptr)
+    , m_histogramSourceBox(nullptr)
 {
+    connect(m_refresh, &RefreshScheduler::refreshDue, this, &SimpleChartWindow::onRefreshDue);
+
     setWindowTitle("Аналитика измерений спутников");
     setMinimumSize(1000, 700);
     resize(1200, 800);
 
     setupUI();
     loadSatelliteList();
+    updateHistogramCities();
+    updateHistogram();
+    updateRefreshPause();
 }
 
 SimpleChartWindow::~SimpleChartWindow()
@@ -358,20 +807,34 @@ void SimpleChartWindow::setupUI()
     // Панель управления
     QHBoxLayout *controlLayout = new QHBoxLayout();
 
-    QLabel *titleLabel = new QLabel("Выберите спутник для анализа:", this);
+    QLabel *titleLabel = new QLabel("Выберите спутники для анализа (Ctrl - несколько, колесо - масштаб, "
+                                    "перетаскивание - сдвиг):", this);
 
+    QPushButton *resetViewBtn = new QPushButton("Весь период", this);
     QPushButton *exportImageBtn = new QPushButton("Экспорт графика", this);
     QPushButton *exportDataBtn = new QPushButton("Экспорт данных", this);
 
+    connect(resetViewBtn, &QPushButton::clicked, this, [this]() { m_chartWidget->resetView(); });
     connect(exportImageBtn, &QPushButton::clicked, this, &SimpleChartWindow::onExportImageClicked);
     connect(exportDataBtn, &QPushButton::clicked, this, &SimpleChartWindow::onExportDataClicked);
 
+    m_refreshRateBox = new QSpinBox(this);
+    m_refreshRateBox->setRange(1, 60);
+    m_refreshRateBox->setSuffix(" обн/с");
+    m_refreshRateBox->setValue(m_refresh->rate());
+    connect(m_refreshRateBox, QOverload<int>::of(&QSpinBox::valueChanged),
+            this, &SimpleChartWindow::setRefreshRate);
+
     // Подключаем сигналы от DataStorage
     connect(m_dataStorage, &DataStorage::dataAdded, this, &SimpleChartWindow::dataAdded);
     connect(m_dataStorage, &DataStorage::satelliteAdded, this, &SimpleChartWindow::satelliteAdded);
+    connect(m_dataStorage, &DataStorage::dataCleared, this, &SimpleChartWindow::dataCleared);
 
     controlLayout->addWidget(titleLabel);
     controlLayout->addStretch();
+    controlLayout->addWidget(new QLabel("Частота обновления:", this));
+    controlLayout->addWidget(m_refreshRateBox);
+    controlLayout->addWidget(resetViewBtn);
     controlLayout->addWidget(exportImageBtn);
     controlLayout->addWidget(exportDataBtn);
 
@@ -386,8 +849,10 @@ void SimpleChartWindow::setupUI()
 
     m_satelliteList = new QListWidget(this);
     m_satelliteList->setMaximumWidth(250);
-    connect(m_satelliteList, &QListWidget::itemClicked,
-            this, &SimpleChartWindow::onSatelliteSelected);
+    // Несколько выделенных спутников рисуются на одном графике
+    m_satelliteList->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    connect(m_satelliteList, &QListWidget::itemSelectionChanged,
+            this, &SimpleChartWindow::onSelectionChanged);
 
     leftLayout->addWidget(new QLabel("Список спутников:", this));
     leftLayout->addWidget(m_satelliteList);
@@ -397,6 +862,7 @@ void SimpleChartWindow::setupUI()
     QVBoxLayout *rightLayout = new QVBoxLayout(rightPanel);
 
     m_chartWidget = new SimpleChartWidget(this);
+    connect(m_chartWidget, &SimpleChartWidget::imageExported, this, &SimpleChartWindow::onImageExported);
     rightLayout->addWidget(new QLabel("График зависимости излучения от времени:", this));
     rightLayout->addWidget(m_chartWidget);
 
@@ -409,8 +875,40 @@ void SimpleChartWindow::setupUI()
     m_statsTable->verticalHeader()->setVisible(false);
     m_statsTable->setMaximumHeight(200);
 
-    rightLayout->addWidget(new QLabel("Статистика измерений:", this));
-    rightLayout->addWidget(m_statsTable);
+    // Период статистики: последние N часов до самого позднего измерения
+    m_statsWindowBox = new QSpinBox(this);
+    m_statsWindowBox->setRange(0, 24 * 30);
+    m_statsWindowBox->setSuffix(" ч");
+    m_statsWindowBox->setSpecialValueText("весь период");
+    connect(m_statsWindowBox, QOverload<int>::of(&QSpinBox::valueChanged),
+            this, &SimpleChartWindow::setStatisticsWindow);
+
+    QHBoxLayout *statsHeaderLayout = new QHBoxLayout();
+    statsHeaderLayout->addWidget(new QLabel("Статистика измерений:", this));
+    statsHeaderLayout->addStretch();
+    statsHeaderLayout->addWidget(new QLabel("За последние:", this));
+    statsHeaderLayout->addWidget(m_statsWindowBox);
+
+    rightLayout->addLayout(statsHeaderLayout);
+
+    // Распределение уровня рядом с таблицей статистики
+    m_histogramSourceBox = new QComboBox(this);
+    m_histogramSourceBox->addItem("Выбранные спутники", QString());
+    connect(m_histogramSourceBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this]() {
+        setHistogramSource(m_histogramSourceBox->currentData().toString());
+    });
+
+    m_histogramWidget = new HistogramWidget(this);
+    m_histogramWidget->setMaximumHeight(200);
+
+    QVBoxLayout *histogramLayout = new QVBoxLayout();
+    histogramLayout->addWidget(m_histogramSourceBox);
+    histogramLayout->addWidget(m_histogramWidget);
+
+    QHBoxLayout *statsLayout = new QHBoxLayout();
+    statsLayout->addWidget(m_statsTable);
+    statsLayout->addLayout(histogramLayout);
+    rightLayout->addLayout(statsLayout);
 
     // Добавляем панели в разделитель
     mainSplitter->addWidget(leftPanel);
@@ -429,6 +927,7 @@ void SimpleChartWindow::loadSatelliteList()
 
     QStringList satellites = m_dataStorage->getAllSatelliteNames();
     m_satelliteList->clear();
+    m_listItems.clear();
 
     qDebug() << "Загружаются спутники:" << satellites;
 
@@ -443,15 +942,11 @@ void SimpleChartWindow::updateSatelliteListItem(const QString &satelliteName)
 
     int count = m_dataStorage->getMeasurementCount(satelliteName);
 
-    // Проверяем, существует ли уже элемент с этим спутником
-    for (int i = 0; i < m_satelliteList->count(); ++i) {
-        QListWidgetItem *item = m_satelliteList->item(i);
-        if (item && item->data(Qt::UserRole).toString() == satelliteName) {
-            // Обновляем существующий элемент
-            item->setText(QString("%1 (%2 измерений)").arg(satelliteName).arg(count));
-            qDebug() << "Обновлен спутник:" << satelliteName << "измерений:" << count;
-            return;
-        }
+    // Вызывается на каждом обновлении: элемент ищется по имени без прохода по списку
+    QListWidgetItem *existing = m_listItems.value(satelliteName);
+    if (existing) {
+        existing->setText(QString("%1 (%2 измерений)").arg(satelliteName).arg(count));
+        return;
     }
 
     // Добавляем новый элемент, если его нет
@@ -460,91 +955,111 @@ void SimpleChartWindow::updateSatelliteListItem(const QString &satelliteName)
     );
     item->setData(Qt::UserRole, satelliteName);
     m_satelliteList->addItem(item);
+    m_listItems.insert(satelliteName, item);
     qDebug() << "Добавлен новый спутник в список:" << satelliteName << "измерений:" << count;
 }
 
-void SimpleChartWindow::onSatelliteSelected(QListWidgetItem *item)
+QStringList SimpleChartWindow::selectedSatellites() const
+{
+    // Порядок списка, чтобы цвета рядов не зависели от порядка выделения
+    QStringList names;
+    for (int i = 0; i < m_satelliteList->count(); ++i) {
+        QListWidgetItem *item = m_satelliteList->item(i);
+        if (item && item->isSelected()) {
+            names.append(item->data(Qt::UserRole).toString());
+        }
+    }
+    return names;
+}
+
+QString SimpleChartWindow::statisticsSatellite() const
 {
-    if (!item) return;
+    // Статистика - по последнему щелкнутому из выделенных спутников
+    QListWidgetItem *current = m_satelliteList->currentItem();
+    if (current && current->isSelected()) {
+        return current->data(Qt::UserRole).toString();
+    }
 
-    QString satelliteName = item->data(Qt::UserRole).toString();
+    const QStringList names = selectedSatellites();
+    return names.isEmpty() ? QString() : names.first();
+}
 
-    if (satelliteName.isEmpty()) {
-        qDebug() << "Пустое имя спутника";
-        return;
+void SimpleChartWindow::onSelectionChanged()
+{
+    const QStringList names = selectedSatellites();
+    qDebug() << "Выбраны спутники:" << names;
+
+    // Снятые с выделения ряды убираются, новые загружаются целиком,
+    // уже показанные остаются как есть
+    const QStringList shown = m_chartRows.keys();
+    for (const QString &satelliteName : shown) {
+        if (!names.contains(satelliteName)) {
+            m_chartRows.remove(satelliteName);
+            m_chartWidget->removeSeries(satelliteName);
+        }
+    }
+    for (const QString &satelliteName : names) {
+        if (!m_chartRows.contains(satelliteName)) {
+            loadSeries(satelliteName);
+        }
     }
 
-    qDebug() << "Выбран спутник:" << satelliteName;
+    updateChartTitle();
+    if (m_histogramCity.isEmpty()) {
+        updateHistogram();
+    }
 
-    updateChart(satelliteName);
-    updateStatistics(satelliteName);
+    const QString statsName = statisticsSatellite();
+    if (statsName.isEmpty()) {
+        m_statsSatellite.clear();
+        m_stats.clear();
+        m_statsTable->clearContents();
+    } else {
+        updateStatistics(statsName);
+    }
 }
 
-void SimpleChartWindow::updateChart(const QString &satelliteName)
+void SimpleChartWindow::loadSeries(const QString &satelliteName)
 {
     if (!m_dataStorage) {
         qDebug() << "DataStorage не доступен";
         return;
     }
 
-    QVariantList measurements = m_dataStorage->getMeasurementsBySatellite(satelliteName);
-    qDebug() << "Получено измерений для" << satelliteName << ":" << measurements.size();
+    // Столбцы времени и значений без форматирования и разбора строк,
+    // сортировку по времени при необходимости делает график
+    const MeasurementSeries series = m_dataStorage->getSeries(satelliteName);
+    qDebug() << "Получено измерений для" << satelliteName << ":" << series.times.size();
 
-    if (measurements.isEmpty()) {
-        m_chartWidget->setTitle("Нет данных для отображения");
-        m_chartWidget->clearData();
-        return;
-    }
+    // Строки хранилища, уже переданные графику: дальше дописываются только новые
+    m_chartRows[satelliteName] = series.rows;
+    m_chartWidget->setSeries(satelliteName, series.times, series.values);
+}
 
-    QVector<QDateTime> times;
-    QVector<double> values;
+void SimpleChartWindow::appendChart(const QString &satelliteName)
+{
+    if (!m_dataStorage) return;
 
-    foreach (const QVariant &item, measurements) {
-        QVariantMap map = item.toMap();
-        QString timeStr = map["time"].toString();
-        QDateTime time = QDateTime::fromString(timeStr, "yyyy-MM-dd HH:mm:ss");
+    // Спутник не показан на графике
+    auto shown = m_chartRows.find(satelliteName);
+    if (shown == m_chartRows.end()) return;
 
-        if (!time.isValid()) {
-            // Пробуем другой формат
-            time = QDateTime::fromString(timeStr, Qt::ISODate);
-            if (!time.isValid()) {
-                qDebug() << "Неверный формат времени:" << timeStr;
-                continue;
-            }
-        }
+    const MeasurementSeries series = m_dataStorage->getSeries(satelliteName, shown.value());
+    shown.value() = series.rows;
 
-        times.append(time);
-        values.append(map["radiation"].toDouble());
-    }
+    m_chartWidget->appendSeries(satelliteName, series.times, series.values);
+}
 
-    // Проверяем, что есть данные для отображения
-    if (times.isEmpty() || values.isEmpty() || times.size() != values.size()) {
+void SimpleChartWindow::updateChartTitle()
+{
+    const QStringList names = m_chartRows.keys();
+    if (names.isEmpty() || m_chartWidget->count() == 0) {
         m_chartWidget->setTitle("Нет данных для отображения");
-        m_chartWidget->clearData();
-        return;
-    }
-
-    // Сортируем по времени (только если есть более 1 измерения)
-    if (times.size() > 1) {
-        QVector<int> indices(times.size());
-        std::iota(indices.begin(), indices.end(), 0);
-        std::sort(indices.begin(), indices.end(),
-                  [&times](int a, int b) { return times[a] < times[b]; });
-
-        QVector<QDateTime> sortedTimes;
-        QVector<double> sortedValues;
-
-        for (int idx : indices) {
-            sortedTimes.append(times[idx]);
-            sortedValues.append(values[idx]);
-        }
-
-        times = sortedTimes;
-        values = sortedValues;
+    } else if (names.size() == 1) {
+        m_chartWidget->setTitle(QString("Спутник: %1 (%2 измерений)").arg(names.first()).arg(m_chartWidget->count()));
+    } else {
+        m_chartWidget->setTitle(QString("Спутников: %1 (%2 измерений)").arg(names.size()).arg(m_chartWidget->count()));
     }
-
-    m_chartWidget->setTitle(QString("Спутник: %1 (%2 измерений)").arg(satelliteName).arg(times.size()));
-    m_chartWidget->setData(times, values);
 }
 
 void SimpleChartWindow::updateStatistics(const QString &satelliteName)
@@ -553,87 +1068,113 @@ void SimpleChartWindow::updateStatistics(const QString &satelliteName)
         return;
     }
 
-    QVariantList measurements = m_dataStorage->getMeasurementsBySatellite(satelliteName);
-
-    if (measurements.isEmpty()) {
-        m_statsTable->clearContents();
-        return;
+    // Статистика другого спутника набирается с первой строки
+    if (satelliteName != m_statsSatellite) {
+        m_statsSatellite = satelliteName;
+        m_statsRows = 0;
+        m_stats.clear();
     }
 
-    // Собираем статистику
-    QVector<double> values;
-    QDateTime firstTime, lastTime;
+    // В статистику добавляются только строки, пришедшие после прошлого обновления
+    const MeasurementSeries series = m_dataStorage->getSeries(satelliteName, m_statsRows);
+    m_statsRows = series.rows;
+    m_stats.add(series.times, series.values);
 
-    foreach (const QVariant &item, measurements) {
-        QVariantMap map = item.toMap();
-        double value = map["radiation"].toDouble();
-        QString timeStr = map["time"].toString();
-        QDateTime time = QDateTime::fromString(timeStr, "yyyy-MM-dd HH:mm:ss");
+    showStatistics();
+}
 
-        if (!time.isValid()) {
-            time = QDateTime::fromString(timeStr, Qt::ISODate);
-        }
+void SimpleChartWindow::setHistogramSource(const QString &cityName)
+{
+    m_histogramCity = cityName;
+    updateHistogram();
+}
+
+void SimpleChartWindow::updateHistogramCities()
+{
+    if (!m_dataStorage) return;
 
-        values.append(value);
+    // Новые города дописываются в конец списка, выбранный пункт не меняется
+    const QStringList cities = m_dataStorage->histogramCities();
+    if (cities.size() + 1 == m_histogramSourceBox->count()) return;
 
-        if (time.isValid()) {
-            if (firstTime.isNull() || time < firstTime) firstTime = time;
-            if (lastTime.isNull() || time > lastTime) lastTime = time;
+    for (const QString &city : cities) {
+        if (m_histogramSourceBox->findData(city) < 0) {
+            m_histogramSourceBox->addItem(QString("Город: %1").arg(city), city);
         }
     }
+}
 
-    if (values.isEmpty()) {
-        m_statsTable->clearContents();
+void SimpleChartWindow::updateHistogram()
+{
+    if (!m_dataStorage) return;
+
+    if (!m_histogramCity.isEmpty()) {
+        m_histogramWidget->setHistogram(m_dataStorage->cityHistogram(m_histogramCity),
+                                        QString("Город %1").arg(m_histogramCity));
         return;
     }
 
-    // Вычисляем статистику
-    m_currentStats.count = values.size();
-    m_currentStats.min = *std::min_element(values.begin(), values.end());
-    m_currentStats.max = *std::max_element(values.begin(), values.end());
+    // Корзины выделенных спутников складываются
+    const QStringList names = selectedSatellites();
+    RadiationHistogram histogram;
+    for (const QString &satelliteName : names) {
+        histogram.add(m_dataStorage->satelliteHistogram(satelliteName));
+    }
 
-    double sum = std::accumulate(values.begin(), values.end(), 0.0);
-    m_currentStats.mean = sum / values.size();
+    QString title = "Распределение уровня";
+    if (names.size() == 1) {
+        title = QString("Спутник %1").arg(names.first());
+    } else if (names.size() > 1) {
+        title = QString("Спутников: %1").arg(names.size());
+    }
+    m_histogramWidget->setHistogram(histogram, title);
+}
 
-    // Медиана
-    if (values.size() >= 2) {
-        QVector<double> sortedValues = values;
-        std::sort(sortedValues.begin(), sortedValues.end());
-        if (sortedValues.size() % 2 == 0) {
-            m_currentStats.median = (sortedValues[sortedValues.size()/2 - 1] + sortedValues[sortedValues.size()/2]) / 2.0;
-        } else {
-            m_currentStats.median = sortedValues[sortedValues.size()/2];
-        }
-    } else {
-        m_currentStats.median = values.first();
+void SimpleChartWindow::setStatisticsWindow(int hours)
+{
+    m_stats.setWindow(qint64(hours) * 60 * 60 * 1000);
+
+    // Вышедшие из окна отсчеты удалены, статистика набирается заново
+    m_statsSatellite.clear();
+    const QString statsName = statisticsSatellite();
+    if (!statsName.isEmpty()) {
+        updateStatistics(statsName);
+    }
+}
+
+void SimpleChartWindow::showStatistics()
+{
+    if (m_stats.isEmpty()) {
+        m_statsTable->clearContents();
+        return;
     }
 
-    m_currentStats.firstMeasurement = firstTime;
-    m_currentStats.lastMeasurement = lastTime;
+    const QDateTime firstMeasurement = QDateTime::fromMSecsSinceEpoch(m_stats.firstTime());
+    const QDateTime lastMeasurement = QDateTime::fromMSecsSinceEpoch(m_stats.lastTime());
 
     // Обновляем таблицу
     m_statsTable->clearContents();
 
-    QString firstTimeStr = m_currentStats.firstMeasurement.isValid()
-        ? m_currentStats.firstMeasurement.toString("dd.MM.yyyy HH:mm")
+    QString firstTimeStr = firstMeasurement.isValid()
+        ? firstMeasurement.toString("dd.MM.yyyy HH:mm")
         : "Н/Д";
 
-    QString lastTimeStr = m_currentStats.lastMeasurement.isValid()
-        ? m_currentStats.lastMeasurement.toString("dd.MM.yyyy HH:mm")
+    QString lastTimeStr = lastMeasurement.isValid()
+        ? lastMeasurement.toString("dd.MM.yyyy HH:mm")
         : "Н/Д";
 
-    int daysDiff = m_currentStats.firstMeasurement.isValid() && m_currentStats.lastMeasurement.isValid()
-        ? m_currentStats.firstMeasurement.daysTo(m_currentStats.lastMeasurement)
+    int daysDiff = firstMeasurement.isValid() && lastMeasurement.isValid()
+        ? firstMeasurement.daysTo(lastMeasurement)
         : 0;
 
     QStringList statsData = {
-        QString("Количество измерений: %1").arg(m_currentStats.count),
+        QString("Количество измерений: %1").arg(m_stats.count()),
         QString("Временной диапазон: %1 - %2").arg(firstTimeStr).arg(lastTimeStr),
-        QString("Минимальное значение: %1 дБм").arg(m_currentStats.min, 0, 'f', 1),
-        QString("Максимальное значение: %1 дБм").arg(m_currentStats.max, 0, 'f', 1),
-        QString("Среднее значение: %1 дБм").arg(m_currentStats.mean, 0, 'f', 1),
-        QString("Медиана: %1 дБм").arg(m_currentStats.median, 0, 'f', 1),
-        QString("Размах значений: %1 дБм").arg(m_currentStats.max - m_currentStats.min, 0, 'f', 1),
+        QString("Минимальное значение: %1 дБм").arg(m_stats.min(), 0, 'f', 1),
+        QString("Максимальное значение: %1 дБм").arg(m_stats.max(), 0, 'f', 1),
+        QString("Среднее значение: %1 дБм").arg(m_stats.mean(), 0, 'f', 1),
+        QString("Медиана: %1 дБм").arg(m_stats.median(), 0, 'f', 1),
+        QString("Размах значений: %1 дБм").arg(m_stats.max() - m_stats.min(), 0, 'f', 1),
         QString("Всего дней измерений: %1").arg(daysDiff)
     };
 
@@ -656,30 +1197,128 @@ void SimpleChartWindow::onExportImageClicked()
     );
 
     if (!fileName.isEmpty()) {
-        QPixmap pixmap(m_chartWidget->size());
-        m_chartWidget->render(&pixmap);
+        // Файл рисуется и пишется в пуле графика, результат придет в onImageExported
+        m_chartWidget->exportImage(fileName, kExportScale);
+    }
+}
 
-        if (pixmap.save(fileName)) {
-            QMessageBox::information(this, "Успех",
-                QString("График успешно экспортирован в файл:\n%1").arg(fileName));
-        } else {
-            QMessageBox::warning(this, "Ошибка", "Не удалось сохранить изображение");
-        }
+void SimpleChartWindow::onImageExported(const QString &fileName, bool ok)
+{
+    if (ok) {
+        QMessageBox::information(this, "Успех",
+            QString("График успешно экспортирован в файл:\n%1").arg(fileName));
+    } else {
+        QMessageBox::warning(this, "Ошибка", "Не удалось сохранить изображение");
     }
 }
 
 void SimpleChartWindow::dataAdded(const QString &satelliteName, int totalCount)
 {
-    qDebug() << "Получен сигнал dataAdded для спутника:" << satelliteName << "всего измерений:" << totalCount;
+    Q_UNUSED(totalCount);
 
-    // Обновляем только элемент этого спутника, не перезагружая весь список
-    updateSatelliteListItem(satelliteName);
+    // Спутник только помечается, список, график и статистика обновятся
+    // в onRefreshDue один раз за период таймера
+    m_refresh->request(satelliteName);
+}
+
+void SimpleChartWindow::onRefreshDue(const QStringList &satelliteNames)
+{
+    const QString statsName = statisticsSatellite();
+    bool chartChanged = false;
+
+    for (const QString &satelliteName : satelliteNames) {
+        // Обновляем только элемент этого спутника, не перезагружая весь список
+        updateSatelliteListItem(satelliteName);
+
+        // Если этот спутник сейчас на графике, дописываем новые измерения
+        if (m_chartRows.contains(satelliteName)) {
+            appendChart(satelliteName);
+            chartChanged = true;
+        }
+        if (satelliteName == statsName) {
+            updateStatistics(satelliteName);
+        }
+    }
+
+    if (chartChanged) {
+        updateChartTitle();
+    }
+
+    // Корзины уже посчитаны хранилищем: обновление стоит O(корзин)
+    updateHistogramCities();
+    updateHistogram();
+    showRefreshCounters();
+}
+
+void SimpleChartWindow::setRefreshRate(int rate)
+{
+    m_refresh->setRate(rate);
+    if (m_refreshRateBox->value() != m_refresh->rate()) {
+        m_refreshRateBox->setValue(m_refresh->rate());
+    }
+}
+
+void SimpleChartWindow::showRefreshCounters()
+{
+    const RefreshScheduler::Counters &counters = m_refresh->counters();
+    statusBar()->showMessage(QString("Уведомлений: %1, обновлений: %2, объединено: %3, отложено при скрытом окне: %4")
+                             .arg(counters.requests)
+                             .arg(counters.refreshes)
+                             .arg(counters.coalesced)
+                             .arg(counters.deferred));
+}
+
+void SimpleChartWindow::updateRefreshPause()
+{
+    m_refresh->setPaused(!isVisible() || isMinimized());
+}
+
+void SimpleChartWindow::showEvent(QShowEvent *event)
+{
+    QMainWindow::showEvent(event);
+    updateRefreshPause();
+}
+
+void SimpleChartWindow::hideEvent(QHideEvent *event)
+{
+    QMainWindow::hideEvent(event);
+    updateRefreshPause();
+}
+
+void SimpleChartWindow::changeEvent(QEvent *event)
+{
+    QMainWindow::changeEvent(event);
+    if (event->type() == QEvent::WindowStateChange) {
+        updateRefreshPause();
+    }
+}
+
+void SimpleChartWindow::dataCleared()
+{
+    // Счетчики показанных строк больше не соответствуют хранилищу: после очистки
+    // оно может успеть заполниться снова, поэтому все выделенное читается заново
+    m_refresh->clear();
+    m_chartRows.clear();
+    m_chartWidget->clearData();
+    m_stats.clear();
+    m_statsRows = 0;
+    m_statsSatellite.clear();
+
+    // Удаленные спутники уходят из списка, у остальных обновляется число измерений
+    m_satelliteList->blockSignals(true);
+    const QStringList listed = m_listItems.keys();
+    for (const QString &satelliteName : listed) {
+        if (m_dataStorage->satelliteExists(satelliteName)) {
+            updateSatelliteListItem(satelliteName);
+        } else {
+            delete m_listItems.take(satelliteName);
+        }
+    }
+    m_satelliteList->blockSignals(false);
 
-    // Если этот спутник сейчас выбран, обновляем график
-    QList<QListWidgetItem*> selectedItems = m_satelliteList->selectedItems();
-    if (!selectedItems.isEmpty() && selectedItems.first()->data(Qt::UserRole).toString() == satelliteName) {
-        updateChart(satelliteName);
-        updateStatistics(satelliteName);
+    onSelectionChanged();
+    if (!m_histogramCity.isEmpty()) {
+        updateHistogram();
     }
 }
 
@@ -4,6 +4,9 @@
 #include <QMainWindow>
 #include <QWidget>
 #include <QPainter>
+#include <QImage>
+#include <QAtomicInt>
+#include <QThreadPool>
 #include <QVector>
 #include <QListWidget>
 #include <QTableWidget>
@@ -14,39 +17,181 @@
 #include <QSplitter>
 #include <QFileDialog>
 #include <QMessageBox>
+#include <QSpinBox>
+#include <QComboBox>
+#include <QStatusBar>
 #include <QDateTime>
+#include <QHash>
 #include <algorithm>
 #include <numeric>
 
 #include "data_storage.h"
+#include "radiation_histogram.h"
+#include "series_lod.h"
+#include "series_stats.h"
+#include "chart_renderer.h"
+#include "refresh_scheduler.h"
 
+// График уровня излучения спутников: один или несколько рядов поверх друг друга.
+// Каждый ряд хранится с пирамидой минимумов и максимумов (SeriesLod), и на
+// отрисовку берется только видимое окно времени, прореженное до ширины графика:
+// линия рисуется по столбцам пикселей, точки и подписи значений - только для
+// одного ряда и пока они не сливаются. Колесо мыши масштабирует время вокруг
+// курсора, перетаскивание сдвигает окно, двойной щелчок возвращает весь ряд.
+// Отрисовка разложена на два слоя: фон, сетка и оси перерисовываются только при
+// смене размера или диапазона осей, слой данных при добавлении измерений по
+// порядку времени дорисовывается новым отрезком. Диапазоны осей берутся с запасом,
+// поэтому живой график обычно стоит один отрезок на измерение.
+// Слои целиком рисует ChartRenderer в пуле потоков по неизменяемому снимку
+// (ChartScene), paintEvent только выводит последний готовый кадр. Кадр, снятый
+// до изменения данных, окна или размера, прерывается и отбрасывается
 class SimpleChartWidget : public QWidget
 {
     Q_OBJECT
 public:
     explicit SimpleChartWidget(QWidget *parent = nullptr);
+    ~SimpleChartWidget() override;
 
-    void setData(const QVector<QDateTime> &times, const QVector<double> &values);
+    // Ряд с именем name (время в мс от эпохи, как в DataStorage::getSeries).
+    // Новый ряд получает следующий цвет палитры
+    void setSeries(const QString &name, const QVector<qint64> &times, const QVector<double> &values);
+    // Добавление измерений к уже показанному ряду
+    void appendSeries(const QString &name, const QVector<qint64> &times, const QVector<double> &values);
+    void appendPoint(const QString &name, const QDateTime &time, double value);
+    void removeSeries(const QString &name);
+    bool hasSeries(const QString &name) const { return indexOf(name) >= 0; }
     void setTitle(const QString &title);
     void clearData();
 
+    // Измерений во всех рядах
+    int count() const;
+    int count(const QString &name) const;
+
+    // Вернуть окно времени по всем данным
+    void resetView();
+
+    // Текущий вид графика в файл с увеличенным в scale раз разрешением.
+    // Рисуется и сохраняется в пуле, по готовности приходит imageExported
+    void exportImage(const QString &fileName, qreal scale);
+
+signals:
+    void imageExported(const QString &fileName, bool ok);
+
 protected:
     void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
 
 private:
-    QVector<QDateTime> m_times;
-    QVector<double> m_values;
+    // Минимальное расстояние между точками и между подписями значений, пикселей
+    static const int kPointSpacing;
+    static const int kLabelSpacing;
+    // Запас диапазона осей от размаха ряда: справа по времени, с обеих сторон по значению
+    static const double kTimeHeadroom;
+    static const double kValueHeadroom;
+    // Масштаб на один шаг колеса и самое узкое окно времени, мс
+    static const double kZoomStep;
+    static const qint64 kMinTimeSpan;
+
+    struct Series {
+        QString name;
+        QColor color;
+        SeriesLod data;
+        // То, с чем ряд нарисован на слое данных
+        bool pointsDrawn;
+        int labelStride;
+        bool hasVertex;        // последний отсчет ряда виден
+        QPointF lastVertex;
+    };
+
+    QVector<Series> m_series;
     QString m_title;
 
-    void drawChart(QPainter &painter);
-    void drawGrid(QPainter &painter, const QRect &chartRect);
-    void drawLine(QPainter &painter, const QRect &chartRect);
-    void drawPoints(QPainter &painter, const QRect &chartRect);
-    void drawAxes(QPainter &painter, const QRect &chartRect);
-    void drawTitle(QPainter &painter);
+    // С чем ряд будет нарисован в запрошенном кадре
+    struct FrameState {
+        bool pointsDrawn;
+        int labelStride;
+        bool hasVertex;
+        QPointF lastVertex;
+    };
+
+    class FrameJob;
+    class ExportJob;
+    friend class FrameJob;
+    friend class ExportJob;
 
-    double findMinValue() const;
-    double findMaxValue() const;
+    // Последний готовый кадр. Слой недействителен, пока не придет кадр,
+    // снятый после последнего изменения
+    QImage m_staticLayer;
+    QImage m_dataLayer;
+    bool m_staticValid;
+    bool m_dataValid;
+
+    // Поколение меняется при каждом сбросе слоев: задания старых поколений
+    // прерываются, их кадры отбрасываются
+    QAtomicInt m_generation;
+    int m_requestedGeneration;
+    QVector<FrameState> m_frameStates;
+    QThreadPool m_pool;
+
+    // Видимое окно осей. В автоматическом режиме оно покрывает все данные,
+    // масштабирование и сдвиг переводят окно в ручной режим
+    bool m_autoRange;
+    qint64 m_minTime;
+    qint64 m_maxTime;
+    double m_minValue;
+    double m_maxValue;
+
+    // Перетаскивание: точка нажатия и окно времени в момент нажатия
+    bool m_dragging;
+    int m_dragStartX;
+    qint64 m_dragMinTime;
+    qint64 m_dragMaxTime;
+
+    int indexOf(const QString &name) const;
+    QColor nextColor() const;
+
+    void appendSample(int index, qint64 time, double value);
+    void updateRanges();
+    void setTimeWindow(qint64 minTime, qint64 maxTime);
+    void invalidateLayers();
+    void invalidateData();
+
+    QRect chartRect() const;
+    // Снимок для ChartRenderer. Линии рядов строятся, только если states задан
+    ChartScene buildScene(qreal ratio, QVector<FrameState> *states) const;
+    void requestFrame();
+    void onFrameRendered(int generation, const QImage &staticLayer, const QImage &dataLayer);
+    void appendToDataLayer(int index);
+
+    int visibleCount(const Series &series) const;
+    int labelStride(const QRect &chartRect, int count) const;
+    QPointF mapToChart(const QRect &chartRect, qint64 time, double value) const;
+    QPointF vertexAt(const QRect &chartRect, qint64 time, double value) const;
+    qint64 timeAt(const QRect &chartRect, double x) const;
+};
+
+// Распределение уровня излучения по корзинам RadiationHistogram. Столбцы
+// окрашены в цвета полос легенды карты (ZoneAppearance), отрисовка зависит
+// только от числа корзин, а не от числа измерений
+class HistogramWidget : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit HistogramWidget(QWidget *parent = nullptr);
+
+    void setHistogram(const RadiationHistogram &histogram, const QString &title);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    RadiationHistogram m_histogram;
+    QString m_title;
 };
 
 class SimpleChartWindow : public QMainWindow
@@ -57,38 +202,76 @@ public:
     explicit SimpleChartWindow(DataStorage *dataStorage, QWidget *parent = nullptr);
     ~SimpleChartWindow();
 
+    // Частота обновления графика, списка и статистики при поступлении данных
+    void setRefreshRate(int rate);
+    // Статистика за последние hours часов до самого позднего измерения, 0 - за весь период
+    void setStatisticsWindow(int hours);
+    // Распределение выделенных спутников (пустое имя) или города
+    void setHistogramSource(const QString &cityName);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+    void changeEvent(QEvent *event) override;
+
 private slots:
-    void onSatelliteSelected(QListWidgetItem *item);
+    void onSelectionChanged();
     void onExportDataClicked();
     void onExportImageClicked();
+    void onImageExported(const QString &fileName, bool ok);
     void dataAdded(const QString &satelliteName, int totalCount);
     void satelliteAdded(const QString &satelliteName);  // Новый слот!
+    // Очистка хранилища: графики и статистика загружаются заново
+    void dataCleared();
+    void onRefreshDue(const QStringList &satelliteNames);
 
 private:
+    // Экспорт в разрешении выше экранного
+    static const qreal kExportScale;
+
     void setupUI();
     void loadSatelliteList();
     void updateSatelliteListItem(const QString &satelliteName);  // Новая функция!
-    void updateChart(const QString &satelliteName);
+    QStringList selectedSatellites() const;
+    QString statisticsSatellite() const;
+    // Ряд спутника на график целиком
+    void loadSeries(const QString &satelliteName);
+    // Дописать на график строки хранилища, добавленные после последнего обновления
+    void appendChart(const QString &satelliteName);
+    void updateChartTitle();
+    // Дописать в статистику новые строки хранилища и показать ее
     void updateStatistics(const QString &satelliteName);
+    void showStatistics();
+    void updateHistogramCities();
+    void updateHistogram();
+    // Скрытое или свернутое окно не обновляется, данные копятся до показа
+    void updateRefreshPause();
+    void showRefreshCounters();
 
 private:
     DataStorage *m_dataStorage;
     QListWidget *m_satelliteList;
+    QHash<QString, QListWidgetItem *> m_listItems;  // элементы списка по имени спутника
     SimpleChartWidget *m_chartWidget;
     QTableWidget *m_statsTable;
+    QSpinBox *m_refreshRateBox;
 
-    // Статистика
-    struct Statistics {
-        int count;
-        double min;
-        double max;
-        double mean;
-        double median;
-        QDateTime firstMeasurement;
-        QDateTime lastMeasurement;
-    };
+    // Уведомления dataAdded объединяются по спутникам, обновление не чаще частоты таймера
+    RefreshScheduler *m_refresh;
+
+    // Спутники на графике и сколько строк хранилища каждого уже показано
+    QHash<QString, int> m_chartRows;
+
+    // Статистика одного спутника и сколько строк хранилища в нее уже вошло
+    SeriesStats m_stats;
+    QString m_statsSatellite;
+    int m_statsRows;
+    QSpinBox *m_statsWindowBox;
 
-    Statistics m_currentStats;
+    // Гистограмма берется из корзин DataStorage, пересчет по измерениям не нужен
+    HistogramWidget *m_histogramWidget;
+    QComboBox *m_histogramSourceBox;
+    QString m_histogramCity;
 };
 
 #endif // SIMPLECHARTWINDOW_H
@@ -0,0 +1,178 @@
+#include "simulation_clock.h"
+
+#include <QDebug>
+#include <QtMath>
+#include <cmath>
+
+namespace {
+const double kSecondsPerDay = 86400.0;
+}
+
+const int SimulationClock::kFrameIntervalMs = 16;
+const int SimulationClock::kTargetStepsPerFrame = 64;
+const int SimulationClock::kMaxStepsPerFrame = 256;
+const double SimulationClock::kMaxLagSeconds = 1.0;
+
+SimulationClock::SimulationClock(QObject *parent)
+    : QObject(parent)
+    , m_start(QDate(2025, 1, 1), QTime(6, 0))
+    , m_lagPolicy(CatchUp)
+    , m_timeScale(60.0)
+    , m_baseStep(1.0)
+    , m_step(1.0)
+    , m_time(0)
+    , m_accumulator(0)
+    , m_stepCount(0)
+{
+    m_timer.setInterval(kFrameIntervalMs);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &SimulationClock::onFrame);
+}
+
+void SimulationClock::setRunning(bool running)
+{
+    if (running == isRunning()) return;
+
+    if (running) {
+        m_frameClock.start();
+        m_timer.start();
+    } else {
+        m_timer.stop();
+    }
+    emit runningChanged();
+}
+
+void SimulationClock::setTimeScale(double scale)
+{
+    scale = qMax(0.0, scale);
+    if (qFuzzyCompare(m_timeScale, scale)) return;
+    m_timeScale = scale;
+    updateStep();
+    emit timeScaleChanged();
+}
+
+void SimulationClock::setStepSeconds(double seconds)
+{
+    if (seconds <= 0 || qFuzzyCompare(m_baseStep, seconds)) return;
+    m_baseStep = seconds;
+    updateStep();
+    emit timeScaleChanged();
+}
+
+void SimulationClock::setLagPolicy(LagPolicy policy)
+{
+    if (m_lagPolicy == policy) return;
+    m_lagPolicy = policy;
+    emit lagPolicyChanged();
+}
+
+void SimulationClock::updateStep()
+{
+    // Степени двойки от базового шага: при суммировании шагов время остается
+    // точным, а смена ускорения не дает дробных шагов
+    const double perFrame = m_timeScale * kFrameIntervalMs / 1000.0;
+    double step = m_baseStep;
+    while (perFrame / step > kTargetStepsPerFrame) {
+        step *= 2;
+    }
+
+    if (!qFuzzyCompare(m_step, step)) {
+        qDebug() << "SimulationClock: шаг" << step << "с при ускорении" << m_timeScale;
+    }
+    m_step = step;
+}
+
+double SimulationClock::days() const
+{
+    return m_time / kSecondsPerDay;
+}
+
+double SimulationClock::hour() const
+{
+    return hourAt(m_time);
+}
+
+double SimulationClock::daysAt(double time) const
+{
+    return time / kSecondsPerDay;
+}
+
+double SimulationClock::hourAt(double time) const
+{
+    double startHour = m_start.time().hour() + m_start.time().minute() / 60.0;
+    return std::fmod(startHour + time / 3600.0, 24.0);
+}
+
+int SimulationClock::dayOffset() const
+{
+    double startHour = m_start.time().hour() + m_start.time().minute() / 60.0;
+    return static_cast<int>((startHour + m_time / 3600.0) / 24);
+}
+
+QDateTime SimulationClock::dateTime() const
+{
+    return dateTimeAt(m_time);
+}
+
+QDateTime SimulationClock::dateTimeAt(double time) const
+{
+    return m_start.addMSecs(static_cast<qint64>(time * 1000));
+}
+
+void SimulationClock::runSteps(int steps)
+{
+    for (int i = 0; i < steps; i++) {
+        m_time += m_step;
+        m_stepCount++;
+        emit ticked(m_time, m_step);
+    }
+}
+
+void SimulationClock::onFrame()
+{
+    double elapsed = m_frameClock.restart() / 1000.0;
+    m_accumulator += elapsed * m_timeScale;
+
+    int steps = static_cast<int>(qMin<double>(std::floor(m_accumulator / m_step), kMaxStepsPerFrame));
+    m_accumulator -= steps * m_step;
+
+    if (steps == kMaxStepsPerFrame) {
+        if (m_lagPolicy == Skip) {
+            m_accumulator = std::fmod(m_accumulator, m_step);
+        } else {
+            // После долгой паузы цикла событий не догоняем бесконечно
+            m_accumulator = qMin(m_accumulator, kMaxLagSeconds * m_timeScale);
+        }
+    }
+
+    if (steps > 0) {
+        runSteps(steps);
+        emit frameAdvanced();
+    }
+}
+
+void SimulationClock::advance(double seconds)
+{
+    if (seconds <= 0) return;
+
+    m_accumulator += seconds;
+    // Погрешность деления не должна съедать последний шаг
+    qint64 steps = static_cast<qint64>(std::floor(m_accumulator / m_step + 1e-9));
+    m_accumulator = qMax(0.0, m_accumulator - steps * m_step);
+
+    while (steps > 0) {
+        int chunk = static_cast<int>(qMin<qint64>(steps, kMaxStepsPerFrame));
+        runSteps(chunk);
+        steps -= chunk;
+    }
+    emit frameAdvanced();
+}
+
+void SimulationClock::reset()
+{
+    m_time = 0;
+    m_accumulator = 0;
+    m_stepCount = 0;
+    m_frameClock.restart();
+    emit frameAdvanced();
+}
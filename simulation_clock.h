@@ -0,0 +1,118 @@
+#ifndef SIMULATION_CLOCK_H
+#define SIMULATION_CLOCK_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QDateTime>
+
+// Единые часы модельного времени. Время идет фиксированными шагами (ticked),
+// независимо от частоты кадров: реальное время кадра умножается на ускорение
+// и копится, из накопленного выполняются целые шаги. После шагов кадра -
+// одно frameAdvanced для отображения. Все подсистемы (спутники, измерения,
+// небесная модель, карта) подписываются на эти сигналы вместо своих таймеров.
+//
+// Шаг выбирается как stepSeconds * 2^k - наименьший, при котором на кадр
+// приходится не больше kTargetStepsPerFrame шагов, поэтому большое ускорение
+// не превращается в лавину шагов. При одинаковых ускорении и шаге
+// последовательность шагов не зависит от частоты кадров и нагрузки
+class SimulationClock : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool running READ isRunning WRITE setRunning NOTIFY runningChanged)
+    Q_PROPERTY(double timeScale READ timeScale WRITE setTimeScale NOTIFY timeScaleChanged)
+    Q_PROPERTY(double stepSeconds READ stepSeconds WRITE setStepSeconds NOTIFY timeScaleChanged)
+    Q_PROPERTY(double effectiveStep READ effectiveStep NOTIFY timeScaleChanged)
+    Q_PROPERTY(LagPolicy lagPolicy READ lagPolicy WRITE setLagPolicy NOTIFY lagPolicyChanged)
+    Q_PROPERTY(double simulationTime READ simulationTime NOTIFY frameAdvanced)
+    Q_PROPERTY(double days READ days NOTIFY frameAdvanced)
+    Q_PROPERTY(double hour READ hour NOTIFY frameAdvanced)
+    Q_PROPERTY(int dayOffset READ dayOffset NOTIFY frameAdvanced)
+    Q_PROPERTY(QDateTime dateTime READ dateTime NOTIFY frameAdvanced)
+    Q_PROPERTY(double lag READ lag NOTIFY frameAdvanced)
+
+public:
+    // Что делать, если шаги кадра не укладываются в kMaxStepsPerFrame
+    enum LagPolicy {
+        CatchUp, // долг переносится на следующие кадры (не больше kMaxLagSeconds реального времени)
+        Skip     // долг отбрасывается, модельное время отстает от заданного ускорения
+    };
+    Q_ENUM(LagPolicy)
+
+    static const int kFrameIntervalMs;
+    static const int kTargetStepsPerFrame;
+    static const int kMaxStepsPerFrame;
+    static const double kMaxLagSeconds;
+
+    explicit SimulationClock(QObject *parent = nullptr);
+
+    bool isRunning() const { return m_timer.isActive(); }
+    void setRunning(bool running);
+
+    // Секунд модельного времени на секунду реального (x1 в интерфейсе = 60)
+    double timeScale() const { return m_timeScale; }
+    void setTimeScale(double scale);
+
+    // Базовый шаг в секундах модельного времени
+    double stepSeconds() const { return m_baseStep; }
+    void setStepSeconds(double seconds);
+    double effectiveStep() const { return m_step; }
+
+    LagPolicy lagPolicy() const { return m_lagPolicy; }
+    void setLagPolicy(LagPolicy policy);
+
+    // Начало отсчета (по умолчанию 1 января 2025, 6:00 - как в map.qml)
+    QDateTime startDateTime() const { return m_start; }
+    void setStartDateTime(const QDateTime &start) { m_start = start; }
+
+    // Секунды модельного времени от начала
+    double simulationTime() const { return m_time; }
+    double days() const;
+    double hour() const;
+    int dayOffset() const;
+    QDateTime dateTime() const;
+    // То же для произвольного момента модельного времени (события между шагами)
+    double daysAt(double time) const;
+    double hourAt(double time) const;
+    QDateTime dateTimeAt(double time) const;
+    qint64 stepCount() const { return m_stepCount; }
+
+    // Накопленный, но еще не выполненный интервал модельного времени
+    double lag() const { return m_accumulator; }
+
+    // Синхронно продвинуть время на seconds шагами текущего размера
+    // (симуляция без GUI, перемотка). Остаток меньше шага копится
+    Q_INVOKABLE void advance(double seconds);
+    Q_INVOKABLE void reset();
+
+signals:
+    void runningChanged();
+    void timeScaleChanged();
+    void lagPolicyChanged();
+
+    // Шаг модели: time - модельное время после шага, dt - длина шага
+    void ticked(double time, double dt);
+    // Все шаги кадра выполнены - можно публиковать состояние
+    void frameAdvanced();
+
+private slots:
+    void onFrame();
+
+private:
+    void updateStep();
+    void runSteps(int steps);
+
+    QTimer m_timer;
+    QElapsedTimer m_frameClock;
+    QDateTime m_start;
+    LagPolicy m_lagPolicy;
+
+    double m_timeScale;
+    double m_baseStep;
+    double m_step;
+    double m_time;
+    double m_accumulator;
+    qint64 m_stepCount;
+};
+
+#endif // SIMULATION_CLOCK_H
@@ -0,0 +1,258 @@
+#include "static_sensor_scheduler.h"
+#include "simulation_clock.h"
+#include "zone_index.h"
+#include "celestial_model.h"
+#include "measurement_synth.h"
+#include "zone_appearance.h"
+
+#include <QMetaMethod>
+#include <QDebug>
+
+const double StaticSensorScheduler::kPeriodSeconds = 5 * 60.0;
+const double StaticSensorScheduler::kAltitude = 35786; // Геостационарная орбита
+
+StaticSensorScheduler::StaticSensorScheduler(SimulationClock *clock, ZoneIndex *zones,
+                                             DataStorage *storage, QObject *parent)
+    : QObject(parent)
+    , m_clock(clock)
+    , m_zones(zones)
+    , m_storage(storage)
+    , m_celestialModel(nullptr)
+    , m_appearance(nullptr)
+    , m_random(QRandomGenerator::global()->generate())
+    , m_autoFlush(true)
+    , m_totalCount(0)
+    , m_head(0)
+{
+    connect(m_clock, &SimulationClock::ticked, this, &StaticSensorScheduler::onTick);
+    connect(m_clock, &SimulationClock::frameAdvanced, this, &StaticSensorScheduler::onFrame);
+    connect(m_zones, &ZoneIndex::zonesChanged, this, &StaticSensorScheduler::onZonesChanged);
+    connect(m_zones, &ZoneIndex::zonesUpdated, this, &StaticSensorScheduler::onZonesUpdated);
+}
+
+QColor StaticSensorScheduler::sensorColor(double baseNoiseLevel)
+{
+    if (baseNoiseLevel >= -60) return QColor(0xFF, 0x00, 0x00);  // Очень высокий
+    if (baseNoiseLevel >= -70) return QColor(0xFF, 0x44, 0x00);  // Высокий
+    if (baseNoiseLevel >= -80) return QColor(0xFF, 0x88, 0x00);  // Средний
+    return QColor(0xFF, 0xCC, 0x00);                             // Низкий
+}
+
+double StaticSensorScheduler::timeOfDayVariation(double hour)
+{
+    if (hour >= 7 && hour < 9) return 3;     // Утро - повышенный уровень
+    if (hour >= 17 && hour < 20) return 2;   // Вечер - повышенный уровень
+    if (hour >= 22 || hour < 5) return -4;   // Ночь - пониженный уровень
+    return 0;
+}
+
+double StaticSensorScheduler::latitude(int index) const
+{
+    return m_zones->zone(m_sensors[index].zone).latitude;
+}
+
+double StaticSensorScheduler::longitude(int index) const
+{
+    return m_zones->zone(m_sensors[index].zone).longitude;
+}
+
+QStringList StaticSensorScheduler::names() const
+{
+    QStringList result;
+    result.reserve(m_sensors.size());
+    for (const Sensor &sensor : m_sensors) {
+        result.append(sensor.name);
+    }
+    return result;
+}
+
+int StaticSensorScheduler::addSensor(int zone)
+{
+    int index = appendSensor(zone);
+    if (index >= 0) {
+        emit sensorsChanged();
+    }
+    return index;
+}
+
+int StaticSensorScheduler::appendSensor(int zone)
+{
+    if (zone < 0 || zone >= m_zones->count()) return -1;
+    if (m_byZone.size() < m_zones->count()) {
+        m_byZone.resize(m_zones->count());
+        std::fill(m_byZone.begin(), m_byZone.end(), -1);
+        for (int i = 0; i < m_sensors.size(); i++) {
+            m_byZone[m_sensors[i].zone] = i;
+        }
+    }
+    if (m_byZone[zone] >= 0) return -1;
+
+    const NoiseZone &noiseZone = m_zones->zone(zone);
+
+    Sensor sensor;
+    sensor.name = noiseZone.title.split(" - ").first().trimmed() + " Монитор";
+    sensor.zone = zone;
+    sensor.color = sensorColor(noiseZone.baseNoiseLevel);
+    sensor.nextDue = m_clock->simulationTime() + kPeriodSeconds;
+
+    const int index = m_sensors.size();
+    m_sensors.append(sensor);
+    m_byZone[zone] = index;
+
+    // Новый датчик срабатывает позже всех: место в кольце - перед началом
+    m_queue.insert(m_head, index);
+    m_head = (m_head + 1) % m_queue.size();
+
+    m_storage->addSatellite(sensor.name);
+    return index;
+}
+
+int StaticSensorScheduler::addAllSensors()
+{
+    int added = 0;
+    for (int zone = 0; zone < m_zones->count(); zone++) {
+        if (appendSensor(zone) >= 0) {
+            added++;
+        }
+    }
+
+    if (added > 0) {
+        qDebug() << "StaticSensorScheduler: добавлено датчиков над городами:" << added
+                 << "всего:" << m_sensors.size();
+        emit sensorsChanged();
+    }
+    return added;
+}
+
+void StaticSensorScheduler::clear()
+{
+    // Накопленное по удаляемым датчикам сохраняем
+    flush();
+    m_sensors.clear();
+    m_byZone.clear();
+    m_queue.clear();
+    m_head = 0;
+    m_notices.clear();
+    emit sensorsChanged();
+}
+
+void StaticSensorScheduler::onZonesChanged()
+{
+    // Номера зон датчиков больше не действительны
+    if (!m_sensors.isEmpty()) {
+        clear();
+    }
+}
+
+void StaticSensorScheduler::onZonesUpdated(const QVector<int> &indices)
+{
+    // Номера зон прежние: обновляется цвет значка, имя датчика остается,
+    // чтобы измерения в DataStorage продолжали тот же ряд
+    bool changed = false;
+    for (int zone : indices) {
+        if (zone < 0 || zone >= m_byZone.size() || m_byZone[zone] < 0) continue;
+        m_sensors[m_byZone[zone]].color = sensorColor(m_zones->zone(zone).baseNoiseLevel);
+        changed = true;
+    }
+
+    // Слой спутников перечитывает координаты и цвета
+    if (changed) {
+        emit sensorsChanged();
+    }
+}
+
+void StaticSensorScheduler::onTick(double time, double dt)
+{
+    Q_UNUSED(dt)
+
+    const int n = m_queue.size();
+    while (n > 0) {
+        const int index = m_queue[m_head];
+        Sensor &sensor = m_sensors[index];
+        if (sensor.nextDue > time) break;
+
+        measure(sensor, index, sensor.nextDue);
+        sensor.nextDue += kPeriodSeconds;
+        m_head = (m_head + 1) % n;
+    }
+}
+
+void StaticSensorScheduler::measure(Sensor &sensor, int index, double due)
+{
+    const NoiseZone &zone = m_zones->zone(sensor.zone);
+    const double hour = m_clock->hourAt(due);
+    const double celestial = m_celestialModel ? m_celestialModel->influenceAt(m_clock->daysAt(due)).total() : 1.0;
+    const double influence = celestial * MeasurementSynth::timeFactor(hour);
+
+    SatelliteMeasurementData data;
+    data.measurementTime = m_clock->dateTimeAt(due);
+    data.coordinate = qMakePair(zone.latitude, zone.longitude);
+    data.altitude = kAltitude;
+    data.cityName = zone.title;
+    data.distanceToCity = 0; // Спутник прямо над городом
+    data.influenceFactor = influence;
+
+    // Базовый уровень шума с вариациями ±2 дБм
+    double randomVariation = m_random.generateDouble() * 4 - 2;
+    double noiseLevel = zone.baseNoiseLevel + timeOfDayVariation(hour) + randomVariation;
+    data.radiationValue = noiseLevel * influence;
+    if (data.radiationValue > -50) {
+        data.radiationValue = -50 + m_random.generateDouble() * 5;
+    }
+
+    sensor.pending.append(data);
+    m_totalCount++;
+
+    if (m_appearance) {
+        m_appearance->setZoneNoise(sensor.zone, data.radiationValue);
+    }
+
+    static const QMetaMethod takenSignal = QMetaMethod::fromSignal(&StaticSensorScheduler::measurementsTaken);
+    if (m_notices.size() < MeasurementSynth::kMaxNoticesPerFrame && isSignalConnected(takenSignal)) {
+        Notice notice;
+        notice.sensor = index;
+        notice.time = data.measurementTime.toMSecsSinceEpoch();
+        notice.noiseLevel = data.radiationValue;
+        notice.influence = influence;
+        m_notices.append(notice);
+    }
+}
+
+void StaticSensorScheduler::flush()
+{
+    for (Sensor &sensor : m_sensors) {
+        if (sensor.pending.isEmpty()) continue;
+        m_storage->addMeasurementsBatch(sensor.name, sensor.pending);
+        sensor.pending.clear();
+    }
+}
+
+void StaticSensorScheduler::onFrame()
+{
+    if (m_autoFlush) {
+        flush();
+    }
+
+    if (!m_notices.isEmpty()) {
+        QVariantList batch;
+        batch.reserve(m_notices.size());
+        for (const Notice &notice : m_notices) {
+            const Sensor &sensor = m_sensors[notice.sensor];
+            const NoiseZone &zone = m_zones->zone(sensor.zone);
+            QVariantMap item;
+            item["index"] = notice.sensor;
+            item["satelliteName"] = sensor.name;
+            item["time"] = notice.time;
+            item["latitude"] = zone.latitude;
+            item["longitude"] = zone.longitude;
+            item["altitude"] = kAltitude;
+            item["noiseLevel"] = notice.noiseLevel;
+            item["cityName"] = zone.title;
+            item["distance"] = 0;
+            item["influence"] = notice.influence;
+            batch.append(item);
+        }
+        m_notices.clear();
+        emit measurementsTaken(batch);
+    }
+}
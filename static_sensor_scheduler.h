@@ -0,0 +1,123 @@
+#ifndef STATIC_SENSOR_SCHEDULER_H
+#define STATIC_SENSOR_SCHEDULER_H
+
+#include <QObject>
+#include <QVector>
+#include <QString>
+#include <QColor>
+#include <QRandomGenerator>
+#include <QVariantList>
+#include <QVariantMap>
+
+#include "data_storage.h"
+
+class SimulationClock;
+class ZoneIndex;
+class CelestialModel;
+class ZoneAppearance;
+
+// Неподвижные датчики над городами (прежний StaticSatellite.qml): один объект
+// на все датчики вместо таймера и объекта QML на каждый город. Датчик измеряет
+// раз в kPeriodSeconds модельного времени. Датчики стоят в очереди по времени
+// следующего измерения - у всех один период, поэтому сработавший датчик просто
+// уходит в конец кольца, и на шаге часов просматриваются только те, кому пора.
+//
+// Измерения копятся по датчикам и раз в кадр часов уходят в DataStorage пачками.
+// В QML за кадр отдается одна пачка для таблицы, уровень шума зоны уходит
+// в ZoneAppearance, который сам решает, поменялся ли вид зоны
+class StaticSensorScheduler : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY sensorsChanged)
+
+public:
+    // Период измерений: 5 секунд StaticSatellite.qml при ускорении x1
+    static const double kPeriodSeconds;
+    static const double kAltitude;
+
+    StaticSensorScheduler(SimulationClock *clock, ZoneIndex *zones, DataStorage *storage,
+                          QObject *parent = nullptr);
+
+    void setCelestialModel(CelestialModel *model) { m_celestialModel = model; }
+    // Цвет зоны по последнему измерению (без GUI не задается)
+    void setAppearance(ZoneAppearance *appearance) { m_appearance = appearance; }
+    void setSeed(quint32 seed) { m_random.seed(seed); }
+
+    // При выключенной автозаписи измерения копятся до flush() (симуляция без GUI)
+    void setAutoFlush(bool enabled) { m_autoFlush = enabled; }
+    void flush();
+
+    // Датчик над зоной ZoneIndex. Возвращает номер датчика или -1,
+    // если зоны нет или над ней уже есть датчик
+    Q_INVOKABLE int addSensor(int zone);
+    // Датчики над всеми зонами, возвращает число добавленных
+    Q_INVOKABLE int addAllSensors();
+    Q_INVOKABLE void clear();
+
+    int count() const { return m_sensors.size(); }
+    Q_INVOKABLE QString name(int index) const { return m_sensors[index].name; }
+    Q_INVOKABLE QStringList names() const;
+    int zone(int index) const { return m_sensors[index].zone; }
+    double latitude(int index) const;
+    double longitude(int index) const;
+    double altitude(int index) const { return kAltitude; }
+    const QColor &color(int index) const { return m_sensors[index].color; }
+
+    qint64 totalCount() const { return m_totalCount; }
+
+    // Цвет значка датчика по базовому уровню зоны (getSatelliteColorForNoiseLevel)
+    static QColor sensorColor(double baseNoiseLevel);
+    // Поправка на время суток (StaticSatellite.qml::calculateTimeOfDayVariation)
+    static double timeOfDayVariation(double hour);
+
+signals:
+    void sensorsChanged();
+    // Для таблицы, формат как у MeasurementSynth::measurementsTaken,
+    // index - номер датчика. Не больше MeasurementSynth::kMaxNoticesPerFrame за кадр
+    void measurementsTaken(const QVariantList &batch);
+
+private:
+    struct Sensor {
+        QString name;
+        int zone;
+        QColor color;
+        double nextDue;     // модельное время следующего измерения
+        QVector<SatelliteMeasurementData> pending;
+    };
+
+    // Измерение для уведомления QML
+    struct Notice {
+        int sensor;
+        qint64 time;
+        double noiseLevel;
+        double influence;
+    };
+
+    void onTick(double time, double dt);
+    void onFrame();
+    void onZonesChanged();
+    void onZonesUpdated(const QVector<int> &indices);
+    int appendSensor(int zone);
+    // Измерение на момент due, а не на время шага: за один шаг часов
+    // датчик может отработать несколько периодов
+    void measure(Sensor &sensor, int index, double due);
+
+    SimulationClock *m_clock;
+    ZoneIndex *m_zones;
+    DataStorage *m_storage;
+    CelestialModel *m_celestialModel;
+    ZoneAppearance *m_appearance;
+    QRandomGenerator m_random;
+    bool m_autoFlush;
+    qint64 m_totalCount;
+
+    QVector<Sensor> m_sensors;
+    QVector<int> m_byZone;   // номер датчика по индексу зоны, -1 - нет
+    // Кольцо номеров датчиков по возрастанию nextDue, начало - m_head
+    QVector<int> m_queue;
+    int m_head;
+
+    QVector<Notice> m_notices;
+};
+
+#endif // STATIC_SENSOR_SCHEDULER_H
@@ -0,0 +1,176 @@
+#include "tick_pool.h"
+
+#include <QDebug>
+
+class TickPool::Worker : public QThread
+{
+public:
+    Worker(TickPool *pool, int index) : m_pool(pool), m_index(index) {}
+
+protected:
+    void run() override { m_pool->workerLoop(m_index); }
+
+private:
+    TickPool *m_pool;
+    int m_index;
+};
+
+TickPool::TickPool(int threadCount)
+    : m_threadCount(threadCount > 0 ? threadCount : qMax(1, QThread::idealThreadCount()))
+    , m_slots(new Slot[m_threadCount])
+    , m_function(nullptr)
+    , m_count(0)
+    , m_blockSize(1)
+    , m_busy(0)
+    , m_generation(0)
+    , m_stopping(false)
+{
+    // Слот 0 - вызывающий поток, для остальных заводим потоки пула
+    for (int i = 1; i < m_threadCount; i++) {
+        Worker *worker = new Worker(this, i);
+        worker->start();
+        m_workers.append(worker);
+    }
+
+    qDebug() << "TickPool: потоков" << m_threadCount;
+}
+
+TickPool::~TickPool()
+{
+    {
+        QMutexLocker lock(&m_mutex);
+        m_stopping = true;
+        m_start.wakeAll();
+    }
+
+    for (Worker *worker : m_workers) {
+        worker->wait();
+        delete worker;
+    }
+    delete[] m_slots;
+}
+
+void TickPool::parallelFor(int count, int blockSize, const RangeFunction &fn)
+{
+    if (count <= 0) return;
+
+    blockSize = qMax(1, blockSize);
+    const int blocks = (count + blockSize - 1) / blockSize;
+
+    if (blocks == 1 || m_threadCount == 1) {
+        for (int begin = 0; begin < count; begin += blockSize) {
+            fn(begin, qMin(count, begin + blockSize));
+        }
+        return;
+    }
+
+    m_function = &fn;
+    m_count = count;
+    m_blockSize = blockSize;
+
+    // Начальное распределение - поровну непрерывными диапазонами
+    for (int i = 0; i < m_threadCount; i++) {
+        quint32 begin = quint32(qint64(blocks) * i / m_threadCount);
+        quint32 end = quint32(qint64(blocks) * (i + 1) / m_threadCount);
+        m_slots[i].range.store(pack(begin, end));
+    }
+
+    m_busy.store(m_threadCount - 1);
+    {
+        QMutexLocker lock(&m_mutex);
+        m_generation++;
+        m_start.wakeAll();
+    }
+
+    work(0);
+
+    // Блок считается выполненным, только когда поток вышел из задания
+    {
+        QMutexLocker lock(&m_mutex);
+        while (m_busy.load() > 0) {
+            m_done.wait(&m_mutex);
+        }
+    }
+    m_function = nullptr;
+}
+
+void TickPool::workerLoop(int self)
+{
+    quint64 seen = 0;
+
+    forever {
+        {
+            QMutexLocker lock(&m_mutex);
+            while (!m_stopping && m_generation == seen) {
+                m_start.wait(&m_mutex);
+            }
+            if (m_stopping) return;
+            seen = m_generation;
+        }
+
+        work(self);
+
+        if (m_busy.fetch_sub(1) == 1) {
+            QMutexLocker lock(&m_mutex);
+            m_done.wakeAll();
+        }
+    }
+}
+
+void TickPool::work(int self)
+{
+    // Блоки, которые другой поток уже забрал себе, он выполнит сам, поэтому
+    // когда взять больше нечего, поток просто выходит из задания
+    int block;
+    while (popLocal(self, &block) || steal(self, &block)) {
+        runBlock(block);
+    }
+}
+
+bool TickPool::popLocal(int self, int *block)
+{
+    std::atomic<quint64> &range = m_slots[self].range;
+    quint64 current = range.load();
+
+    forever {
+        quint32 begin = quint32(current >> 32);
+        quint32 end = quint32(current);
+        if (begin >= end) return false;
+
+        if (range.compare_exchange_weak(current, pack(begin + 1, end))) {
+            *block = int(begin);
+            return true;
+        }
+    }
+}
+
+bool TickPool::steal(int self, int *block)
+{
+    for (int k = 1; k < m_threadCount; k++) {
+        std::atomic<quint64> &range = m_slots[(self + k) % m_threadCount].range;
+        quint64 current = range.load();
+
+        forever {
+            quint32 begin = quint32(current >> 32);
+            quint32 end = quint32(current);
+            if (begin >= end) break;
+
+            // Хозяин оставляет себе первую половину, вор забирает вторую
+            quint32 middle = begin + (end - begin) / 2;
+            if (range.compare_exchange_weak(current, pack(begin, middle))) {
+                *block = int(middle);
+                if (middle + 1 < end) {
+                    m_slots[self].range.store(pack(middle + 1, end));
+                }
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void TickPool::runBlock(int block)
+{
+    int begin = block * m_blockSize;
+    (*m_function)(begin, qMin(m_count, begin + m_blockSize));
+}
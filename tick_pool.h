@@ -0,0 +1,73 @@
+#ifndef TICK_POOL_H
+#define TICK_POOL_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QVector>
+#include <atomic>
+#include <functional>
+
+// Пул потоков для шага симуляции с перехватом работы (work stealing).
+// parallelFor делит [0, count) на блоки, каждому потоку достается свой
+// непрерывный диапазон блоков. Поток берет блоки с начала своего диапазона,
+// а освободившийся поток забирает половину чужого остатка с конца - так
+// неравномерные блоки (измерения только у части спутников) не оставляют
+// ядра простаивать. Вызывающий поток работает наравне с остальными,
+// потоки пула между шагами спят.
+//
+// Результат не зависит от того, какой поток обработал блок, если функция
+// пишет только в данные своего блока
+class TickPool
+{
+public:
+    // fn(begin, end) - полуинтервал индексов одного блока
+    typedef std::function<void(int begin, int end)> RangeFunction;
+
+    // threadCount <= 0 - по числу ядер
+    explicit TickPool(int threadCount = 0);
+    ~TickPool();
+
+    int threadCount() const { return m_threadCount; }
+
+    // Выполнить fn по блокам blockSize и дождаться завершения всех блоков.
+    // Если блок один, он выполняется в вызывающем потоке без пробуждения пула
+    void parallelFor(int count, int blockSize, const RangeFunction &fn);
+
+private:
+    class Worker;
+
+    // Диапазон блоков потока: старшие 32 бита - начало, младшие - конец.
+    // Слоты разнесены по строкам кеша, чтобы потоки не мешали друг другу
+    struct Slot {
+        std::atomic<quint64> range;
+        char padding[64 - sizeof(std::atomic<quint64>)];
+        Slot() : range(0) {}
+    };
+
+    static quint64 pack(quint32 begin, quint32 end) { return (quint64(begin) << 32) | end; }
+
+    void workerLoop(int self);
+    void work(int self);
+    bool popLocal(int self, int *block);
+    bool steal(int self, int *block);
+    void runBlock(int block);
+
+    int m_threadCount;
+    Slot *m_slots;
+    QVector<Worker *> m_workers;
+
+    // Текущее задание
+    const RangeFunction *m_function;
+    int m_count;
+    int m_blockSize;
+    std::atomic<int> m_busy;  // потоков пула еще внутри задания
+
+    QMutex m_mutex;
+    QWaitCondition m_start;
+    QWaitCondition m_done;
+    quint64 m_generation;
+    bool m_stopping;
+};
+
+#endif // TICK_POOL_H
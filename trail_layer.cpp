@@ -0,0 +1,298 @@
+#include "trail_layer.h"
+#include "satellite_engine.h"
+
+#include <QSGGeometryNode>
+#include <QSGTransformNode>
+#include <QSGVertexColorMaterial>
+#include <QDebug>
+#include <QtMath>
+
+namespace {
+// Насколько далеко (в пикселях) вид может уйти от точки отсчета вершин,
+// прежде чем вершины будут пересчитаны относительно нового центра
+const double kRebasePixels = 4096.0;
+}
+
+TrailLayer::TrailLayer(QQuickItem *parent)
+    : MapOverlayItem(parent)
+    , m_maxPoints(500)
+    , m_lineWidth(2.0)
+    , m_color(Qt::black)
+    , m_satelliteColors(false)
+    , m_rebuild(true)
+    , m_origin(0.5, 0.5)
+{
+}
+
+QObject *TrailLayer::engine() const
+{
+    return m_engine.data();
+}
+
+void TrailLayer::setEngine(QObject *engine)
+{
+    SatelliteEngine *satelliteEngine = qobject_cast<SatelliteEngine *>(engine);
+    if (m_engine == satelliteEngine) return;
+
+    if (m_engine) {
+        disconnect(m_engine, nullptr, this, nullptr);
+    }
+
+    m_engine = satelliteEngine;
+    clear();
+
+    if (m_engine) {
+        connect(m_engine, &SatelliteEngine::trailPointsDue, this, &TrailLayer::onTrailPointsDue);
+        connect(m_engine, &SatelliteEngine::modelReset, this, &TrailLayer::clear);
+        connect(m_engine, &SatelliteEngine::rowsInserted, this, &TrailLayer::syncWithEngine);
+        syncWithEngine();
+    }
+
+    emit engineChanged();
+}
+
+void TrailLayer::setMaxPoints(int maxPoints)
+{
+    maxPoints = qMax(2, maxPoints);
+    if (m_maxPoints == maxPoints) return;
+
+    // Размер колец меняется - следы начинаются заново
+    m_maxPoints = maxPoints;
+    for (Trail &trail : m_trails) {
+        trail.points.fill(QPointF(), m_maxPoints);
+        trail.head = 0;
+        trail.count = 0;
+    }
+    m_dirtySlots.clear();
+    m_rebuild = true;
+    update();
+    emit maxPointsChanged();
+}
+
+void TrailLayer::setLineWidth(double width)
+{
+    if (qFuzzyCompare(m_lineWidth, width)) return;
+    m_lineWidth = width;
+    update();
+    emit lineWidthChanged();
+}
+
+void TrailLayer::setColor(const QColor &color)
+{
+    if (m_color == color) return;
+    m_color = color;
+    m_rebuild = true;
+    update();
+    emit colorChanged();
+}
+
+void TrailLayer::setSatelliteColors(bool enabled)
+{
+    if (m_satelliteColors == enabled) return;
+    m_satelliteColors = enabled;
+    m_rebuild = true;
+    update();
+    emit colorChanged();
+}
+
+void TrailLayer::ensureTrail(int trail)
+{
+    if (trail < m_trails.size()) return;
+
+    int oldSize = m_trails.size();
+    m_trails.resize(trail + 1);
+    for (int i = oldSize; i < m_trails.size(); i++) {
+        m_trails[i].points.fill(QPointF(), m_maxPoints);
+    }
+    // Изменилось число вершин - буфер геометрии выделяется заново
+    m_rebuild = true;
+}
+
+void TrailLayer::syncWithEngine()
+{
+    if (!m_engine) return;
+
+    for (int i = 0; i < m_engine->count(); i++) {
+        ensureTrail(i);
+        m_trails[i].color = m_engine->color(i);
+    }
+    update();
+}
+
+void TrailLayer::onTrailPointsDue(const QVector<int> &indices)
+{
+    for (int index : indices) {
+        addPoint(index, m_engine->latitude(index), m_engine->longitude(index));
+    }
+}
+
+void TrailLayer::addPoint(int trail, double lat, double lng)
+{
+    if (trail < 0) return;
+    ensureTrail(trail);
+
+    Trail &t = m_trails[trail];
+    int slot = t.head;
+    t.points[slot] = mercator(lat, lng);
+    t.head = (slot + 1) % m_maxPoints;
+
+    markSlotDirty(trail, slot);
+    if (t.count == m_maxPoints) {
+        // Самая старая точка затерта - отрезок, который из неё выходил, гасим
+        markSlotDirty(trail, t.head);
+    } else {
+        t.count++;
+    }
+    update();
+}
+
+void TrailLayer::setTrailColor(int trail, const QColor &color)
+{
+    if (trail < 0) return;
+    ensureTrail(trail);
+    m_trails[trail].color = color;
+    if (m_satelliteColors) {
+        m_rebuild = true;
+        update();
+    }
+}
+
+void TrailLayer::clearTrail(int trail)
+{
+    if (trail < 0 || trail >= m_trails.size()) return;
+
+    Trail &t = m_trails[trail];
+    for (int i = 0; i < t.count; i++) {
+        markSlotDirty(trail, (t.head - 1 - i + m_maxPoints) % m_maxPoints);
+    }
+    t.head = 0;
+    t.count = 0;
+    update();
+}
+
+void TrailLayer::clear()
+{
+    m_trails.clear();
+    m_dirtySlots.clear();
+    m_rebuild = true;
+    update();
+}
+
+void TrailLayer::markSlotDirty(int trail, int slot)
+{
+    if (!m_rebuild) {
+        m_dirtySlots.append(trail * m_maxPoints + slot);
+    }
+}
+
+void TrailLayer::onViewportChanged()
+{
+    // Вершины отсчитываются от m_origin. Пока вид рядом, сдвиг и масштаб - только
+    // матрица узла. Если вид ушел далеко, пересчитываем вершины от нового центра:
+    // так хватает точности float и шов на 180-м меридиане остается за экраном
+    double dx = wrapDelta(centerMercator().x() - m_origin.x());
+    double dy = centerMercator().y() - m_origin.y();
+    double pixels = qMax(qAbs(dx), qAbs(dy)) * worldSize();
+
+    if (pixels > kRebasePixels || qAbs(dx) > 0.25) {
+        m_origin = centerMercator();
+        m_dirtySlots.clear();
+        m_rebuild = true;
+    }
+    update();
+}
+
+void TrailLayer::writeSegment(QSGGeometry *geometry, int trail, int slot) const
+{
+    const Trail &t = m_trails[trail];
+    QSGGeometry::ColoredPoint2D *v = geometry->vertexDataAsColoredPoint2D() + 2 * (trail * m_maxPoints + slot);
+
+    // Ячейка - конец отрезка, начало - предыдущая точка кольца. У самой старой
+    // точки предыдущей нет, такой отрезок вырожденный и прозрачный
+    int age = (t.head - 1 - slot + m_maxPoints) % m_maxPoints;
+    if (age >= t.count - 1) {
+        v[0].set(0, 0, 0, 0, 0, 0);
+        v[1].set(0, 0, 0, 0, 0, 0);
+        return;
+    }
+
+    const QPointF &to = t.points[slot];
+    const QPointF &from = t.points[(slot - 1 + m_maxPoints) % m_maxPoints];
+
+    double x0 = wrapDelta(from.x() - m_origin.x());
+    double x1 = wrapDelta(to.x() - m_origin.x());
+
+    // Отрезок через шов напротив точки отсчета не рисуем
+    if (qAbs(x1 - x0) > 0.5) {
+        v[0].set(0, 0, 0, 0, 0, 0);
+        v[1].set(0, 0, 0, 0, 0, 0);
+        return;
+    }
+
+    // QSGVertexColorMaterial ждет цвет, умноженный на альфу
+    const QColor &color = m_satelliteColors ? t.color : m_color;
+    int a = color.alpha();
+    uchar r = uchar(color.red() * a / 255);
+    uchar g = uchar(color.green() * a / 255);
+    uchar b = uchar(color.blue() * a / 255);
+
+    v[0].set(float(x0), float(from.y() - m_origin.y()), r, g, b, uchar(a));
+    v[1].set(float(x1), float(to.y() - m_origin.y()), r, g, b, uchar(a));
+}
+
+QSGNode *TrailLayer::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data)
+{
+    Q_UNUSED(data)
+
+    QSGTransformNode *root = static_cast<QSGTransformNode *>(oldNode);
+    QSGGeometryNode *node = nullptr;
+
+    if (!root) {
+        root = new QSGTransformNode;
+
+        QSGGeometry *geometry = new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), 0);
+        geometry->setDrawingMode(QSGGeometry::DrawLines);
+        geometry->setVertexDataPattern(QSGGeometry::DynamicPattern);
+
+        node = new QSGGeometryNode;
+        node->setGeometry(geometry);
+        node->setFlag(QSGNode::OwnsGeometry);
+        node->setMaterial(new QSGVertexColorMaterial);
+        node->setFlag(QSGNode::OwnsMaterial);
+        root->appendChildNode(node);
+
+        m_rebuild = true;
+    } else {
+        node = static_cast<QSGGeometryNode *>(root->firstChild());
+    }
+
+    QSGGeometry *geometry = node->geometry();
+    geometry->setLineWidth(float(m_lineWidth));
+
+    const int vertexCount = m_trails.size() * m_maxPoints * 2;
+    if (geometry->vertexCount() != vertexCount) {
+        geometry->allocate(vertexCount);
+        m_rebuild = true;
+    }
+
+    if (m_rebuild) {
+        for (int trail = 0; trail < m_trails.size(); trail++) {
+            for (int slot = 0; slot < m_maxPoints; slot++) {
+                writeSegment(geometry, trail, slot);
+            }
+        }
+        m_rebuild = false;
+        m_dirtySlots.clear();
+        node->markDirty(QSGNode::DirtyGeometry);
+    } else if (!m_dirtySlots.isEmpty()) {
+        for (int pair : m_dirtySlots) {
+            writeSegment(geometry, pair / m_maxPoints, pair % m_maxPoints);
+        }
+        m_dirtySlots.clear();
+        node->markDirty(QSGNode::DirtyGeometry);
+    }
+
+    root->setMatrix(viewMatrix(m_origin));
+    root->markDirty(QSGNode::DirtyMatrix);
+    return root;
+}
@@ -0,0 +1,92 @@
+#ifndef TRAIL_LAYER_H
+#define TRAIL_LAYER_H
+
+#include "map_overlay_item.h"
+
+#include <QColor>
+#include <QVector>
+#include <QPointer>
+
+class SatelliteEngine;
+class QSGGeometry;
+
+// Следы всех спутников одним узлом геометрии. У каждого спутника кольцевой буфер
+// из maxPoints точек, каждой ячейке буфера соответствует отрезок из двух вершин
+// (предыдущая точка -> точка ячейки). Новая точка переписывает только свои отрезки,
+// а сдвиг и масштаб карты меняют лишь матрицу узла, вершины не трогаются
+class TrailLayer : public MapOverlayItem
+{
+    Q_OBJECT
+    Q_PROPERTY(QObject *engine READ engine WRITE setEngine NOTIFY engineChanged)
+    Q_PROPERTY(int maxPoints READ maxPoints WRITE setMaxPoints NOTIFY maxPointsChanged)
+    Q_PROPERTY(double lineWidth READ lineWidth WRITE setLineWidth NOTIFY lineWidthChanged)
+    Q_PROPERTY(QColor color READ color WRITE setColor NOTIFY colorChanged)
+    Q_PROPERTY(bool satelliteColors READ satelliteColors WRITE setSatelliteColors NOTIFY colorChanged)
+
+public:
+    explicit TrailLayer(QQuickItem *parent = nullptr);
+
+    // Источник точек: SatelliteEngine (trailPointsDue), номер следа = индекс спутника
+    QObject *engine() const;
+    void setEngine(QObject *engine);
+
+    int maxPoints() const { return m_maxPoints; }
+    void setMaxPoints(int maxPoints);
+
+    double lineWidth() const { return m_lineWidth; }
+    void setLineWidth(double width);
+
+    QColor color() const { return m_color; }
+    void setColor(const QColor &color);
+
+    // Раскрашивать следы цветом спутника вместо общего color
+    bool satelliteColors() const { return m_satelliteColors; }
+    void setSatelliteColors(bool enabled);
+
+    Q_INVOKABLE void addPoint(int trail, double lat, double lng);
+    Q_INVOKABLE void setTrailColor(int trail, const QColor &color);
+    Q_INVOKABLE void clearTrail(int trail);
+    Q_INVOKABLE void clear();
+
+signals:
+    void engineChanged();
+    void maxPointsChanged();
+    void lineWidthChanged();
+    void colorChanged();
+
+protected:
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+    void onViewportChanged() override;
+
+private:
+    struct Trail {
+        QVector<QPointF> points;  // нормированные координаты Меркатора
+        int head;                 // ячейка для следующей точки
+        int count;
+        QColor color;
+
+        Trail() : head(0), count(0), color(Qt::black) {}
+    };
+
+    void onTrailPointsDue(const QVector<int> &indices);
+    void syncWithEngine();
+    void ensureTrail(int trail);
+    void markSlotDirty(int trail, int slot);
+    void writeSegment(QSGGeometry *geometry, int trail, int slot) const;
+
+    QPointer<SatelliteEngine> m_engine;
+    QVector<Trail> m_trails;
+    int m_maxPoints;
+    double m_lineWidth;
+    QColor m_color;
+    bool m_satelliteColors;
+
+    // Изменения с прошлого кадра: номера вершинных пар (trail * maxPoints + slot)
+    QVector<int> m_dirtySlots;
+    bool m_rebuild;
+
+    // Точка отсчета вершин, переносится при уходе вида далеко от неё
+    QPointF m_origin;
+};
+
+#endif // TRAIL_LAYER_H
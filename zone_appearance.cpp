@@ -0,0 +1,167 @@
+#include "zone_appearance.h"
+#include "zone_index.h"
+#include "simulation_clock.h"
+
+#include <QVariantMap>
+#include <QDebug>
+#include <QtMath>
+
+namespace {
+struct NoiseBand {
+    double threshold;   // нижняя граница полосы, дБм
+    QRgb color;
+    const char *range;
+    const char *description;
+    double level;       // середина полосы для легенды
+};
+
+// Палитра легенды map.qml::noiseLevels и StaticSatellite.qml::updateCircleColor
+const NoiseBand kBands[] = {
+    { -60, 0xFFFF0000, "≥ -60 дБм", "Очень высокий", -55 },
+    { -65, 0xFFFF4400, "-60 до -70", "Высокий", -65 },
+    { -70, 0xFFFF8800, "-70 до -75", "Повышенный", -72.5 },
+    { -75, 0xFFFFCC00, "-75 до -80", "Средний", -77.5 },
+    { -80, 0xFFFFFF00, "-80 до -85", "Низкий", -82.5 },
+    { -85, 0xFFAAFF00, "-85 до -90", "Очень низкий", -87.5 },
+    { -90, 0xFF00FF00, "-90 до -95", "Минимальный", -92.5 },
+    { -1e9, 0xFF00AAFF, "< -95 дБм", "Фоновый", -100 }
+};
+}
+
+const double ZoneAppearance::kOpacityEpsilon = 0.02;
+const double ZoneAppearance::kBandHysteresis = 1.0;
+const int ZoneAppearance::kBandCount = int(sizeof(kBands) / sizeof(kBands[0]));
+
+ZoneAppearance::ZoneAppearance(ZoneIndex *zones, SimulationClock *clock, QObject *parent)
+    : QObject(parent)
+    , m_zones(zones)
+    , m_baseOpacity(0.6)
+{
+    // Подписка раньше слоев карты: к их перестроению состояние уже сброшено
+    connect(m_zones, &ZoneIndex::zonesChanged, this, &ZoneAppearance::onZonesChanged);
+    connect(clock, &SimulationClock::frameAdvanced, this, &ZoneAppearance::onFrame);
+    onZonesChanged();
+}
+
+int ZoneAppearance::bandFor(double noiseLevel)
+{
+    int band = 0;
+    while (band < kBandCount - 1 && noiseLevel <= kBands[band].threshold) {
+        band++;
+    }
+    return band;
+}
+
+QColor ZoneAppearance::bandColor(int band)
+{
+    return QColor::fromRgba(kBands[qBound(0, band, kBandCount - 1)].color);
+}
+
+double ZoneAppearance::opacityFor(double baseOpacity, int zone, int count)
+{
+    return qBound(0.1, baseOpacity * (1 - double(zone) / qMax(1, count) * 0.6), 0.8);
+}
+
+QVariantList ZoneAppearance::bands() const
+{
+    QVariantList result;
+    for (int i = 0; i < kBandCount; i++) {
+        QVariantMap band;
+        band["range"] = QString::fromUtf8(kBands[i].range);
+        band["color"] = bandColor(i).name();
+        band["description"] = QString::fromUtf8(kBands[i].description);
+        band["level"] = kBands[i].level;
+        result.append(band);
+    }
+    return result;
+}
+
+void ZoneAppearance::onZonesChanged()
+{
+    // Новый набор зон целиком перерисовывается слоем, уведомлять не нужно
+    const int count = m_zones->count();
+    m_states.resize(count);
+    for (int i = 0; i < count; i++) {
+        m_states[i].band = -1;
+        m_states[i].opacity = opacityFor(m_baseOpacity, i, count);
+        m_states[i].dirty = false;
+    }
+    m_dirty.clear();
+}
+
+void ZoneAppearance::setBaseOpacity(double opacity)
+{
+    opacity = qBound(0.0, opacity, 1.0);
+    if (qFuzzyCompare(m_baseOpacity, opacity)) return;
+    m_baseOpacity = opacity;
+
+    const int count = m_states.size();
+    for (int i = 0; i < count; i++) {
+        const double target = opacityFor(m_baseOpacity, i, count);
+        if (qAbs(target - m_states[i].opacity) > kOpacityEpsilon) {
+            m_states[i].opacity = target;
+            markDirty(i);
+        }
+    }
+    emit baseOpacityChanged();
+}
+
+void ZoneAppearance::setZoneNoise(int zone, double noiseLevel)
+{
+    if (zone < 0 || zone >= m_states.size()) return;
+
+    const int current = m_states[zone].band;
+    const int band = bandFor(noiseLevel);
+    if (current == band) return;
+
+    // Показания шумят на ±2 дБ при ширине полосы 5 дБ: у границы зона
+    // перескакивала бы каждый кадр. Полоса меняется, только когда уровень
+    // ушел за границу больше чем на kBandHysteresis
+    if (current >= 0) {
+        const double shift = band < current ? -kBandHysteresis : kBandHysteresis;
+        if (bandFor(noiseLevel + shift) == current) return;
+    }
+    m_states[zone].band = band;
+    markDirty(zone);
+}
+
+void ZoneAppearance::resetZoneNoise()
+{
+    for (int i = 0; i < m_states.size(); i++) {
+        if (m_states[i].band < 0) continue;
+        m_states[i].band = -1;
+        markDirty(i);
+    }
+}
+
+void ZoneAppearance::markDirty(int zone)
+{
+    if (m_states[zone].dirty) return;
+    m_states[zone].dirty = true;
+    m_dirty.append(zone);
+}
+
+QColor ZoneAppearance::color(int zone) const
+{
+    if (zone < 0 || zone >= m_states.size()) return QColor();
+    const int band = m_states[zone].band;
+    return band < 0 ? m_zones->zone(zone).color : bandColor(band);
+}
+
+double ZoneAppearance::opacity(int zone) const
+{
+    if (zone < 0 || zone >= m_states.size()) return 0;
+    return m_states[zone].opacity;
+}
+
+void ZoneAppearance::onFrame()
+{
+    if (m_dirty.isEmpty()) return;
+
+    for (int zone : m_dirty) {
+        m_states[zone].dirty = false;
+    }
+    const QVector<int> changed = m_dirty;
+    m_dirty.clear();
+    emit appearanceChanged(changed);
+}
@@ -0,0 +1,76 @@
+#ifndef ZONE_APPEARANCE_H
+#define ZONE_APPEARANCE_H
+
+#include <QObject>
+#include <QVector>
+#include <QColor>
+#include <QVariantList>
+
+class ZoneIndex;
+class SimulationClock;
+
+// Отображаемое состояние зон шума: цвет по последнему измерению датчика над
+// зоной и прозрачность по времени суток. Раньше map.qml::updateCirclesAppearance
+// и StaticSatellite.qml переписывали цвет, прозрачность и noiseLevel каждой зоны
+// при любом изменении времени или влияния. Здесь уровень шума квантуется в
+// полосы палитры (таблица легенды noiseLevels), прозрачность меняется, только
+// если отличается больше чем на kOpacityEpsilon, полоса - только если уровень
+// ушел за ее границу больше чем на kBandHysteresis. Изменившиеся зоны помечаются,
+// и раз в кадр часов слой получает одним сигналом только их
+class ZoneAppearance : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(double baseOpacity READ baseOpacity WRITE setBaseOpacity NOTIFY baseOpacityChanged)
+    Q_PROPERTY(QVariantList bands READ bands CONSTANT)
+
+public:
+    static const double kOpacityEpsilon;
+    static const double kBandHysteresis;   // дБ
+    static const int kBandCount;
+
+    ZoneAppearance(ZoneIndex *zones, SimulationClock *clock, QObject *parent = nullptr);
+
+    // Прозрачность зон: 0.6 днем, 0.3 ночью, внутренние (первые) зоны плотнее
+    double baseOpacity() const { return m_baseOpacity; }
+    void setBaseOpacity(double opacity);
+
+    // Последнее измерение над зоной. Зона помечается, только если сменилась полоса
+    // с учетом kBandHysteresis
+    void setZoneNoise(int zone, double noiseLevel);
+    // Вернуть всем зонам цвет из конфигурации
+    Q_INVOKABLE void resetZoneNoise();
+
+    // Отображаемый вид зоны (индекс как в ZoneIndex)
+    QColor color(int zone) const;
+    double opacity(int zone) const;
+
+    // Полосы палитры для легенды: [{ range, color, description, level }]
+    QVariantList bands() const;
+    // Полоса по уровню шума: 0 - самый высокий
+    static int bandFor(double noiseLevel);
+    static QColor bandColor(int band);
+    static double opacityFor(double baseOpacity, int zone, int count);
+
+signals:
+    void baseOpacityChanged();
+    // Изменился вид перечисленных зон, не чаще раза в кадр часов
+    void appearanceChanged(const QVector<int> &indices);
+
+private:
+    struct State {
+        int band;        // -1 - измерений не было
+        double opacity;  // отображаемая прозрачность
+        bool dirty;      // вид изменился, слой еще не уведомлен
+    };
+
+    void onZonesChanged();
+    void onFrame();
+    void markDirty(int zone);
+
+    ZoneIndex *m_zones;
+    double m_baseOpacity;
+    QVector<State> m_states;
+    QVector<int> m_dirty;
+};
+
+#endif // ZONE_APPEARANCE_H
@@ -0,0 +1,291 @@
+#include "zone_config.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QFileSystemWatcher>
+#include <QStandardPaths>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QSet>
+#include <QDebug>
+#include <cmath>
+
+namespace {
+const quint32 kCacheMagic = 0x525A4331;   // "RZC1"
+const quint32 kCacheFormat = 1;
+const int kReloadDelayMs = 200;
+}
+
+ZoneConfig::ZoneConfig(QObject *parent)
+    : QObject(parent)
+    , m_cachePath(defaultCachePath())
+    , m_totalCount(0)
+    , m_watcher(nullptr)
+{
+    m_reloadTimer.setSingleShot(true);
+    m_reloadTimer.setInterval(kReloadDelayMs);
+    connect(&m_reloadTimer, &QTimer::timeout, this, &ZoneConfig::load);
+}
+
+QString ZoneConfig::defaultSource()
+{
+    QString local = QDir(QCoreApplication::applicationDirPath()).filePath("radiation.json");
+    return QFileInfo::exists(local) ? local : QStringLiteral(":/radiation.json");
+}
+
+QString ZoneConfig::defaultCachePath()
+{
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    return dir.isEmpty() ? QString() : QDir(dir).filePath("radiation.cache");
+}
+
+void ZoneConfig::setSource(const QString &path)
+{
+    if (m_source == path) return;
+
+    if (m_watcher && !m_source.isEmpty()) {
+        m_watcher->removePath(m_source);
+    }
+    m_source = path;
+    if (m_watcher && !m_source.startsWith(":/")) {
+        m_watcher->addPath(m_source);
+    }
+    emit sourceChanged();
+}
+
+void ZoneConfig::setWatching(bool enabled)
+{
+    if (enabled == (m_watcher != nullptr)) return;
+
+    if (!enabled) {
+        delete m_watcher;
+        m_watcher = nullptr;
+        return;
+    }
+
+    m_watcher = new QFileSystemWatcher(this);
+    connect(m_watcher, &QFileSystemWatcher::fileChanged, this, &ZoneConfig::onFileChanged);
+    if (!m_source.isEmpty() && !m_source.startsWith(":/")) {
+        m_watcher->addPath(m_source);
+    }
+}
+
+void ZoneConfig::onFileChanged()
+{
+    // Сохранение через замену файла снимает его с отслеживания - возвращаем
+    if (m_watcher && !m_watcher->files().contains(m_source) && QFileInfo::exists(m_source)) {
+        m_watcher->addPath(m_source);
+    }
+    m_reloadTimer.start();
+}
+
+bool ZoneConfig::load()
+{
+    Parsed parsed;
+    if (readCache(&parsed)) {
+        qDebug() << "ZoneConfig: зоны из кеша" << m_cachePath;
+    } else if (parseFile(&parsed)) {
+        writeCache(parsed);
+    } else {
+        return false;
+    }
+
+    setErrorString(QString());
+    apply(parsed);
+    return true;
+}
+
+bool ZoneConfig::parseFile(Parsed *parsed)
+{
+    QFile file(m_source);
+    if (!file.open(QIODevice::ReadOnly)) {
+        setErrorString(QString("Не удалось открыть %1: %2").arg(m_source, file.errorString()));
+        qWarning() << "ZoneConfig:" << m_errorString;
+        return false;
+    }
+
+    QJsonParseError error;
+    QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError) {
+        setErrorString(QString("Ошибка парсинга %1: %2 (позиция %3)")
+                           .arg(m_source, error.errorString()).arg(error.offset));
+        qWarning() << "ZoneConfig:" << m_errorString;
+        return false;
+    }
+
+    const QJsonObject root = document.object();
+    if (!root.value("circles").isArray()) {
+        setErrorString(QString("Неверный формат %1: нет массива circles").arg(m_source));
+        qWarning() << "ZoneConfig:" << m_errorString;
+        return false;
+    }
+
+    const QJsonArray circles = root.value("circles").toArray();
+    parsed->version = root.value("version").toString("1.0");
+    parsed->totalCount = circles.size();
+    parsed->zones.clear();
+    parsed->zones.reserve(circles.size());
+
+    QSet<QString> ids;
+    for (int i = 0; i < circles.size(); i++) {
+        const QJsonObject circle = circles[i].toObject();
+        if (!circle.value("enabled").toBool()) continue;
+
+        NoiseZone zone;
+        zone.id = circle.value("id").toString();
+        zone.title = circle.value("title").toString(zone.id);
+        zone.latitude = circle.value("latitude").toDouble(NAN);
+        zone.longitude = circle.value("longitude").toDouble(NAN);
+        zone.radius = circle.value("radius").toDouble(1000);
+        zone.baseNoiseLevel = circle.value("baseNoiseLevel").toDouble(-100);
+        zone.color = QColor(circle.value("color").toString());
+
+        // Некорректная зона пропускается, остальные загружаются
+        QString problem;
+        if (zone.id.isEmpty()) {
+            problem = "нет id";
+        } else if (ids.contains(zone.id)) {
+            problem = "повторяющийся id";
+        } else if (!(zone.latitude >= -90 && zone.latitude <= 90)) {
+            problem = "широта вне [-90, 90]";
+        } else if (!(zone.longitude >= -180 && zone.longitude <= 180)) {
+            problem = "долгота вне [-180, 180]";
+        } else if (!(zone.radius > 0)) {
+            problem = "радиус должен быть больше нуля";
+        } else if (!std::isfinite(zone.baseNoiseLevel)) {
+            problem = "некорректный baseNoiseLevel";
+        }
+        if (!problem.isEmpty()) {
+            qWarning() << "ZoneConfig: зона" << i << zone.id << "пропущена:" << problem;
+            continue;
+        }
+
+        if (!zone.color.isValid()) {
+            qWarning() << "ZoneConfig: у зоны" << zone.id << "некорректный цвет, используется оранжевый";
+            zone.color = QColor(0xFF, 0x88, 0x00, 0x99);
+        }
+
+        ids.insert(zone.id);
+        parsed->zones.append(zone);
+    }
+
+    qDebug() << "ZoneConfig: из" << m_source << "загружено зон:" << parsed->zones.size()
+             << "из" << parsed->totalCount;
+    return true;
+}
+
+void ZoneConfig::writeZone(QDataStream &stream, const NoiseZone &zone)
+{
+    stream << zone.id << zone.title << zone.latitude << zone.longitude
+           << zone.radius << zone.baseNoiseLevel << zone.color;
+}
+
+void ZoneConfig::readZone(QDataStream &stream, NoiseZone *zone)
+{
+    stream >> zone->id >> zone->title >> zone->latitude >> zone->longitude
+           >> zone->radius >> zone->baseNoiseLevel >> zone->color;
+}
+
+bool ZoneConfig::readCache(Parsed *parsed) const
+{
+    if (m_cachePath.isEmpty()) return false;
+
+    QFile file(m_cachePath);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    // Кеш действителен только для того же файла того же размера и времени изменения
+    const QFileInfo info(m_source);
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_12);
+
+    quint32 magic = 0, format = 0;
+    QString source;
+    qint64 size = -1, modified = -1;
+    stream >> magic >> format >> source >> size >> modified;
+    if (magic != kCacheMagic || format != kCacheFormat || source != m_source
+        || size != info.size() || modified != info.lastModified().toMSecsSinceEpoch()) {
+        return false;
+    }
+
+    qint32 totalCount = 0, count = 0;
+    stream >> parsed->version >> totalCount >> count;
+    if (stream.status() != QDataStream::Ok || count < 0 || count > totalCount) return false;
+
+    parsed->totalCount = totalCount;
+    parsed->zones.resize(count);
+    for (int i = 0; i < count; i++) {
+        readZone(stream, &parsed->zones[i]);
+    }
+    return stream.status() == QDataStream::Ok;
+}
+
+void ZoneConfig::writeCache(const Parsed &parsed) const
+{
+    if (m_cachePath.isEmpty()) return;
+
+    QDir().mkpath(QFileInfo(m_cachePath).absolutePath());
+    QSaveFile file(m_cachePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "ZoneConfig: не удалось записать кеш" << m_cachePath << file.errorString();
+        return;
+    }
+
+    const QFileInfo info(m_source);
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_12);
+    stream << kCacheMagic << kCacheFormat << m_source << info.size()
+           << info.lastModified().toMSecsSinceEpoch();
+    stream << parsed.version << qint32(parsed.totalCount) << qint32(parsed.zones.size());
+    for (const NoiseZone &zone : parsed.zones) {
+        writeZone(stream, zone);
+    }
+
+    if (!file.commit()) {
+        qWarning() << "ZoneConfig: не удалось записать кеш" << m_cachePath << file.errorString();
+    }
+}
+
+void ZoneConfig::apply(const Parsed &parsed)
+{
+    // Тот же набор зон в том же порядке - обновляются только изменившиеся
+    bool sameLayout = parsed.zones.size() == m_zones.size() && !m_zones.isEmpty();
+    for (int i = 0; sameLayout && i < m_zones.size(); i++) {
+        sameLayout = parsed.zones[i].id == m_zones[i].id;
+    }
+
+    QVector<int> changed;
+    if (sameLayout) {
+        for (int i = 0; i < m_zones.size(); i++) {
+            if (parsed.zones[i] != m_zones[i]) {
+                changed.append(i);
+            }
+        }
+    }
+
+    const bool infoDiffers = parsed.version != m_version || parsed.totalCount != m_totalCount;
+    m_version = parsed.version;
+    m_totalCount = parsed.totalCount;
+    m_zones = parsed.zones;
+
+    if (!sameLayout) {
+        emit zonesReset();
+    } else if (!changed.isEmpty()) {
+        qDebug() << "ZoneConfig: изменилось зон:" << changed.size();
+        emit zonesUpdated(changed);
+    }
+    if (infoDiffers) {
+        emit infoChanged();
+    }
+}
+
+void ZoneConfig::setErrorString(const QString &error)
+{
+    if (m_errorString == error) return;
+    m_errorString = error;
+    emit errorStringChanged();
+}
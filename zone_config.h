@@ -0,0 +1,116 @@
+#ifndef ZONE_CONFIG_H
+#define ZONE_CONFIG_H
+
+#include <QObject>
+#include <QVector>
+#include <QString>
+#include <QColor>
+#include <QTimer>
+
+class QFileSystemWatcher;
+class QDataStream;
+
+// Зона радиошума из radiation.json
+struct NoiseZone {
+    QString id;
+    QString title;
+    double latitude;
+    double longitude;
+    double radius;          // метров
+    double baseNoiseLevel;  // дБм
+    QColor color;
+
+    NoiseZone() : latitude(0), longitude(0), radius(1000), baseNoiseLevel(-100) {}
+
+    bool sameGeometry(const NoiseZone &other) const
+    {
+        return latitude == other.latitude && longitude == other.longitude && radius == other.radius;
+    }
+    bool operator==(const NoiseZone &other) const
+    {
+        return id == other.id && title == other.title && sameGeometry(other)
+               && baseNoiseLevel == other.baseNoiseLevel && color == other.color;
+    }
+    bool operator!=(const NoiseZone &other) const { return !(*this == other); }
+};
+
+// Конфигурация зон шума. radiation.json разбирается один раз в C++ (раньше -
+// XMLHttpRequest и JSON.parse в QML), записи проверяются, в zones() попадают
+// только включенные и корректные зоны. Разобранный файл сохраняется в двоичный
+// кеш: пока размер и время изменения файла те же, при запуске читается кеш.
+//
+// С setWatching(true) файл на диске отслеживается. Если после правки набор
+// и порядок включенных зон прежний, сигнал zonesUpdated перечисляет только
+// изменившиеся зоны, иначе - zonesReset
+class ZoneConfig : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QString source READ source NOTIFY sourceChanged)
+    Q_PROPERTY(QString version READ version NOTIFY infoChanged)
+    Q_PROPERTY(int count READ count NOTIFY zonesReset)
+    Q_PROPERTY(int totalCount READ totalCount NOTIFY infoChanged)
+    Q_PROPERTY(QString errorString READ errorString NOTIFY errorStringChanged)
+
+public:
+    explicit ZoneConfig(QObject *parent = nullptr);
+
+    // radiation.json рядом с программой, если он есть, иначе из ресурсов
+    static QString defaultSource();
+    static QString defaultCachePath();
+
+    QString source() const { return m_source; }
+    void setSource(const QString &path);
+
+    // Пустой путь - без кеша
+    void setCachePath(const QString &path) { m_cachePath = path; }
+
+    // Перечитывать файл при изменении (файлы из ресурсов не отслеживаются)
+    void setWatching(bool enabled);
+
+    // Загрузка из кеша или файла. При ошибке прежние зоны остаются
+    Q_INVOKABLE bool load();
+
+    const QVector<NoiseZone> &zones() const { return m_zones; }
+    int count() const { return m_zones.size(); }
+    int totalCount() const { return m_totalCount; }  // записей в файле вместе с выключенными
+    QString version() const { return m_version; }
+    QString errorString() const { return m_errorString; }
+
+signals:
+    void sourceChanged();
+    void errorStringChanged();
+    void infoChanged();
+    // Зоны заменены целиком: поменялся состав или порядок
+    void zonesReset();
+    // Изменились только перечисленные зоны, индексы в zones()
+    void zonesUpdated(const QVector<int> &indices);
+
+private:
+    struct Parsed {
+        QString version;
+        int totalCount;
+        QVector<NoiseZone> zones;
+    };
+
+    bool parseFile(Parsed *parsed);
+    bool readCache(Parsed *parsed) const;
+    void writeCache(const Parsed &parsed) const;
+    void apply(const Parsed &parsed);
+    void setErrorString(const QString &error);
+    void onFileChanged();
+
+    static void writeZone(QDataStream &stream, const NoiseZone &zone);
+    static void readZone(QDataStream &stream, NoiseZone *zone);
+
+    QString m_source;
+    QString m_cachePath;
+    QString m_version;
+    int m_totalCount;
+    QVector<NoiseZone> m_zones;
+    QString m_errorString;
+
+    QFileSystemWatcher *m_watcher;
+    QTimer m_reloadTimer;   // редакторы пишут файл в несколько приемов
+};
+
+#endif // ZONE_CONFIG_H
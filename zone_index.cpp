@@ -0,0 +1,312 @@
+#include "zone_index.h"
+
+#include <QGeoCoordinate>
+#include <QDebug>
+#include <QtMath>
+#include <algorithm>
+#include <limits>
+
+const double ZoneIndex::kEarthRadius = 6371000.0;
+
+ZoneIndex::ZoneIndex(QObject *parent)
+    : QObject(parent)
+    , m_maxRadius(0)
+{
+}
+
+void ZoneIndex::setZones(const QVariantList &zones)
+{
+    QVector<NoiseZone> parsed;
+    parsed.reserve(zones.size());
+
+    for (const QVariant &value : zones) {
+        QVariantMap map = value.toMap();
+        NoiseZone zone;
+        zone.id = map.value("id").toString();
+        zone.title = map.value("title").toString();
+        zone.latitude = map.value("latitude").toDouble();
+        zone.longitude = map.value("longitude").toDouble();
+        zone.radius = map.value("radius", 1000).toDouble();
+        zone.baseNoiseLevel = map.value("baseNoiseLevel", -100).toDouble();
+        zone.color = QColor(map.value("color").toString());
+        parsed.append(zone);
+    }
+
+    setZones(parsed);
+}
+
+void ZoneIndex::setZones(const QVector<NoiseZone> &zones)
+{
+    m_zones = zones;
+    rebuildTree();
+
+    qDebug() << "ZoneIndex: построен индекс по" << m_zones.size() << "зонам";
+    emit zonesChanged();
+}
+
+void ZoneIndex::updateZones(const QVector<int> &indices, const QVector<NoiseZone> &zones)
+{
+    if (zones.size() != m_zones.size()) {
+        setZones(zones);
+        return;
+    }
+
+    // Дерево нужно перестроить, только если зона сдвинулась или поменяла радиус
+    bool moved = false;
+    for (int index : indices) {
+        if (index < 0 || index >= m_zones.size()) continue;
+        moved = moved || !m_zones[index].sameGeometry(zones[index]);
+        m_zones[index] = zones[index];
+    }
+    if (moved) {
+        rebuildTree();
+    }
+
+    emit zonesUpdated(indices);
+}
+
+void ZoneIndex::rebuildTree()
+{
+    m_nodes.resize(m_zones.size());
+    m_maxRadius = 0;
+
+    for (int i = 0; i < m_zones.size(); i++) {
+        double v[3];
+        toUnitVector(m_zones[i].latitude, m_zones[i].longitude, v);
+        m_nodes[i].x = v[0];
+        m_nodes[i].y = v[1];
+        m_nodes[i].z = v[2];
+        m_nodes[i].zone = i;
+        m_nodes[i].axis = 0;
+        m_maxRadius = qMax(m_maxRadius, m_zones[i].radius);
+    }
+
+    build(0, m_nodes.size(), 0);
+}
+
+void ZoneIndex::build(int begin, int end, int depth)
+{
+    if (end - begin <= 0) return;
+
+    int axis = depth % 3;
+    int mid = (begin + end) / 2;
+    std::nth_element(m_nodes.begin() + begin, m_nodes.begin() + mid, m_nodes.begin() + end,
+                     [axis](const Node &a, const Node &b) {
+                         const double ka = axis == 0 ? a.x : (axis == 1 ? a.y : a.z);
+                         const double kb = axis == 0 ? b.x : (axis == 1 ? b.y : b.z);
+                         return ka < kb;
+                     });
+    m_nodes[mid].axis = axis;
+
+    build(begin, mid, depth + 1);
+    build(mid + 1, end, depth + 1);
+}
+
+void ZoneIndex::searchNearest(int begin, int end, const double *p, int *best, double *bestChord) const
+{
+    if (end - begin <= 0) return;
+
+    int mid = (begin + end) / 2;
+    const Node &node = m_nodes[mid];
+
+    double dx = p[0] - node.x;
+    double dy = p[1] - node.y;
+    double dz = p[2] - node.z;
+    double d2 = dx * dx + dy * dy + dz * dz;
+    if (d2 < *bestChord) {
+        *bestChord = d2;
+        *best = node.zone;
+    }
+
+    double diff = node.axis == 0 ? dx : (node.axis == 1 ? dy : dz);
+    if (diff < 0) {
+        searchNearest(begin, mid, p, best, bestChord);
+        if (diff * diff < *bestChord) searchNearest(mid + 1, end, p, best, bestChord);
+    } else {
+        searchNearest(mid + 1, end, p, best, bestChord);
+        if (diff * diff < *bestChord) searchNearest(begin, mid, p, best, bestChord);
+    }
+}
+
+void ZoneIndex::searchWithin(int begin, int end, const double *p, double chordLimit,
+                             QVector<int> *result) const
+{
+    if (end - begin <= 0) return;
+
+    int mid = (begin + end) / 2;
+    const Node &node = m_nodes[mid];
+
+    double dx = p[0] - node.x;
+    double dy = p[1] - node.y;
+    double dz = p[2] - node.z;
+    if (dx * dx + dy * dy + dz * dz <= chordLimit * chordLimit) {
+        result->append(node.zone);
+    }
+
+    double diff = node.axis == 0 ? dx : (node.axis == 1 ? dy : dz);
+    if (diff <= chordLimit) searchWithin(begin, mid, p, chordLimit, result);
+    if (diff >= -chordLimit) searchWithin(mid + 1, end, p, chordLimit, result);
+}
+
+int ZoneIndex::nearest(double lat, double lng, double maxRadiusFactor, double *distance) const
+{
+    if (m_nodes.isEmpty()) return -1;
+
+    double p[3];
+    toUnitVector(lat, lng, p);
+
+    int best = -1;
+    double bestChord = std::numeric_limits<double>::max();
+    searchNearest(0, m_nodes.size(), p, &best, &bestChord);
+    if (best < 0) return -1;
+
+    const NoiseZone &zone = m_zones[best];
+    double d = distanceMeters(lat, lng, zone.latitude, zone.longitude);
+
+    // Слишком далеко от ближайшего города - открытая местность
+    if (maxRadiusFactor > 0 && d > zone.radius * maxRadiusFactor) {
+        return -1;
+    }
+
+    if (distance) *distance = d;
+    return best;
+}
+
+QVector<int> ZoneIndex::within(double lat, double lng, double radius, QVector<double> *distances) const
+{
+    QVector<int> result;
+    if (m_nodes.isEmpty()) return result;
+
+    double p[3];
+    toUnitVector(lat, lng, p);
+
+    // Грубый отбор по хорде с запасом на самый большой радиус, затем точная проверка
+    QVector<int> candidates;
+    searchWithin(0, m_nodes.size(), p, chordForDistance(radius + m_maxRadius), &candidates);
+
+    for (int index : candidates) {
+        const NoiseZone &zone = m_zones[index];
+        double d = distanceMeters(lat, lng, zone.latitude, zone.longitude);
+        if (d < zone.radius + radius) {
+            result.append(index);
+            if (distances) distances->append(d);
+        }
+    }
+    return result;
+}
+
+void ZoneIndex::nearestBatch(const double *lats, const double *lngs, int n, double maxRadiusFactor,
+                             int *indices, double *distances) const
+{
+    for (int i = 0; i < n; i++) {
+        double d = 0;
+        indices[i] = nearest(lats[i], lngs[i], maxRadiusFactor, &d);
+        if (distances) distances[i] = d;
+    }
+}
+
+QVariantMap ZoneIndex::zoneToMap(int index, double distance) const
+{
+    const NoiseZone &zone = m_zones[index];
+    QVariantMap result;
+    result["index"] = index;
+    result["id"] = zone.id;
+    result["title"] = zone.title;
+    result["baseNoiseLevel"] = zone.baseNoiseLevel;
+    result["radius"] = zone.radius;
+    result["distance"] = distance;
+    return result;
+}
+
+QVariantList ZoneIndex::zoneList() const
+{
+    QVariantList result;
+    result.reserve(m_zones.size());
+    for (int i = 0; i < m_zones.size(); i++) {
+        const NoiseZone &zone = m_zones[i];
+        QVariantMap map;
+        map["index"] = i;
+        map["id"] = zone.id;
+        map["title"] = zone.title;
+        map["latitude"] = zone.latitude;
+        map["longitude"] = zone.longitude;
+        map["radius"] = zone.radius;
+        map["baseNoiseLevel"] = zone.baseNoiseLevel;
+        map["color"] = zone.color.name(QColor::HexArgb);
+        result.append(map);
+    }
+    return result;
+}
+
+QVariant ZoneIndex::nearestZone(double lat, double lng, double maxRadiusFactor) const
+{
+    double distance = 0;
+    int index = nearest(lat, lng, maxRadiusFactor, &distance);
+    if (index < 0) return QVariant();
+    return zoneToMap(index, distance);
+}
+
+QVariantList ZoneIndex::zonesWithin(double lat, double lng, double radius) const
+{
+    QVector<double> distances;
+    QVector<int> indices = within(lat, lng, radius, &distances);
+
+    QVariantList result;
+    result.reserve(indices.size());
+    for (int i = 0; i < indices.size(); i++) {
+        QVariantMap item;
+        item["index"] = indices[i];
+        item["distance"] = distances[i];
+        result.append(item);
+    }
+    return result;
+}
+
+QVariantList ZoneIndex::nearestZones(const QVariantList &coordinates, double maxRadiusFactor) const
+{
+    const int n = coordinates.size();
+    QVector<double> lats(n), lngs(n), distances(n);
+    QVector<int> indices(n);
+
+    for (int i = 0; i < n; i++) {
+        QGeoCoordinate coordinate = coordinates[i].value<QGeoCoordinate>();
+        lats[i] = coordinate.latitude();
+        lngs[i] = coordinate.longitude();
+    }
+
+    nearestBatch(lats.constData(), lngs.constData(), n, maxRadiusFactor,
+                 indices.data(), distances.data());
+
+    QVariantList result;
+    result.reserve(n);
+    for (int i = 0; i < n; i++) {
+        result.append(indices[i] >= 0 ? QVariant(zoneToMap(indices[i], distances[i])) : QVariant());
+    }
+    return result;
+}
+
+double ZoneIndex::distanceMeters(double lat1, double lon1, double lat2, double lon2)
+{
+    double dLat = qDegreesToRadians(lat2 - lat1);
+    double dLon = qDegreesToRadians(lon2 - lon1);
+    double a = std::sin(dLat / 2) * std::sin(dLat / 2) +
+               std::cos(qDegreesToRadians(lat1)) * std::cos(qDegreesToRadians(lat2)) *
+               std::sin(dLon / 2) * std::sin(dLon / 2);
+    return kEarthRadius * 2 * std::atan2(std::sqrt(a), std::sqrt(1 - a));
+}
+
+void ZoneIndex::toUnitVector(double lat, double lng, double *v)
+{
+    double phi = qDegreesToRadians(lat);
+    double lambda = qDegreesToRadians(lng);
+    v[0] = std::cos(phi) * std::cos(lambda);
+    v[1] = std::cos(phi) * std::sin(lambda);
+    v[2] = std::sin(phi);
+}
+
+double ZoneIndex::chordForDistance(double meters)
+{
+    double angle = meters / kEarthRadius;
+    if (angle >= M_PI) return 2.0;
+    return 2.0 * std::sin(angle / 2);
+}
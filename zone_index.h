@@ -0,0 +1,87 @@
+#ifndef ZONE_INDEX_H
+#define ZONE_INDEX_H
+
+#include <QObject>
+#include <QVector>
+#include <QString>
+#include <QColor>
+#include <QVariant>
+#include <QVariantList>
+#include <QVariantMap>
+
+#include "zone_config.h"
+
+// Пространственный индекс зон шума: k-d дерево по единичным векторам на сфере.
+// Хордовое расстояние монотонно связано с расстоянием по дуге, поэтому поиск
+// ближайшей зоны и зон в радиусе не зависит от долготного шва и полюсов
+class ZoneIndex : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY zonesChanged)
+
+public:
+    static const double kEarthRadius; // метров
+
+    explicit ZoneIndex(QObject *parent = nullptr);
+
+    // Построение индекса. zones - массив объектов в формате radiation.json
+    // (latitude, longitude, radius, baseNoiseLevel, title, id, color)
+    Q_INVOKABLE void setZones(const QVariantList &zones);
+    void setZones(const QVector<NoiseZone> &zones);
+    // Замена отдельных зон при том же составе (горячая перезагрузка ZoneConfig):
+    // zones - новый полный список, indices - изменившиеся. Индексы зон
+    // сохраняются, поэтому вместо zonesChanged приходит zonesUpdated
+    void updateZones(const QVector<int> &indices, const QVector<NoiseZone> &zones);
+
+    int count() const { return m_zones.size(); }
+    const NoiseZone &zone(int index) const { return m_zones[index]; }
+    const QVector<NoiseZone> &zones() const { return m_zones; }
+
+    // Ближайшая зона, если точка не дальше maxRadiusFactor её радиусов от центра.
+    // Возвращает индекс зоны или -1, расстояние до центра пишется в distance
+    int nearest(double lat, double lng, double maxRadiusFactor, double *distance) const;
+
+    // Индексы зон, круг которых пересекается с кругом (lat, lng, radius)
+    QVector<int> within(double lat, double lng, double radius, QVector<double> *distances = nullptr) const;
+
+    // Пакетный поиск ближайших зон для n точек
+    void nearestBatch(const double *lats, const double *lngs, int n, double maxRadiusFactor,
+                      int *indices, double *distances) const;
+
+    // Для QML. Ближайшая зона: { index, id, title, baseNoiseLevel, radius, distance } или null
+    Q_INVOKABLE QVariant nearestZone(double lat, double lng, double maxRadiusFactor = 3.0) const;
+    // Все зоны по порядку: [{ index, id, title, latitude, longitude, radius, baseNoiseLevel, color }]
+    Q_INVOKABLE QVariantList zoneList() const;
+    // Зоны, пересекающиеся с кругом: [{ index, distance }]
+    Q_INVOKABLE QVariantList zonesWithin(double lat, double lng, double radius) const;
+    // Пакетный вариант nearestZone для массива координат (одним вызовом на тик)
+    Q_INVOKABLE QVariantList nearestZones(const QVariantList &coordinates, double maxRadiusFactor = 3.0) const;
+
+    static double distanceMeters(double lat1, double lon1, double lat2, double lon2);
+
+signals:
+    void zonesChanged();
+    void zonesUpdated(const QVector<int> &indices);
+
+private:
+    struct Node {
+        double x, y, z;
+        int zone;   // индекс в m_zones
+        int axis;
+    };
+
+    void rebuildTree();
+    void build(int begin, int end, int depth);
+    void searchNearest(int begin, int end, const double *p, int *best, double *bestChord) const;
+    void searchWithin(int begin, int end, const double *p, double chordLimit, QVector<int> *result) const;
+    QVariantMap zoneToMap(int index, double distance) const;
+
+    static void toUnitVector(double lat, double lng, double *v);
+    static double chordForDistance(double meters);
+
+    QVector<NoiseZone> m_zones;
+    QVector<Node> m_nodes;   // неявное дерево: медиана диапазона - корень поддерева
+    double m_maxRadius;
+};
+
+#endif // ZONE_INDEX_H